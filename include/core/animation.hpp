@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Animation
+{
+    template <typename T>
+    struct Keyframe
+    {
+        float time;
+        T value;
+    };
+
+    struct JointTrack
+    {
+        std::vector<Keyframe<Math::Vector3>> translation;
+        std::vector<Keyframe<Math::Quaternion>> rotation;
+        std::vector<Keyframe<Math::Vector3>> scale;
+    };
+
+    struct PoseStreams
+    {
+        std::vector<float> translationX, translationY, translationZ;
+        std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+        std::vector<float> scaleX, scaleY, scaleZ;
+
+        void resize(std::size_t n);
+    };
+
+    // keys are interleaved as {time, components...} inside one cache line; neighbouring
+    // blocks share their boundary key so every interval is read from a single line
+    struct alignas(64) KeyBlock
+    {
+        float data[16];
+    };
+
+    class SamplingCursor
+    {
+    public:
+        void reset() { blocks.clear(); }
+
+    private:
+        friend class AnimationClip;
+
+        std::vector<std::uint32_t> blocks;
+    };
+
+    class AnimationClip
+    {
+    public:
+        explicit AnimationClip(const std::vector<JointTrack>& jointTracks);
+
+        std::size_t jointCount() const { return joints; }
+        float duration() const { return length; }
+
+        void sample(float time, SamplingCursor& cursor, PoseStreams& pose) const;
+
+    private:
+        enum Channel { TRANSLATION, ROTATION, SCALE, CHANNEL_COUNT };
+
+        struct Track
+        {
+            std::uint32_t firstBlock;
+            std::uint32_t blockCount;
+        };
+
+        template <int Components, typename T, typename Unpack>
+        Track appendTrack(const std::vector<Keyframe<T>>& keys, const T& fallback, Unpack unpack);
+        std::uint32_t locate(const Track& track, std::uint32_t hint, float time) const;
+        template <int Components>
+        void gather(Channel channel, std::size_t joint, float time, std::uint32_t* hints, float (*from)[4], float (*to)[4], float* alpha) const;
+
+        std::vector<KeyBlock> blocks;
+        std::vector<float> blockStarts;
+        std::vector<Track> tracks;
+        std::size_t joints = 0;
+        std::size_t paddedJoints = 0;
+        float length = 0.0f;
+    };
+
+    struct SampleJob
+    {
+        const AnimationClip* clip;
+        float time;
+        SamplingCursor* cursor;
+        PoseStreams* pose;
+    };
+
+    void sampleBatch(const SampleJob* jobs, std::size_t count);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry.hpp"
+
+namespace Kronos::CoreSystems::Collision
+{
+    enum class SweepAxis
+    {
+        X,
+        Y,
+        Z,
+        Automatic
+    };
+
+    struct OverlapPair
+    {
+        std::uint32_t a;
+        std::uint32_t b;
+    };
+
+    class SweepAndPrune
+    {
+    public:
+        explicit SweepAndPrune(SweepAxis axis = SweepAxis::Automatic);
+
+        std::uint32_t add(const Geometry::AABB& bounds, std::uint32_t userData = 0);
+        void remove(std::uint32_t proxy);
+        void move(std::uint32_t proxy, const Geometry::AABB& bounds);
+
+        void update(std::vector<OverlapPair>& added, std::vector<OverlapPair>& removed);
+
+        const Geometry::AABB& bounds(const std::uint32_t proxy) const { return proxies[proxy].bounds; }
+        std::uint32_t userData(const std::uint32_t proxy) const { return proxies[proxy].userData; }
+        const std::vector<std::uint64_t>& pairs() const { return currentPairs; }
+        std::size_t proxyCount() const { return order.size(); }
+        int sweepAxis() const { return axis; }
+
+        static OverlapPair decodePair(const std::uint64_t key) { return {static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key)}; }
+
+    private:
+        struct Proxy
+        {
+            Geometry::AABB bounds;
+            std::uint32_t userData = 0;
+            bool alive = false;
+        };
+
+        struct Endpoint
+        {
+            float value;
+            std::uint32_t proxy;
+        };
+
+        int chooseAxis() const;
+        void sortEndpoints(bool full);
+        void gatherSorted();
+        void sweep();
+
+        SweepAxis mode;
+        int axis = 0;
+        bool orderDirty = false;
+        std::size_t addedSinceUpdate = 0;
+
+        std::vector<Proxy> proxies;
+        std::vector<std::uint32_t> freeList;
+        std::vector<std::uint32_t> pendingFree;
+
+        std::vector<Endpoint> order;
+        std::vector<float> minA, maxA, minB, maxB, minC, maxC;
+        std::vector<std::uint32_t> sortedProxy;
+
+        std::vector<std::uint64_t> currentPairs;
+        std::vector<std::uint64_t> previousPairs;
+        std::vector<std::vector<std::uint64_t>> chunkPairs;
+    };
+}
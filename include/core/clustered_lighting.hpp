@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry.hpp"
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Rendering
+{
+    // world space sphere enclosing everything a light can reach
+    struct LightBounds
+    {
+        Math::Vector3 centre;
+        float radius = 0.0f;
+    };
+
+    LightBounds boundPointLight(const Math::Vector3& position, float radius);
+    // tightest sphere around a cone of the given range and outer half angle in radians
+    LightBounds boundSpotLight(const Math::Vector3& position, const Math::Vector3& direction, float range, float outerAngle);
+
+    struct ClusterGridDesc
+    {
+        std::uint32_t tilesX = 16;
+        std::uint32_t tilesY = 9;
+        std::uint32_t slices = 24;
+        // view depth range of the slices; zero takes the planes from the projection, and projections with
+        // an infinite far plane need farZ
+        float nearZ = 0.0f;
+        float farZ = 0.0f;
+    };
+
+    struct ClusterLightRange
+    {
+        std::uint32_t offset;
+        std::uint32_t count;
+    };
+
+    // Froxel grid of a perspective projection: tiles split the screen with row 0 at the top, and slices
+    // split the view depth exponentially. Projection and view are column-vector, OpenGL style matrices
+    // with the camera looking down -z. Clusters are numbered (slice * tilesY + tileY) * tilesX + tileX.
+    class ClusteredLightGrid
+    {
+    public:
+        explicit ClusteredLightGrid(const Math::Matrix4x4& projection, const ClusterGridDesc& desc = {});
+
+        void setProjection(const Math::Matrix4x4& projection);
+
+        // bins the lights into every cluster their bounds touch; the lights of each cluster are listed in
+        // ascending index order
+        void assign(const LightBounds* lights, std::size_t n, const Math::Matrix4x4& view);
+
+        std::uint32_t tilesX() const { return desc.tilesX; }
+        std::uint32_t tilesY() const { return desc.tilesY; }
+        std::uint32_t slices() const { return desc.slices; }
+        std::size_t clusterCount() const { return ranges.size(); }
+        float nearZ() const { return nearPlane; }
+        float farZ() const { return farPlane; }
+
+        std::uint32_t clusterIndex(std::uint32_t tileX, std::uint32_t tileY, std::uint32_t slice) const { return (slice * desc.tilesY + tileY) * desc.tilesX + tileX; }
+        // slice holding a positive view depth, clamped to the grid
+        std::uint32_t sliceOf(float viewDepth) const;
+        // view space bounds of a cluster
+        Geometry::AABB clusterBounds(std::size_t cluster) const;
+
+        const ClusterLightRange& lightRange(const std::size_t cluster) const { return ranges[cluster]; }
+        const std::vector<ClusterLightRange>& lightRanges() const { return ranges; }
+        const std::vector<std::uint32_t>& lightIndices() const { return indices; }
+
+    private:
+        struct SliceBins
+        {
+            // light index per hit and cluster within the slice, then the hits grouped by cluster
+            std::vector<std::uint32_t> hitLights, hitClusters, sorted;
+            std::vector<std::uint32_t> clusterCounts;
+        };
+
+        void assignSlice(std::uint32_t slice);
+
+        ClusterGridDesc desc;
+        float nearPlane = 0.0f, farPlane = 0.0f;
+        // normalized device x = scaleX * x / depth - offsetX, and likewise for y
+        float scaleX = 1.0f, offsetX = 0.0f, scaleY = 1.0f, offsetY = 0.0f;
+        // view depth of the slice boundaries
+        std::vector<float> sliceDepth;
+        // per slice, view space x bounds of each column padded to whole SIMD groups and y bounds of each row
+        std::vector<float> columnMin, columnMax, rowMin, rowMax;
+        std::size_t paddedColumns = 0;
+
+        // view space light spheres, the slices they touch, and the lights touching each slice
+        std::vector<float> lightX, lightY, lightZ, lightRadius;
+        std::vector<std::uint32_t> firstSlice, lastSlice;
+        std::vector<std::uint32_t> sliceLightOffsets, sliceLights;
+        std::vector<SliceBins> bins;
+
+        std::vector<ClusterLightRange> ranges;
+        std::vector<std::uint32_t> indices;
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include "geometry.hpp"
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Compression
+{
+    // smallest-three: the largest component is dropped and rebuilt from the unit length,
+    // the other three are quantized over [-1/sqrt(2), 1/sqrt(2)]
+    struct PackedQuaternion48
+    {
+        std::uint16_t data[3];
+    };
+
+    struct PackedQuaternion32
+    {
+        std::uint32_t bits;
+    };
+
+    struct PackedVector3
+    {
+        std::uint16_t x, y, z;
+    };
+
+    struct ErrorStats
+    {
+        float maximum = 0.0f;
+        float mean = 0.0f;
+    };
+
+    PackedQuaternion48 packQuaternion48(const Math::Quaternion& q);
+    PackedQuaternion32 packQuaternion32(const Math::Quaternion& q);
+    Math::Quaternion unpackQuaternion(const PackedQuaternion48& p);
+    Math::Quaternion unpackQuaternion(const PackedQuaternion32& p);
+
+    PackedVector3 packVector3(const Math::Vector3& v, const Geometry::AABB& range);
+    Math::Vector3 unpackVector3(const PackedVector3& p, const Geometry::AABB& range);
+
+    void packQuaternions(const Math::Quaternion* q, std::size_t n, PackedQuaternion48* out);
+    void packQuaternions(const Math::Quaternion* q, std::size_t n, PackedQuaternion32* out);
+    void packVectors(const Math::Vector3* v, std::size_t n, const Geometry::AABB& range, PackedVector3* out);
+
+    void unpackQuaternions(const PackedQuaternion48* p, std::size_t n, float* x, float* y, float* z, float* w);
+    void unpackQuaternions(const PackedQuaternion32* p, std::size_t n, float* x, float* y, float* z, float* w);
+    void unpackVectors(const PackedVector3* p, std::size_t n, const Geometry::AABB& range, float* x, float* y, float* z);
+
+    // angular error in radians after a round trip through the packed format
+    ErrorStats measureError(const Math::Quaternion* q, std::size_t n, const PackedQuaternion48* packed);
+    ErrorStats measureError(const Math::Quaternion* q, std::size_t n, const PackedQuaternion32* packed);
+    // euclidean error after a round trip through the packed format
+    ErrorStats measureError(const Math::Vector3* v, std::size_t n, const PackedVector3* packed, const Geometry::AABB& range);
+
+    // worst-case error implied by the quantization step alone
+    float rotationErrorBound48();
+    float rotationErrorBound32();
+    Math::Vector3 vectorErrorBound(const Geometry::AABB& range);
+}
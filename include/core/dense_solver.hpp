@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace Kronos::CoreSystems::LinearAlgebra
+{
+    constexpr int MAX_FIXED_SIZE = 12;
+
+    template <int N>
+    struct VectorN
+    {
+        static_assert(N > 0 && N <= MAX_FIXED_SIZE, "fixed-size vectors are limited to MAX_FIXED_SIZE");
+
+        float v[N] = {};
+
+        float& operator[](const int i) { return v[i]; }
+        const float& operator[](const int i) const { return v[i]; }
+    };
+
+    template <int N>
+    struct MatrixN
+    {
+        static_assert(N > 0 && N <= MAX_FIXED_SIZE, "fixed-size matrices are limited to MAX_FIXED_SIZE");
+
+        float m[N][N] = {};
+
+        float& operator()(const int r, const int c) { return m[r][c]; }
+        const float& operator()(const int r, const int c) const { return m[r][c]; }
+
+        static MatrixN identity() { MatrixN r; for (int i = 0; i < N; ++i) { r.m[i][i] = 1.0f; } return r; }
+    };
+
+    class DenseMatrix
+    {
+    public:
+        DenseMatrix() = default;
+        explicit DenseMatrix(const int n) : size(n), values(static_cast<std::size_t>(n) * n, 0.0f) {}
+
+        int dimension() const { return size; }
+        float& operator()(const int r, const int c) { return values[static_cast<std::size_t>(r) * size + c]; }
+        const float& operator()(const int r, const int c) const { return values[static_cast<std::size_t>(r) * size + c]; }
+        float* data() { return values.data(); }
+        const float* data() const { return values.data(); }
+
+    private:
+        int size = 0;
+        std::vector<float> values;
+    };
+
+    enum class Factorization
+    {
+        LU,
+        Cholesky,
+        LDLT
+    };
+
+    // row-major kernels shared by the fixed and dynamic front ends; N is the compile-time size or 0
+    namespace Detail
+    {
+        template <int N>
+        bool luFactor(float* a, const int dynamic, int* pivots)
+        {
+            const int n = N ? N : dynamic;
+            for (int k = 0; k < n; ++k)
+            {
+                int p = k;
+                for (int i = k + 1; i < n; ++i) { if (std::fabs(a[i * n + k]) > std::fabs(a[p * n + k])) { p = i; } }
+                pivots[k] = p;
+                if (a[p * n + k] == 0.0f) { return false; }
+                if (p != k) { for (int j = 0; j < n; ++j) { std::swap(a[k * n + j], a[p * n + j]); } }
+
+                const float inv = 1.0f / a[k * n + k];
+                for (int i = k + 1; i < n; ++i)
+                {
+                    const float l = a[i * n + k] *= inv;
+                    for (int j = k + 1; j < n; ++j) { a[i * n + j] -= l * a[k * n + j]; }
+                }
+            }
+            return true;
+        }
+
+        template <int N>
+        void luSolve(const float* lu, const int dynamic, const int* pivots, float* b)
+        {
+            const int n = N ? N : dynamic;
+            for (int k = 0; k < n; ++k) { std::swap(b[k], b[pivots[k]]); }
+            for (int i = 1; i < n; ++i) { for (int j = 0; j < i; ++j) { b[i] -= lu[i * n + j] * b[j]; } }
+            for (int i = n - 1; i >= 0; --i)
+            {
+                for (int j = i + 1; j < n; ++j) { b[i] -= lu[i * n + j] * b[j]; }
+                b[i] /= lu[i * n + i];
+            }
+        }
+
+        template <int N>
+        bool choleskyFactor(float* a, const int dynamic)
+        {
+            const int n = N ? N : dynamic;
+            for (int j = 0; j < n; ++j)
+            {
+                float d = a[j * n + j];
+                for (int k = 0; k < j; ++k) { d -= a[j * n + k] * a[j * n + k]; }
+                if (!(d > 0.0f)) { return false; }
+                const float l = std::sqrt(d);
+                a[j * n + j] = l;
+
+                const float inv = 1.0f / l;
+                for (int i = j + 1; i < n; ++i)
+                {
+                    float s = a[i * n + j];
+                    for (int k = 0; k < j; ++k) { s -= a[i * n + k] * a[j * n + k]; }
+                    a[i * n + j] = s * inv;
+                }
+            }
+            return true;
+        }
+
+        template <int N>
+        void choleskySolve(const float* l, const int dynamic, float* b)
+        {
+            const int n = N ? N : dynamic;
+            for (int i = 0; i < n; ++i)
+            {
+                for (int j = 0; j < i; ++j) { b[i] -= l[i * n + j] * b[j]; }
+                b[i] /= l[i * n + i];
+            }
+            for (int i = n - 1; i >= 0; --i)
+            {
+                for (int j = i + 1; j < n; ++j) { b[i] -= l[j * n + i] * b[j]; }
+                b[i] /= l[i * n + i];
+            }
+        }
+
+        template <int N>
+        bool ldltFactor(float* a, const int dynamic)
+        {
+            const int n = N ? N : dynamic;
+            for (int j = 0; j < n; ++j)
+            {
+                float d = a[j * n + j];
+                for (int k = 0; k < j; ++k) { d -= a[j * n + k] * a[j * n + k] * a[k * n + k]; }
+                if (d == 0.0f || !std::isfinite(d)) { return false; }
+                a[j * n + j] = d;
+
+                const float inv = 1.0f / d;
+                for (int i = j + 1; i < n; ++i)
+                {
+                    float s = a[i * n + j];
+                    for (int k = 0; k < j; ++k) { s -= a[i * n + k] * a[j * n + k] * a[k * n + k]; }
+                    a[i * n + j] = s * inv;
+                }
+            }
+            return true;
+        }
+
+        template <int N>
+        void ldltSolve(const float* ld, const int dynamic, float* b)
+        {
+            const int n = N ? N : dynamic;
+            for (int i = 1; i < n; ++i) { for (int j = 0; j < i; ++j) { b[i] -= ld[i * n + j] * b[j]; } }
+            for (int i = 0; i < n; ++i) { b[i] /= ld[i * n + i]; }
+            for (int i = n - 2; i >= 0; --i) { for (int j = i + 1; j < n; ++j) { b[i] -= ld[j * n + i] * b[j]; } }
+        }
+
+        template <int N>
+        int gaussSeidel(const float* a, const int dynamic, const float* b, float* x, const int maxIterations, const float tolerance)
+        {
+            const int n = N ? N : dynamic;
+            for (int iteration = 1; iteration <= maxIterations; ++iteration)
+            {
+                float change = 0.0f;
+                for (int i = 0; i < n; ++i)
+                {
+                    float s = b[i];
+                    for (int j = 0; j < n; ++j) { if (j != i) { s -= a[i * n + j] * x[j]; } }
+                    const float next = s / a[i * n + i];
+                    change = std::fmax(change, std::fabs(next - x[i]));
+                    x[i] = next;
+                }
+                if (change <= tolerance) { return iteration; }
+            }
+            return maxIterations;
+        }
+    }
+
+    // factorizations work in place: LU keeps unit-lower L below the diagonal and U on and above it,
+    // Cholesky keeps L in the lower triangle, LDLT keeps unit-lower L below and D on the diagonal
+    template <int N>
+    bool luFactor(MatrixN<N>& a, int (&pivots)[N]) { return Detail::luFactor<N>(&a.m[0][0], N, pivots); }
+
+    template <int N>
+    void luSolve(const MatrixN<N>& lu, const int (&pivots)[N], VectorN<N>& b) { Detail::luSolve<N>(&lu.m[0][0], N, pivots, b.v); }
+
+    template <int N>
+    bool choleskyFactor(MatrixN<N>& a) { return Detail::choleskyFactor<N>(&a.m[0][0], N); }
+
+    template <int N>
+    void choleskySolve(const MatrixN<N>& l, VectorN<N>& b) { Detail::choleskySolve<N>(&l.m[0][0], N, b.v); }
+
+    template <int N>
+    bool ldltFactor(MatrixN<N>& a) { return Detail::ldltFactor<N>(&a.m[0][0], N); }
+
+    template <int N>
+    void ldltSolve(const MatrixN<N>& ld, VectorN<N>& b) { Detail::ldltSolve<N>(&ld.m[0][0], N, b.v); }
+
+    // returns the number of sweeps used; x holds the initial guess on entry
+    template <int N>
+    int gaussSeidel(const MatrixN<N>& a, const VectorN<N>& b, VectorN<N>& x, const int maxIterations, const float tolerance)
+    {
+        return Detail::gaussSeidel<N>(&a.m[0][0], N, b.v, x.v, maxIterations, tolerance);
+    }
+
+    template <int N>
+    bool solve(const Factorization kind, MatrixN<N> a, VectorN<N>& b)
+    {
+        int pivots[N];
+        switch (kind)
+        {
+            case Factorization::LU: if (!luFactor(a, pivots)) { return false; } luSolve(a, pivots, b); return true;
+            case Factorization::Cholesky: if (!choleskyFactor(a)) { return false; } choleskySolve(a, b); return true;
+            default: if (!ldltFactor(a)) { return false; } ldltSolve(a, b); return true;
+        }
+    }
+
+    bool luFactor(DenseMatrix& a, std::vector<int>& pivots);
+    void luSolve(const DenseMatrix& lu, const std::vector<int>& pivots, float* b);
+    bool choleskyFactor(DenseMatrix& a);
+    void choleskySolve(const DenseMatrix& l, float* b);
+    bool ldltFactor(DenseMatrix& a);
+    void ldltSolve(const DenseMatrix& ld, float* b);
+    int gaussSeidel(const DenseMatrix& a, const float* b, float* x, int maxIterations, float tolerance);
+    bool solve(Factorization kind, DenseMatrix a, float* b);
+
+    // solves count independent systems four at a time in SIMD lanes; solved may be null
+    template <int N>
+    void solveBatch(Factorization kind, const MatrixN<N>* a, const VectorN<N>* b, std::size_t count, VectorN<N>* x, bool* solved = nullptr);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "math.hpp"
+#include "radix_sort.hpp"
+
+namespace Kronos::CoreSystems::Rendering
+{
+    enum class DepthOrder
+    {
+        Ascending,
+        Descending
+    };
+
+    inline std::uint32_t floatToSortable(const float f)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return bits ^ ((bits >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+    }
+
+    inline float sortableToFloat(const std::uint32_t key)
+    {
+        const std::uint32_t bits = key ^ ((key >> 31) ? 0x80000000u : 0xFFFFFFFFu);
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    void computeDepthKeys(const Math::Matrix4x4& view, const Math::Vector3* centers, std::size_t n, DepthOrder order, std::uint32_t* keys);
+    void computeDepthKeys(const Math::Matrix4x4& view, const float* x, const float* y, const float* z, std::size_t n, DepthOrder order, std::uint32_t* keys);
+
+    class DepthSorter
+    {
+    public:
+        void sort(const Math::Matrix4x4& view, const Math::Vector3* centers, std::size_t n, DepthOrder order, std::uint32_t* drawIndices);
+        void sort(const Math::Matrix4x4& view, const float* x, const float* y, const float* z, std::size_t n, DepthOrder order, std::uint32_t* drawIndices);
+
+        const std::vector<std::uint32_t>& sortedKeys() const { return keys; }
+
+    private:
+        std::vector<std::uint32_t> keys;
+        Sorting::RadixSorter sorter;
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry.hpp"
+
+namespace Kronos::CoreSystems::Spatial
+{
+    class DynamicAABBTree
+    {
+    public:
+        static constexpr std::int32_t NULL_NODE = -1;
+
+        explicit DynamicAABBTree(float margin = 0.1f, float displacementMultiplier = 4.0f);
+
+        std::int32_t createProxy(const Geometry::AABB& bounds, std::uint32_t userData = 0);
+        void destroyProxy(std::int32_t proxy);
+        bool moveProxy(std::int32_t proxy, const Geometry::AABB& bounds, const Math::Vector3& displacement = Math::Vector3::ZERO);
+        // updates the fat bounds in place, shrinking them once they have grown loose; only a proxy leaving
+        // its parent is reinserted
+        void refitProxy(std::int32_t proxy, const Geometry::AABB& bounds);
+
+        template <typename Callback> void query(const Geometry::AABB& bounds, Callback&& callback) const;
+        template <typename Callback> void raycast(const Geometry::Ray& ray, Callback&& callback) const;
+
+        void queryBatch(const Geometry::AABB* bounds, std::size_t n, std::vector<std::uint32_t>& offsets, std::vector<std::int32_t>& proxies) const;
+        // closest hit per ray against the tight proxy bounds, NULL_NODE and infinity on a miss
+        void raycastBatch(const Geometry::Ray* rays, std::size_t n, std::int32_t* hitProxies, float* hitDistances) const;
+
+        // the bounds last given for the proxy and the enlarged ones stored in the tree
+        const Geometry::AABB& bounds(const std::int32_t proxy) const { return tightBounds[proxy]; }
+        const Geometry::AABB& fatBounds(const std::int32_t proxy) const { return nodes[proxy].bounds; }
+        std::uint32_t userData(const std::int32_t proxy) const { return nodes[proxy].userData; }
+        std::int32_t height() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+        std::size_t proxyCount() const { return leafCount; }
+        float areaRatio() const;
+
+    private:
+        struct Node
+        {
+            Geometry::AABB bounds;
+            std::uint32_t userData = 0;
+            std::int32_t parent = NULL_NODE;
+            std::int32_t child1 = NULL_NODE;
+            std::int32_t child2 = NULL_NODE;
+            std::int32_t height = -1;
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        // explicit traversal stack that only touches the heap for pathological trees
+        class Stack
+        {
+        public:
+            void push(const std::int32_t node) { if (size < CAPACITY) { local[size] = node; } else { spill.push_back(node); } ++size; }
+            std::int32_t pop() { --size; if (size < CAPACITY) { return local[size]; } const std::int32_t node = spill.back(); spill.pop_back(); return node; }
+            bool empty() const { return size == 0; }
+
+        private:
+            static constexpr int CAPACITY = 256;
+            std::int32_t local[CAPACITY];
+            std::vector<std::int32_t> spill;
+            int size = 0;
+        };
+
+        std::int32_t allocateNode();
+        void freeNode(std::int32_t node);
+        void insertLeaf(std::int32_t leaf);
+        void removeLeaf(std::int32_t leaf);
+        std::int32_t balance(std::int32_t node);
+
+        std::vector<Node> nodes;
+        // indexed like nodes, only meaningful for leaves
+        std::vector<Geometry::AABB> tightBounds;
+        std::int32_t root = NULL_NODE;
+        std::int32_t freeList = NULL_NODE;
+        std::size_t leafCount = 0;
+        float margin;
+        float displacementMultiplier;
+    };
+
+    template <typename Callback>
+    void DynamicAABBTree::query(const Geometry::AABB& bounds, Callback&& callback) const
+    {
+        if (root == NULL_NODE) { return; }
+
+        Stack stack;
+        stack.push(root);
+        while (!stack.empty())
+        {
+            const Node& node = nodes[stack.pop()];
+            if (!node.bounds.overlaps(bounds)) { continue; }
+            if (node.isLeaf())
+            {
+                if (!callback(static_cast<std::int32_t>(&node - nodes.data()))) { return; }
+            }
+            else
+            {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    template <typename Callback>
+    void DynamicAABBTree::raycast(const Geometry::Ray& ray, Callback&& callback) const
+    {
+        if (root == NULL_NODE) { return; }
+
+        const Math::Vector3 inverseDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+        float maxDistance = ray.maxDistance;
+
+        Stack stack;
+        stack.push(root);
+        while (!stack.empty())
+        {
+            const std::int32_t index = stack.pop();
+            const Node& node = nodes[index];
+            float t;
+            if (!Geometry::intersect(node.bounds, ray.origin, inverseDirection, maxDistance, t)) { continue; }
+            if (node.isLeaf())
+            {
+                // the callback returns the new clip distance, zero to stop or a negative value to ignore the proxy
+                const float result = callback(index, Geometry::Ray(ray.origin, ray.direction, maxDistance));
+                if (result == 0.0f) { return; }
+                if (result > 0.0f) { maxDistance = result; }
+            }
+            else
+            {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+}
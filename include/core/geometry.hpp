@@ -0,0 +1,51 @@
+#pragma once
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Geometry
+{
+    struct AABB
+    {
+        Math::Vector3 min, max;
+
+        AABB() {}
+        AABB(const Math::Vector3& min, const Math::Vector3& max) : min(min), max(max) {}
+        ~AABB() {}
+
+        Math::Vector3 center() const { return (min + max) * 0.5f; }
+        Math::Vector3 extent() const { return (max - min) * 0.5f; }
+        float surfaceArea() const { const Math::Vector3 d = max - min; return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x); }
+
+        bool overlaps(const AABB& b) const { return min.x <= b.max.x && max.x >= b.min.x && min.y <= b.max.y && max.y >= b.min.y && min.z <= b.max.z && max.z >= b.min.z; }
+        bool contains(const AABB& b) const { return min.x <= b.min.x && min.y <= b.min.y && min.z <= b.min.z && max.x >= b.max.x && max.y >= b.max.y && max.z >= b.max.z; }
+        bool contains(const Math::Vector3& p) const { return min.x <= p.x && min.y <= p.y && min.z <= p.z && max.x >= p.x && max.y >= p.y && max.z >= p.z; }
+
+        AABB expanded(const float margin) const { const Math::Vector3 m(margin, margin, margin); return {min - m, max + m}; }
+    };
+
+    struct Ray
+    {
+        Math::Vector3 origin;
+        Math::Vector3 direction;
+        float maxDistance = 1.0f;
+
+        Ray() {}
+        Ray(const Math::Vector3& origin, const Math::Vector3& direction, const float maxDistance = 1.0f) : origin(origin), direction(direction), maxDistance(maxDistance) {}
+        ~Ray() {}
+
+        Math::Vector3 at(const float t) const { return origin + direction * t; }
+    };
+
+    inline AABB merge(const AABB& a, const AABB& b) { return {Math::min(a.min, b.min), Math::max(a.max, b.max)}; }
+
+    inline bool intersect(const AABB& box, const Math::Vector3& origin, const Math::Vector3& inverseDirection, const float maxDistance, float& t)
+    {
+        const float tx0 = (box.min.x - origin.x) * inverseDirection.x, tx1 = (box.max.x - origin.x) * inverseDirection.x;
+        const float ty0 = (box.min.y - origin.y) * inverseDirection.y, ty1 = (box.max.y - origin.y) * inverseDirection.y;
+        const float tz0 = (box.min.z - origin.z) * inverseDirection.z, tz1 = (box.max.z - origin.z) * inverseDirection.z;
+        const float enter = std::fmax(std::fmax(std::fmin(tx0, tx1), std::fmin(ty0, ty1)), std::fmax(std::fmin(tz0, tz1), 0.0f));
+        const float leave = std::fmin(std::fmin(std::fmax(tx0, tx1), std::fmax(ty0, ty1)), std::fmin(std::fmax(tz0, tz1), maxDistance));
+        t = enter;
+        return enter <= leave;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Animation
+{
+    constexpr std::size_t MAX_IK_JOINTS = 32;
+
+    // swing-twist limit of a joint relative to its parent, measured from a reference (bind) local rotation;
+    // twist is about the bone towards the child joint and swing is the cone half angle, all in radians
+    struct JointLimit
+    {
+        Math::Quaternion reference {0.0f, 0.0f, 0.0f, 1.0f};
+        float maxSwing = M_PI;
+        float minTwist = -M_PI;
+        float maxTwist = M_PI;
+    };
+
+    // view over a chain, root first, whose last joint is the end effector; world space positions and
+    // rotations are updated in place and bone lengths are taken from the pose passed in
+    struct IkChain
+    {
+        Math::Vector3* positions = nullptr;
+        Math::Quaternion* rotations = nullptr;
+        std::size_t count = 0;
+        // optional, one per joint
+        const JointLimit* limits = nullptr;
+        // world rotation of the root's parent, used by the root's limit
+        Math::Quaternion parentRotation {0.0f, 0.0f, 0.0f, 1.0f};
+    };
+
+    struct IkParams
+    {
+        int maxIterations = 16;
+        float tolerance = 1e-3f;
+        // largest rotation a joint takes per CCD iteration; lower values spread the bend along the chain
+        float maxStepAngle = M_PI;
+    };
+
+    // The analytic solver takes exactly three joints and bends the middle one in its current plane, then
+    // turns that plane towards the pole position when one is given. Limbs that may start fully extended
+    // need a pole to pick the bend direction. Joint limits are only honoured by CCD and FABRIK, and the
+    // end effector's own limit is ignored. Chains longer than MAX_IK_JOINTS are left untouched.
+    // All solvers return the remaining distance from the end effector to the target.
+    float solveTwoBone(const IkChain& chain, const Math::Vector3& target, const Math::Vector3* pole = nullptr);
+    float solveCcd(const IkChain& chain, const Math::Vector3& target, const IkParams& params = {});
+    float solveFabrik(const IkChain& chain, const Math::Vector3& target, const IkParams& params = {});
+
+    enum class IkMethod
+    {
+        TwoBone,
+        Ccd,
+        Fabrik
+    };
+
+    struct IkJob
+    {
+        IkChain chain;
+        Math::Vector3 target;
+        Math::Vector3 pole;
+        bool usePole = false;
+        IkMethod method = IkMethod::TwoBone;
+    };
+
+    // jobs are split across workers without allocating; two-bone jobs are solved four per SIMD group
+    // and chains must not overlap. errors is optional and receives one distance per job.
+    void solveBatch(const IkJob* jobs, std::size_t n, const IkParams& params = {}, float* errors = nullptr);
+}
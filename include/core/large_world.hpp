@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Math
+{
+    struct DVector3
+    {
+        double x, y, z;
+
+        DVector3() : x(0), y(0), z(0) {}
+        DVector3(const double x, const double y, const double z) : x(x), y(y), z(z) {}
+        explicit DVector3(const Vector3& v) : x(v.x), y(v.y), z(v.z) {}
+        ~DVector3() {}
+
+        double operator[](const int i) { return (&x)[i]; }
+        const double& operator[](const int i) const { return (&x)[i]; }
+
+        double magnitude() const { return std::sqrt(x * x + y * y + z * z); }
+        double squaredMagnitude() const { return x * x + y * y + z * z; }
+
+        void normalize() { if (!isZero()) { const double m = magnitude(); x /= m; y /= m; z /= m; } }
+
+        bool isZero() const { return magnitude() == 0.0; }
+
+        double dot(const DVector3& v) const { return x * v.x + y * v.y + z * v.z; }
+        DVector3 cross(const DVector3& v) const { return { y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x }; }
+
+        Vector3 toVector3() const { return {static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)}; }
+
+        static const DVector3 ZERO;
+    };
+
+    inline DVector3 operator*(const DVector3& a, const DVector3& b) { return {a.x * b.x, a.y * b.y, a.z * b.z}; }
+    inline DVector3 operator*(const DVector3& a, const double s) { return {a.x * s, a.y * s, a.z * s}; }
+    inline DVector3 operator/(const DVector3& a, const double s) { if (s != 0.0) { const double rec = 1.0 / s; return {a.x * rec, a.y * rec, a.z * rec}; } return {a.x, a.y, a.z}; }
+    inline DVector3 operator+(const DVector3& a, const DVector3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    inline DVector3 operator-(const DVector3& a, const DVector3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    inline DVector3 operator*=(DVector3& a, const double s) { a.x *= s; a.y *= s; a.z *= s; return a; }
+    inline DVector3 operator+=(DVector3& a, const DVector3& b) { a.x += b.x; a.y += b.y; a.z += b.z; return a; }
+    inline DVector3 operator-=(DVector3& a, const DVector3& b) { a.x -= b.x; a.y -= b.y; a.z -= b.z; return a; }
+    inline DVector3 operator-(const DVector3& a) { return {-a.x, -a.y, -a.z}; }
+
+    struct DMatrix4x4
+    {
+        double m00, m01, m02, m03,
+               m10, m11, m12, m13,
+               m20, m21, m22, m23,
+               m30, m31, m32, m33;
+
+        DMatrix4x4() : m00(0), m01(0), m02(0), m03(0), m10(0), m11(0), m12(0), m13(0), m20(0), m21(0), m22(0), m23(0), m30(0), m31(0), m32(0), m33(0) {}
+        DMatrix4x4(const double m00, const double m01, const double m02, const double m03,
+                   const double m10, const double m11, const double m12, const double m13,
+                   const double m20, const double m21, const double m22, const double m23,
+                   const double m30, const double m31, const double m32, const double m33) :
+                   m00(m00), m01(m01), m02(m02), m03(m03),
+                   m10(m10), m11(m11), m12(m12), m13(m13),
+                   m20(m20), m21(m21), m22(m22), m23(m23),
+                   m30(m30), m31(m31), m32(m32), m33(m33) {}
+        explicit DMatrix4x4(const Matrix4x4& m) :
+                   m00(m.m00), m01(m.m01), m02(m.m02), m03(m.m03),
+                   m10(m.m10), m11(m.m11), m12(m.m12), m13(m.m13),
+                   m20(m.m20), m21(m.m21), m22(m.m22), m23(m.m23),
+                   m30(m.m30), m31(m.m31), m32(m.m32), m33(m.m33) {}
+        ~DMatrix4x4() {}
+
+        DVector3 translation() const { return {m03, m13, m23}; }
+        // affine transforms of column vectors, translation in m03, m13, m23
+        DVector3 transformPoint(const DVector3& p) const { return {m00 * p.x + m01 * p.y + m02 * p.z + m03, m10 * p.x + m11 * p.y + m12 * p.z + m13, m20 * p.x + m21 * p.y + m22 * p.z + m23}; }
+        DVector3 transformDirection(const DVector3& v) const { return {m00 * v.x + m01 * v.y + m02 * v.z, m10 * v.x + m11 * v.y + m12 * v.z, m20 * v.x + m21 * v.y + m22 * v.z}; }
+
+        Matrix4x4 toMatrix4x4() const;
+
+        static const DMatrix4x4 IDENTITY;
+        static const DMatrix4x4 ZERO;
+    };
+
+    DMatrix4x4 operator*(const DMatrix4x4& a, const DMatrix4x4& b);
+
+    // Large world pipeline: world positions and transforms are kept in double precision and converted to
+    // float relative to a camera-near origin before they reach float math, so magnitudes stay small.
+    Vector3 toCameraRelative(const DVector3& position, const DVector3& origin);
+    // the same transform with its translation taken relative to origin in double precision
+    Matrix4x4 toCameraRelative(const DMatrix4x4& transform, const DVector3& origin);
+    void toCameraRelative(const DVector3* positions, std::size_t n, const DVector3& origin, Vector3* out);
+    void toCameraRelative(const double* x, const double* y, const double* z, std::size_t n, const DVector3& origin, float* outX, float* outY, float* outZ);
+    void toCameraRelative(const DMatrix4x4* transforms, std::size_t n, const DVector3& origin, Matrix4x4* out);
+
+    // adds offset to float positions stored relative to an origin that moved by -offset
+    void rebase(Vector3* positions, std::size_t n, const Vector3& offset);
+    void rebase(float* x, float* y, float* z, std::size_t n, const Vector3& offset);
+    // shifts the translation of affine transforms
+    void rebase(Matrix4x4* transforms, std::size_t n, const Vector3& offset);
+
+    // Tracks the origin float positions are stored relative to. The origin snaps to multiples of gridSize
+    // (a power of two keeps every shift exact in float) and moves once the camera is more than
+    // threshold away from it.
+    class FloatingOrigin
+    {
+    public:
+        explicit FloatingOrigin(double threshold = 4096.0, double gridSize = 1024.0, const DVector3& origin = {});
+
+        const DVector3& origin() const { return current; }
+
+        // returns true and the offset to pass to rebase when the origin moved
+        bool update(const DVector3& camera, Vector3& offset);
+
+    private:
+        double threshold;
+        double gridSize;
+        DVector3 current;
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Rendering
+{
+    constexpr std::uint32_t MAX_LODS = 8;
+
+    struct LodThresholds
+    {
+        // smallest projected size (bounding sphere diameter over viewport height) each LOD is drawn at,
+        // finest LOD first and descending; objects smaller than the last threshold are culled
+        float screenSize[MAX_LODS] = {};
+        std::uint32_t lodCount = 1;
+        // relative band around each threshold that an object must cross before it switches LOD
+        float hysteresis = 0.1f;
+    };
+
+    // Selects a LOD per object from the projected size of its world space bounding sphere, as seen from
+    // the camera position with the projection's vertical scale. Each object's last LOD is kept between
+    // calls, so the object count and order must stay stable or resetHistory be called.
+    class LodSelector
+    {
+    public:
+        void resetHistory();
+
+        void select(const float* x, const float* y, const float* z, const float* radius, std::size_t n,
+                    const Math::Vector3& camera, const Math::Matrix4x4& projection, const LodThresholds& thresholds);
+
+        // per object LOD of the last selection; lodCount marks culled objects
+        const std::vector<std::int32_t>& lods() const { return objectLods; }
+
+        // objects of one LOD in ascending index order
+        std::size_t bucketSize(const std::uint32_t lod) const { return bucketOffsets[lod + 1] - bucketOffsets[lod]; }
+        const std::uint32_t* bucket(const std::uint32_t lod) const { return bucketIndices.data() + bucketOffsets[lod]; }
+
+    private:
+        std::vector<std::int32_t> objectLods;
+        // per chunk of objects, the count of each LOD and then where the chunk writes into each bucket
+        std::vector<std::uint32_t> chunkCounts;
+        std::vector<std::size_t> bucketOffsets = std::vector<std::size_t>(MAX_LODS + 2, 0);
+        std::vector<std::uint32_t> bucketIndices;
+    };
+}
@@ -118,6 +118,8 @@ namespace Kronos::CoreSystems::Math
     inline Vector3 operator+=(Vector3& a, const Vector3& b) { a.x += b.x; a.y += b.y; a.z += b.z; return a; }
     inline Vector3 operator-=(Vector3& a, const Vector3& b) { a.x -= b.x; a.y -= b.y; a.z -= b.z; return a; }
     inline Vector3 operator-(const Vector3& a) { return {-a.x, -a.y, -a.z}; }
+    inline Vector3 min(const Vector3& a, const Vector3& b) { return {std::fmin(a.x, b.x), std::fmin(a.y, b.y), std::fmin(a.z, b.z)}; }
+    inline Vector3 max(const Vector3& a, const Vector3& b) { return {std::fmax(a.x, b.x), std::fmax(a.y, b.y), std::fmax(a.z, b.z)}; }
 
     inline Vector4 operator*(const Vector4& a, const Vector4& b) { return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w}; }
     inline Vector4 operator*(const Vector4& a, const float s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
@@ -346,10 +348,31 @@ namespace Kronos::CoreSystems::Math
                                                           x = v.x; y = v.y; z = v.z; }
         explicit Quaternion(const Vector4& v) { x = v.x; y = v.y; z = v.z; w = v.w; }
 
+        float magnitude() const { return std::sqrt(x * x + y * y + z * z + w * w); }
+        float squaredMagnitude() const { return x * x + y * y + z * z + w * w; }
+
+        void normalize() { if (const float m = magnitude(); m != 0.0f) { const float rec = 1.0f / m; x *= rec; y *= rec; z *= rec; w *= rec; } }
+
+        float dot(const Quaternion& q) const { return x * q.x + y * q.y + z * q.z + w * q.w; }
+        Quaternion conjugate() const { return {-x, -y, -z, w}; }
+        Vector3 rotate(const Vector3& v) const { const Vector3 u(x, y, z); const Vector3 t = u.cross(v) * 2.0f; return v + t * w + u.cross(t); }
+
         static const Quaternion IDENTITY;
         static const Quaternion ZERO;
     };
 
+    inline Quaternion operator*(const Quaternion& a, const Quaternion& b) {
+        return { a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                    a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                    a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                    a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z }; }
+    inline Quaternion operator*(const Quaternion& a, const float s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
+    inline Quaternion operator+(const Quaternion& a, const Quaternion& b) { return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; }
+    inline Quaternion operator-(const Quaternion& a, const Quaternion& b) { return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; }
+    inline Quaternion operator*=(Quaternion& a, const Quaternion& b) { a = a * b; return a; }
+    inline Quaternion operator-(const Quaternion& a) { return {-a.x, -a.y, -a.z, -a.w}; }
+    inline Vector3 operator*(const Quaternion& a, const Vector3& b) { return a.rotate(b); }
+
     struct DualQuaternion
     {
         Quaternion real;
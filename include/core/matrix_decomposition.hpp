@@ -0,0 +1,28 @@
+#pragma once
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Math
+{
+    // A = vectors * diag(values) * vectors^T, values sorted descending, vectors a proper rotation
+    struct SymmetricEigen
+    {
+        Vector3 values;
+        Matrix3x3 vectors;
+    };
+
+    // A = u * diag(sigma) * v^T with u and v proper rotations; sigma is sorted by magnitude and only
+    // sigma.z can be negative, which happens when A is a reflection
+    struct SingularValueDecomposition
+    {
+        Matrix3x3 u;
+        Vector3 sigma;
+        Matrix3x3 v;
+    };
+
+    SymmetricEigen eigenSymmetric(const Matrix3x3& a);
+    SingularValueDecomposition svd(const Matrix3x3& a);
+
+    void eigenSymmetric(const Matrix3x3* matrices, std::size_t n, SymmetricEigen* out);
+    void svd(const Matrix3x3* matrices, std::size_t n, SingularValueDecomposition* out);
+}
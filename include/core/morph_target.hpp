@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Animation
+{
+    struct MorphTargetDesc
+    {
+        // vertices the target moves and their deltas; normalDeltas is either empty or matches indices
+        std::vector<std::uint32_t> indices;
+        std::vector<Math::Vector3> positionDeltas;
+        std::vector<Math::Vector3> normalDeltas;
+    };
+
+    enum class MorphDeltaFormat
+    {
+        Float32,
+        // per target and component symmetric range, 16 bits per delta component
+        Snorm16
+    };
+
+    struct VertexStreams
+    {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> normalX, normalY, normalZ;
+
+        void resize(std::size_t n);
+    };
+
+    // Deltas are stored per target as runs of whole SIMD groups of vertices: indices are rounded out to
+    // groups, neighbouring groups up to mergeGap groups apart are joined with zero deltas, and runs are
+    // split at chunk boundaries so chunks of the output can be accumulated on separate workers.
+    class MorphTargetSet
+    {
+    public:
+        MorphTargetSet(std::size_t vertexCount, const std::vector<MorphTargetDesc>& targets,
+                       MorphDeltaFormat format = MorphDeltaFormat::Float32, std::uint32_t mergeGap = 2);
+
+        std::size_t vertexCount() const { return vertices; }
+        // size the base and output streams must have
+        std::size_t paddedVertexCount() const { return paddedVertices; }
+        std::size_t targetCount() const { return targets.size(); }
+        std::size_t runCount() const { return runs.size(); }
+        std::size_t deltaBytes() const;
+
+        // out = base + sum of weights[t] * delta[t] over targets with |weight| > threshold. Normals are
+        // accumulated only when base has normal streams and are not renormalized; out may alias base.
+        void apply(const VertexStreams& base, const float* weights, VertexStreams& out, float threshold = 1e-4f) const;
+
+    private:
+        struct Run
+        {
+            std::uint32_t firstGroup;
+            std::uint32_t groupCount;
+            std::uint32_t positionOffset;
+            std::uint32_t normalOffset;
+        };
+
+        struct Target
+        {
+            Math::Vector3 positionScale;
+            Math::Vector3 normalScale;
+            bool hasNormals;
+        };
+
+        void appendTarget(const MorphTargetDesc& desc, std::uint32_t mergeGap);
+        template <typename Delta>
+        void accumulate(const Run& run, const Delta* positionDeltas, const Delta* normalDeltas, const Target& target, float weight, VertexStreams& out, bool normals) const;
+        void applyChunk(std::size_t chunk, const VertexStreams& base, const float* weights, VertexStreams& out, float threshold) const;
+
+        std::size_t vertices = 0;
+        std::size_t paddedVertices = 0;
+        std::size_t chunks = 0;
+        MorphDeltaFormat format;
+        std::vector<Target> targets;
+        std::vector<Run> runs;
+        // first run of each target in each chunk, chunks + 1 entries per target
+        std::vector<std::uint32_t> chunkRuns;
+        // one block of x, y and z lanes per vertex group, in either format
+        std::vector<float> positionDeltas, normalDeltas;
+        std::vector<std::int16_t> packedPositionDeltas, packedNormalDeltas;
+    };
+}
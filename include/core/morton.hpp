@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+#include "geometry.hpp"
+
+namespace Kronos::CoreSystems::Spatial
+{
+    inline std::uint32_t spreadBits3(std::uint32_t v)
+    {
+        v &= 0x3FF;
+        v = (v | v << 16) & 0x030000FF;
+        v = (v | v << 8) & 0x0300F00F;
+        v = (v | v << 4) & 0x030C30C3;
+        v = (v | v << 2) & 0x09249249;
+        return v;
+    }
+
+    inline std::uint32_t compactBits3(std::uint32_t v)
+    {
+        v &= 0x09249249;
+        v = (v | v >> 2) & 0x030C30C3;
+        v = (v | v >> 4) & 0x0300F00F;
+        v = (v | v >> 8) & 0x030000FF;
+        v = (v | v >> 16) & 0x3FF;
+        return v;
+    }
+
+    inline std::uint32_t morton30(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z) { return spreadBits3(x) | spreadBits3(y) << 1 | spreadBits3(z) << 2; }
+    std::uint64_t morton63(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+
+    std::uint32_t morton30(const Math::Vector3& p, const Geometry::AABB& bounds);
+    std::uint64_t morton63(const Math::Vector3& p, const Geometry::AABB& bounds);
+
+    void encodeMorton30(const Math::Vector3* points, std::size_t n, const Geometry::AABB& bounds, std::uint32_t* codes);
+    void encodeMorton63(const Math::Vector3* points, std::size_t n, const Geometry::AABB& bounds, std::uint64_t* codes);
+
+    Geometry::AABB computeBounds(const Math::Vector3* points, std::size_t n);
+    void sortByMorton(const Math::Vector3* points, std::size_t n, const Geometry::AABB& bounds, std::uint32_t* codes, std::uint32_t* permutation);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Collision
+{
+    enum class ShapeType : std::uint8_t
+    {
+        Sphere,
+        Box,
+        Capsule,
+        ConvexHull
+    };
+
+    struct ConvexShape
+    {
+        ShapeType type = ShapeType::Sphere;
+        Math::Vector3 position;
+        Math::Quaternion rotation {0.0f, 0.0f, 0.0f, 1.0f};
+        Math::Vector3 halfExtents;
+        float radius = 0.0f;
+        float halfHeight = 0.0f;
+        const Math::Vector3* vertices = nullptr;
+        std::uint32_t vertexCount = 0;
+
+        static ConvexShape sphere(const Math::Vector3& center, float radius);
+        static ConvexShape box(const Math::Vector3& center, const Math::Quaternion& rotation, const Math::Vector3& halfExtents);
+        static ConvexShape capsule(const Math::Vector3& center, const Math::Quaternion& rotation, float halfHeight, float radius);
+        static ConvexShape convexHull(const Math::Vector3& position, const Math::Quaternion& rotation, const Math::Vector3* vertices, std::uint32_t count);
+
+        Math::Vector3 coreSupport(const Math::Vector3& direction) const;
+        Math::Vector3 support(const Math::Vector3& direction) const;
+        float margin() const { return type == ShapeType::Sphere || type == ShapeType::Capsule ? radius : 0.0f; }
+    };
+
+    struct SimplexCache
+    {
+        Math::Vector3 directions[4];
+        std::uint8_t count = 0;
+    };
+
+    struct DistanceResult
+    {
+        float distance = 0.0f;
+        Math::Vector3 pointA;
+        Math::Vector3 pointB;
+        Math::Vector3 normal;
+        std::uint32_t iterations = 0;
+        bool intersecting = false;
+    };
+
+    struct ContactResult
+    {
+        float depth = 0.0f;
+        Math::Vector3 pointA;
+        Math::Vector3 pointB;
+        Math::Vector3 normal;
+        bool colliding = false;
+    };
+
+    DistanceResult distance(const ConvexShape& a, const ConvexShape& b, SimplexCache* cache = nullptr);
+    bool intersect(const ConvexShape& a, const ConvexShape& b, SimplexCache* cache = nullptr);
+    // shapes apart by no more than the contact tolerance still collide, with a slightly negative depth
+    ContactResult penetration(const ConvexShape& a, const ConvexShape& b, SimplexCache* cache = nullptr);
+
+    void distanceBatch(const ConvexShape* a, const ConvexShape* b, SimplexCache* caches, DistanceResult* results, std::size_t count);
+    void penetrationBatch(const ConvexShape* a, const ConvexShape* b, SimplexCache* caches, ContactResult* results, std::size_t count);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Noise
+{
+    enum class NoiseType
+    {
+        Perlin,
+        Simplex,
+        Worley
+    };
+
+    enum class FractalType
+    {
+        None,
+        Fbm,
+        Ridged
+    };
+
+    struct NoiseDesc
+    {
+        NoiseType type = NoiseType::Simplex;
+        FractalType fractal = FractalType::Fbm;
+        std::uint32_t octaves = 5;
+        float frequency = 1.0f;
+        float lacunarity = 2.0f;
+        // amplitude of each octave relative to the previous one
+        float gain = 0.5f;
+        std::int32_t seed = 0;
+    };
+
+    // Perlin and simplex noise lie roughly in [-1, 1]. Worley noise is the distance to the nearest feature point
+    // in cell units. Gradients are the analytic derivatives with respect to the input point. Fractals sum
+    // octaves normalized by the total amplitude; ridged octaves are (1 - |n|)^2. Vector is Vector2,
+    // Vector3 or Vector4.
+    template <typename Vector>
+    float perlin(const Vector& p, std::int32_t seed = 0);
+    template <typename Vector>
+    float perlin(const Vector& p, Vector& gradient, std::int32_t seed = 0);
+    template <typename Vector>
+    float simplex(const Vector& p, std::int32_t seed = 0);
+    template <typename Vector>
+    float simplex(const Vector& p, Vector& gradient, std::int32_t seed = 0);
+    template <typename Vector>
+    float worley(const Vector& p, std::int32_t seed = 0);
+    template <typename Vector>
+    float worley(const Vector& p, Vector& gradient, std::int32_t seed = 0);
+
+    template <typename Vector>
+    float sample(const NoiseDesc& desc, const Vector& p);
+    template <typename Vector>
+    float sample(const NoiseDesc& desc, const Vector& p, Vector& gradient);
+    // points are split across workers and evaluated four per SIMD group; gradients may be null
+    template <typename Vector>
+    void sample(const NoiseDesc& desc, const Vector* points, std::size_t n, float* out, Vector* gradients = nullptr);
+
+    // Evaluates a row-major grid of points origin + (x, y) * step, such as a heightmap tile, rows split
+    // across workers; gradients may be null.
+    void fill(const NoiseDesc& desc, const Math::Vector2& origin, const Math::Vector2& step, std::uint32_t width, std::uint32_t height,
+              float* out, Math::Vector2* gradients = nullptr);
+    // volume grid indexed (z * height + y) * width + x
+    void fill(const NoiseDesc& desc, const Math::Vector3& origin, const Math::Vector3& step, std::uint32_t width, std::uint32_t height,
+              std::uint32_t depth, float* out, Math::Vector3* gradients = nullptr);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry.hpp"
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Rendering
+{
+    // world space triangle list
+    struct OccluderMesh
+    {
+        const Math::Vector3* vertices = nullptr;
+        const std::uint32_t* indices = nullptr;
+        std::size_t triangleCount = 0;
+    };
+
+    // front faces are counter-clockwise in normalized device coordinates
+    enum class CullMode
+    {
+        None,
+        Back,
+        Front
+    };
+
+    // Masked occlusion culling after Andersson et al.: the screen is split into 32x4 pixel tiles of four
+    // 8x4 subtiles, each holding a 32-bit coverage mask and two conservative depth layers (1/w, so larger
+    // is nearer). Layer 0 is the farthest depth of the fully covered subtile; layer 1 collects triangles
+    // until their coverage is complete and is then merged into layer 0. Projection is column-vector
+    // (clip = viewProjection * position) with OpenGL style normalized device coordinates.
+    class MaskedOcclusionBuffer
+    {
+    public:
+        static constexpr int TILE_WIDTH = 32;
+        static constexpr int TILE_HEIGHT = 4;
+        static constexpr int SUBTILE_WIDTH = 8;
+
+        MaskedOcclusionBuffer(std::uint32_t width, std::uint32_t height);
+
+        std::uint32_t width() const { return screenWidth; }
+        std::uint32_t height() const { return screenHeight; }
+
+        void clear();
+
+        // occluders are binned to screen regions and rasterized in submission order within each region
+        void renderOccluders(const OccluderMesh* meshes, std::size_t n, const Math::Matrix4x4& viewProjection, CullMode cull = CullMode::Back);
+
+        // boxes crossing the near plane are always visible and boxes off screen never are
+        bool isVisible(const Geometry::AABB& box, const Math::Matrix4x4& viewProjection) const;
+        void testBoxes(const Geometry::AABB* boxes, std::size_t n, const Math::Matrix4x4& viewProjection, std::uint8_t* visible) const;
+
+        // per-pixel conservative depth, row-major, for debugging and tooling
+        void resolveDepth(float* out) const;
+
+    private:
+        struct alignas(16) Tile
+        {
+            std::uint32_t mask[4];
+            float zMin[2][4];
+        };
+
+        struct TriangleSetup
+        {
+            // edge functions a x + b y + c, non-negative inside, at pixel centres
+            float edgeA[3], edgeB[3], edgeC[3];
+            // 1/w = zx x + zy y + z0
+            float zx, zy, z0;
+            float zFar, zNear;
+            std::int32_t tileMinX, tileMinY, tileMaxX, tileMaxY;
+        };
+
+        void setupTriangle(const float (&clip)[3][4], CullMode cull, std::size_t batch);
+        void rasterize(const TriangleSetup& triangle, std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY);
+        bool testRect(float minX, float minY, float maxX, float maxY, float zNear) const;
+
+        std::uint32_t screenWidth, screenHeight;
+        std::int32_t tilesX, tilesY;
+        std::vector<Tile> tiles;
+        // per batch of occluder triangles: setups and, for every bin, the setups overlapping it
+        std::vector<std::vector<TriangleSetup>> batchTriangles;
+        std::vector<std::vector<std::uint32_t>> batchBins;
+    };
+}
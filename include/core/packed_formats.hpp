@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Compression
+{
+    struct Half3
+    {
+        std::uint16_t x, y, z;
+    };
+
+    struct Half4
+    {
+        std::uint16_t x, y, z, w;
+    };
+
+    // unit normal folded onto the octahedron and stored as two snorm16 values
+    struct OctahedralNormal
+    {
+        std::int16_t x, y;
+    };
+
+    // snorm10 x, y, z and snorm2 w, laid out like A2B10G10R10_SNORM
+    struct PackedNormal1010102
+    {
+        std::uint32_t bits;
+    };
+
+    std::uint16_t floatToHalf(float f);
+    float halfToFloat(std::uint16_t h);
+
+    Half3 toHalf3(const Math::Vector3& v);
+    Half4 toHalf4(const Math::Vector4& v);
+    Math::Vector3 toVector3(const Half3& h);
+    Math::Vector4 toVector4(const Half4& h);
+
+    OctahedralNormal encodeOctahedral(const Math::Vector3& n);
+    Math::Vector3 decodeOctahedral(const OctahedralNormal& p);
+
+    PackedNormal1010102 encode1010102(const Math::Vector3& n, float w = 1.0f);
+    Math::Vector4 decode1010102(const PackedNormal1010102& p);
+
+    void encodeHalves(const float* in, std::size_t n, std::uint16_t* out);
+    void decodeHalves(const std::uint16_t* in, std::size_t n, float* out);
+    void encodeHalf3(const Math::Vector3* in, std::size_t n, Half3* out);
+    void decodeHalf3(const Half3* in, std::size_t n, Math::Vector3* out);
+    void encodeHalf4(const Math::Vector4* in, std::size_t n, Half4* out);
+    void decodeHalf4(const Half4* in, std::size_t n, Math::Vector4* out);
+
+    void encodeOctahedral(const float* x, const float* y, const float* z, std::size_t n, OctahedralNormal* out);
+    void decodeOctahedral(const OctahedralNormal* in, std::size_t n, float* x, float* y, float* z);
+
+    // w may be null, in which case every packed w is +1
+    void encode1010102(const float* x, const float* y, const float* z, const float* w, std::size_t n, PackedNormal1010102* out);
+    void decode1010102(const PackedNormal1010102* in, std::size_t n, float* x, float* y, float* z, float* w);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Kronos::CoreSystems::Parallel
+{
+    using RangeFunction = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    unsigned workerCount();
+    void dispatch(std::size_t count, std::size_t grain, RangeFunction function, void* context);
+
+    template <typename Function>
+    void parallelFor(const std::size_t count, const std::size_t grain, Function&& function)
+    {
+        using Callable = std::remove_reference_t<Function>;
+        dispatch(count, grain, [](void* context, const std::size_t begin, const std::size_t end) { (*static_cast<Callable*>(context))(begin, end); }, const_cast<void*>(static_cast<const void*>(&function)));
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Particles
+{
+    struct ParticleStreams
+    {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> velocityX, velocityY, velocityZ;
+        std::vector<float> colorR, colorG, colorB, colorA;
+        std::vector<float> age, lifetime;
+
+        void resize(std::size_t n);
+    };
+
+    struct EmissionParams
+    {
+        Math::Vector3 origin;
+        Math::Vector3 extent;
+        Math::Vector3 velocity;
+        float velocitySpread = 0.0f;
+        Math::Vector4 color {1.0f, 1.0f, 1.0f, 1.0f};
+        float lifetime = 1.0f;
+    };
+
+    struct Attractor
+    {
+        Math::Vector3 position;
+        float strength = 0.0f;
+    };
+
+    struct ForceField
+    {
+        Math::Vector3 gravity {0.0f, -9.81f, 0.0f};
+        float drag = 0.0f;
+        float softening = 0.01f;
+        std::vector<Attractor> attractors;
+    };
+
+    class ParticleEmitter
+    {
+    public:
+        explicit ParticleEmitter(std::size_t capacity, std::uint32_t seed = 1);
+
+        std::size_t emit(std::size_t n, const EmissionParams& params);
+        void simulate(float dt, const ForceField& forces);
+        std::size_t compact();
+        void update(const float dt, const ForceField& forces) { simulate(dt, forces); compact(); }
+        void clear() { count = 0; }
+
+        std::size_t size() const { return count; }
+        std::size_t capacity() const { return maxCount; }
+        const ParticleStreams& streams() const { return particles; }
+
+    private:
+        float nextSigned();
+
+        ParticleStreams particles;
+        std::size_t count = 0;
+        std::size_t maxCount = 0;
+        std::uint32_t state = 1;
+    };
+
+    class ParticleSystem
+    {
+    public:
+        ParticleEmitter& addEmitter(std::size_t capacity, std::uint32_t seed = 1);
+        void removeEmitter(const ParticleEmitter& emitter);
+        void update(float dt, const ForceField& forces);
+
+        std::size_t emitterCount() const { return emitters.size(); }
+        ParticleEmitter& emitter(const std::size_t i) { return *emitters[i]; }
+        std::size_t particleCount() const;
+
+    private:
+        std::vector<std::unique_ptr<ParticleEmitter>> emitters;
+    };
+}
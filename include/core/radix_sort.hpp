@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace Kronos::CoreSystems::Sorting
+{
+    class RadixSorter
+    {
+    public:
+        void sort(std::uint32_t* keys, std::uint32_t* values, std::size_t n);
+        void sort(std::uint64_t* keys, std::uint32_t* values, std::size_t n);
+        void sortPermutation(std::uint32_t* keys, std::uint32_t* permutation, std::size_t n);
+        void sortPermutation(std::uint64_t* keys, std::uint32_t* permutation, std::size_t n);
+
+    private:
+        template <typename Key> void sortImpl(Key* keys, std::uint32_t* values, std::size_t n, std::vector<Key>& keyScratch);
+
+        std::vector<std::uint32_t> keyScratch32;
+        std::vector<std::uint64_t> keyScratch64;
+        std::vector<std::uint32_t> valueScratch;
+        std::vector<std::uint32_t> histograms;
+    };
+
+    template <typename T>
+    void applyPermutation(const std::uint32_t* permutation, const T* in, T* out, const std::size_t n)
+    {
+        Parallel::parallelFor(n, 8192, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i) { out[i] = in[permutation[i]]; }
+        });
+    }
+}
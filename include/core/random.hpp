@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Random
+{
+    // Bulk random generation on 4-lane xoshiro128+. Each call takes a fresh key from the seed, stream and
+    // number of calls so far, and every fixed-size block of its output seeds its own lanes from that key,
+    // so results depend only on those and not on how the blocks are split across workers. Distributions
+    // are sampled directly without rejection loops.
+    class RandomGenerator
+    {
+    public:
+        explicit RandomGenerator(std::uint64_t seed = 1, std::uint64_t stream = 0);
+
+        // an independent generator, such as one per thread; advances this one
+        RandomGenerator split();
+
+        // uniform in [low, high)
+        void uniform(float* out, std::size_t n, float low = 0.0f, float high = 1.0f);
+        void inBox(Math::Vector3* out, std::size_t n, const Math::Vector3& min, const Math::Vector3& max);
+        void onUnitSphere(Math::Vector3* out, std::size_t n);
+        void inUnitBall(Math::Vector3* out, std::size_t n);
+        // uniformly distributed rotations
+        void unitQuaternions(Math::Quaternion* out, std::size_t n);
+        void gaussian(float* out, std::size_t n, float mean = 0.0f, float deviation = 1.0f);
+
+    private:
+        std::uint64_t nextKey();
+
+        std::uint64_t key;
+        std::uint64_t calls = 0;
+    };
+}
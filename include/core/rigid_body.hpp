@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Physics
+{
+    struct RigidBodyDesc
+    {
+        Math::Vector3 position;
+        Math::Quaternion orientation {0.0f, 0.0f, 0.0f, 1.0f};
+        Math::Vector3 linearVelocity;
+        Math::Vector3 angularVelocity;
+        // zero for static and kinematic bodies
+        float inverseMass = 1.0f;
+        // body space
+        Math::Matrix3x3 inverseInertia = Math::Matrix3x3::IDENTITY;
+    };
+
+    Math::Matrix3x3 boxInverseInertia(float mass, const Math::Vector3& halfExtents);
+    Math::Matrix3x3 sphereInverseInertia(float mass, float radius);
+
+    // streams are padded to a multiple of the SIMD width with static identity bodies; resize keeps existing bodies
+    struct RigidBodyStreams
+    {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> orientationX, orientationY, orientationZ, orientationW;
+        std::vector<float> linearVelocityX, linearVelocityY, linearVelocityZ;
+        std::vector<float> angularVelocityX, angularVelocityY, angularVelocityZ;
+        std::vector<float> inverseMass;
+
+        void resize(std::size_t n);
+    };
+
+    class RigidBodySet
+    {
+    public:
+        std::uint32_t add(const RigidBodyDesc& desc);
+        void clear();
+
+        std::size_t size() const { return count; }
+        RigidBodyStreams& streams() { return bodies; }
+        const RigidBodyStreams& streams() const { return bodies; }
+
+        Math::Vector3 position(const std::size_t i) const { return {bodies.positionX[i], bodies.positionY[i], bodies.positionZ[i]}; }
+        Math::Quaternion orientation(const std::size_t i) const { return {bodies.orientationX[i], bodies.orientationY[i], bodies.orientationZ[i], bodies.orientationW[i]}; }
+        Math::Vector3 linearVelocity(const std::size_t i) const { return {bodies.linearVelocityX[i], bodies.linearVelocityY[i], bodies.linearVelocityZ[i]}; }
+        Math::Vector3 angularVelocity(const std::size_t i) const { return {bodies.angularVelocityX[i], bodies.angularVelocityY[i], bodies.angularVelocityZ[i]}; }
+        float inverseMass(const std::size_t i) const { return bodies.inverseMass[i]; }
+        const Math::Matrix3x3& worldInverseInertia(const std::size_t i) const { return worldInertia[i]; }
+
+        void setTransform(std::size_t i, const Math::Vector3& position, const Math::Quaternion& orientation);
+        void setVelocity(std::size_t i, const Math::Vector3& linear, const Math::Vector3& angular);
+
+        // v += g h for dynamic bodies, then v *= max(1 - damping h, 0)
+        void integrateVelocities(float h, const Math::Vector3& gravity, float linearDamping = 0.0f, float angularDamping = 0.0f);
+        // x += v h and q += h/2 (w, 0) q followed by renormalization; refreshes world inverse inertia
+        void integratePositions(float h);
+        void updateWorldInertia();
+
+    private:
+        RigidBodyStreams bodies;
+        std::vector<Math::Matrix3x3> localInertia;
+        std::vector<Math::Matrix3x3> worldInertia;
+        std::size_t count = 0;
+    };
+
+    struct ContactPoint
+    {
+        std::uint32_t bodyA, bodyB;
+        // world space, between the two surfaces
+        Math::Vector3 point;
+        // unit, pointing from A to B
+        Math::Vector3 normal;
+        // negative when penetrating
+        float separation = 0.0f;
+        float friction = 0.5f;
+        float restitution = 0.0f;
+        // accumulated impulses: read for warm starting and written back by the solver, so keeping the
+        // contact alive across frames (for example in the pair cache) carries them to the next step
+        float normalImpulse = 0.0f;
+        float tangentImpulse[2] = {};
+    };
+
+    // substeps = 1, iterations ~8, relaxIterations = 0 is classic PGS with Baumgarte stabilization;
+    // several substeps with one iteration and one relax pass each is the TGS "soft step" variant
+    struct ContactSolverParams
+    {
+        Math::Vector3 gravity {0.0f, -9.81f, 0.0f};
+        int substeps = 4;
+        int iterations = 1;
+        int relaxIterations = 1;
+        float baumgarte = 0.2f;
+        float maxBiasVelocity = 4.0f;
+        float slop = 0.005f;
+        float restitutionThreshold = 1.0f;
+        float linearDamping = 0.0f;
+        float angularDamping = 0.0f;
+        bool warmStart = true;
+    };
+
+    // Contacts are graph coloured over dynamic bodies so each colour can be solved four contacts per
+    // SIMD group and across workers without races; static bodies may appear in any number of contacts.
+    class ContactSolver
+    {
+    public:
+        static constexpr int MAX_COLORS = 64;
+
+        // advances the bodies by dt, solving contacts that were generated at the start of the step
+        void step(RigidBodySet& bodies, ContactPoint* contacts, std::size_t n, float dt, const ContactSolverParams& params);
+
+        std::size_t colorCount() const { return colorOffsets.empty() ? 0 : colorOffsets.size() - 1; }
+
+    private:
+        void prepare(const RigidBodySet& bodies, const ContactPoint* contacts, std::size_t n, const ContactSolverParams& params);
+        void warmStart(RigidBodySet& bodies, bool apply);
+        void solve(RigidBodySet& bodies, float h, bool useBias, const ContactSolverParams& params);
+        void accumulateDeltas(const RigidBodySet& bodies, float h);
+        void storeImpulses(ContactPoint* contacts) const;
+
+        template <typename Kernel>
+        void forEachGroup(Kernel&& kernel);
+
+        // contacts are permuted by colour and each colour is padded to whole SIMD groups; serially solved
+        // contacts take a group each
+        std::vector<std::size_t> colorOffsets;
+        std::vector<std::size_t> colorCounts;
+        bool serialTail = false;
+        std::vector<std::uint32_t> bodyA, bodyB, source;
+        std::vector<float> rows;
+        std::size_t slotCount = 0;
+        std::vector<float> deltaX, deltaY, deltaZ, rotationX, rotationY, rotationZ;
+    };
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KRONOS_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Kronos::CoreSystems::Simd
+{
+    constexpr int WIDTH = 4;
+
+    inline std::size_t roundUpToWidth(const std::size_t n) { return (n + WIDTH - 1) & ~static_cast<std::size_t>(WIDTH - 1); }
+
+#ifdef KRONOS_SIMD_SSE2
+    struct Float4
+    {
+        __m128 v;
+
+        Float4() : v(_mm_setzero_ps()) {}
+        Float4(const __m128 v) : v(v) {}
+        explicit Float4(const float s) : v(_mm_set1_ps(s)) {}
+        Float4(const float x, const float y, const float z, const float w) : v(_mm_setr_ps(x, y, z, w)) {}
+
+        static Float4 load(const float* p) { return _mm_loadu_ps(p); }
+        void store(float* p) const { _mm_storeu_ps(p, v); }
+
+        float operator[](const int i) const { alignas(16) float t[4]; _mm_store_ps(t, v); return t[i]; }
+    };
+
+    struct Int4
+    {
+        __m128i v;
+
+        Int4() : v(_mm_setzero_si128()) {}
+        Int4(const __m128i v) : v(v) {}
+        explicit Int4(const std::int32_t s) : v(_mm_set1_epi32(s)) {}
+        Int4(const std::int32_t x, const std::int32_t y, const std::int32_t z, const std::int32_t w) : v(_mm_setr_epi32(x, y, z, w)) {}
+
+        static Int4 load(const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        static Int4 load(const std::uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        void store(std::int32_t* p) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+        void store(std::uint32_t* p) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+        std::int32_t operator[](const int i) const { alignas(16) std::int32_t t[4]; _mm_store_si128(reinterpret_cast<__m128i*>(t), v); return t[i]; }
+    };
+
+    inline Float4 operator+(const Float4& a, const Float4& b) { return _mm_add_ps(a.v, b.v); }
+    inline Float4 operator-(const Float4& a, const Float4& b) { return _mm_sub_ps(a.v, b.v); }
+    inline Float4 operator*(const Float4& a, const Float4& b) { return _mm_mul_ps(a.v, b.v); }
+    inline Float4 operator/(const Float4& a, const Float4& b) { return _mm_div_ps(a.v, b.v); }
+    inline Float4 operator-(const Float4& a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+    inline Float4 operator&(const Float4& a, const Float4& b) { return _mm_and_ps(a.v, b.v); }
+    inline Float4 operator|(const Float4& a, const Float4& b) { return _mm_or_ps(a.v, b.v); }
+    inline Float4 operator^(const Float4& a, const Float4& b) { return _mm_xor_ps(a.v, b.v); }
+    inline Float4 andNot(const Float4& a, const Float4& b) { return _mm_andnot_ps(a.v, b.v); }
+
+    inline Float4 min(const Float4& a, const Float4& b) { return _mm_min_ps(a.v, b.v); }
+    inline Float4 max(const Float4& a, const Float4& b) { return _mm_max_ps(a.v, b.v); }
+    inline Float4 sqrt(const Float4& a) { return _mm_sqrt_ps(a.v); }
+    inline Float4 abs(const Float4& a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+
+    inline Float4 operator<(const Float4& a, const Float4& b) { return _mm_cmplt_ps(a.v, b.v); }
+    inline Float4 operator<=(const Float4& a, const Float4& b) { return _mm_cmple_ps(a.v, b.v); }
+    inline Float4 operator>(const Float4& a, const Float4& b) { return _mm_cmpgt_ps(a.v, b.v); }
+    inline Float4 operator>=(const Float4& a, const Float4& b) { return _mm_cmpge_ps(a.v, b.v); }
+    inline Float4 operator==(const Float4& a, const Float4& b) { return _mm_cmpeq_ps(a.v, b.v); }
+    inline Float4 operator!=(const Float4& a, const Float4& b) { return _mm_cmpneq_ps(a.v, b.v); }
+
+    inline Float4 select(const Float4& mask, const Float4& a, const Float4& b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+    inline int moveMask(const Float4& mask) { return _mm_movemask_ps(mask.v); }
+
+    inline Int4 asInt(const Float4& a) { return _mm_castps_si128(a.v); }
+    inline Float4 asFloat(const Int4& a) { return _mm_castsi128_ps(a.v); }
+    inline Int4 truncateToInt(const Float4& a) { return _mm_cvttps_epi32(a.v); }
+    inline Int4 roundToInt(const Float4& a) { return _mm_cvtps_epi32(a.v); }
+    inline Float4 toFloat(const Int4& a) { return _mm_cvtepi32_ps(a.v); }
+
+    inline Float4 floor(const Float4& a)
+    {
+        const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)));
+    }
+
+    inline float reduceAdd(const Float4& a)
+    {
+        const __m128 s = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+    }
+    inline float reduceMin(const Float4& a)
+    {
+        const __m128 s = _mm_min_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_min_ss(s, _mm_shuffle_ps(s, s, 1)));
+    }
+    inline float reduceMax(const Float4& a)
+    {
+        const __m128 s = _mm_max_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_max_ss(s, _mm_shuffle_ps(s, s, 1)));
+    }
+
+    inline void transpose(Float4& a, Float4& b, Float4& c, Float4& d) { _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v); }
+
+    inline Int4 operator+(const Int4& a, const Int4& b) { return _mm_add_epi32(a.v, b.v); }
+    inline Int4 operator-(const Int4& a, const Int4& b) { return _mm_sub_epi32(a.v, b.v); }
+    inline Int4 operator&(const Int4& a, const Int4& b) { return _mm_and_si128(a.v, b.v); }
+    inline Int4 operator|(const Int4& a, const Int4& b) { return _mm_or_si128(a.v, b.v); }
+    inline Int4 operator^(const Int4& a, const Int4& b) { return _mm_xor_si128(a.v, b.v); }
+    inline Int4 operator<<(const Int4& a, const int n) { return _mm_sll_epi32(a.v, _mm_cvtsi32_si128(n)); }
+    inline Int4 operator>>(const Int4& a, const int n) { return _mm_srl_epi32(a.v, _mm_cvtsi32_si128(n)); }
+    inline Int4 operator==(const Int4& a, const Int4& b) { return _mm_cmpeq_epi32(a.v, b.v); }
+    inline Int4 operator>(const Int4& a, const Int4& b) { return _mm_cmpgt_epi32(a.v, b.v); }
+    inline Int4 operator<(const Int4& a, const Int4& b) { return _mm_cmplt_epi32(a.v, b.v); }
+    inline Int4 operator*(const Int4& a, const Int4& b)
+    {
+        const __m128i even = _mm_mul_epu32(a.v, b.v);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    inline Int4 select(const Int4& mask, const Int4& a, const Int4& b) { return _mm_or_si128(_mm_and_si128(mask.v, a.v), _mm_andnot_si128(mask.v, b.v)); }
+    inline Int4 min(const Int4& a, const Int4& b) { return select(a < b, a, b); }
+    inline Int4 max(const Int4& a, const Int4& b) { return select(a > b, a, b); }
+#else
+    struct Float4
+    {
+        float v[4];
+
+        Float4() : v{0.0f, 0.0f, 0.0f, 0.0f} {}
+        explicit Float4(const float s) : v{s, s, s, s} {}
+        Float4(const float x, const float y, const float z, const float w) : v{x, y, z, w} {}
+
+        static Float4 load(const float* p) { return {p[0], p[1], p[2], p[3]}; }
+        void store(float* p) const { p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3]; }
+
+        float operator[](const int i) const { return v[i]; }
+    };
+
+    struct Int4
+    {
+        std::int32_t v[4];
+
+        Int4() : v{0, 0, 0, 0} {}
+        explicit Int4(const std::int32_t s) : v{s, s, s, s} {}
+        Int4(const std::int32_t x, const std::int32_t y, const std::int32_t z, const std::int32_t w) : v{x, y, z, w} {}
+
+        static Int4 load(const std::int32_t* p) { return {p[0], p[1], p[2], p[3]}; }
+        static Int4 load(const std::uint32_t* p) { Int4 r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+        void store(std::int32_t* p) const { std::memcpy(p, v, sizeof(v)); }
+        void store(std::uint32_t* p) const { std::memcpy(p, v, sizeof(v)); }
+
+        std::int32_t operator[](const int i) const { return v[i]; }
+    };
+
+    namespace Detail
+    {
+        inline std::uint32_t bits(const float f) { std::uint32_t u; std::memcpy(&u, &f, 4); return u; }
+        inline float fromBits(const std::uint32_t u) { float f; std::memcpy(&f, &u, 4); return f; }
+        inline float mask(const bool b) { return fromBits(b ? 0xFFFFFFFFu : 0u); }
+
+        template <typename Op> Float4 map(const Float4& a, const Float4& b, Op op) { return {op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}; }
+        template <typename Op> Int4 map(const Int4& a, const Int4& b, Op op) { return {op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}; }
+        template <typename Op> Float4 bitwise(const Float4& a, const Float4& b, Op op) { return map(a, b, [op](const float x, const float y) { return fromBits(op(bits(x), bits(y))); }); }
+        template <typename Op> Int4 map(const Int4& a, Op op) { return {op(a.v[0]), op(a.v[1]), op(a.v[2]), op(a.v[3])}; }
+        template <typename Op> Float4 map(const Float4& a, Op op) { return {op(a.v[0]), op(a.v[1]), op(a.v[2]), op(a.v[3])}; }
+    }
+
+    inline Float4 operator+(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return x + y; }); }
+    inline Float4 operator-(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return x - y; }); }
+    inline Float4 operator*(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return x * y; }); }
+    inline Float4 operator/(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return x / y; }); }
+    inline Float4 operator-(const Float4& a) { return Detail::map(a, [](const float x) { return -x; }); }
+    inline Float4 operator&(const Float4& a, const Float4& b) { return Detail::bitwise(a, b, [](const std::uint32_t x, const std::uint32_t y) { return x & y; }); }
+    inline Float4 operator|(const Float4& a, const Float4& b) { return Detail::bitwise(a, b, [](const std::uint32_t x, const std::uint32_t y) { return x | y; }); }
+    inline Float4 operator^(const Float4& a, const Float4& b) { return Detail::bitwise(a, b, [](const std::uint32_t x, const std::uint32_t y) { return x ^ y; }); }
+    inline Float4 andNot(const Float4& a, const Float4& b) { return Detail::bitwise(a, b, [](const std::uint32_t x, const std::uint32_t y) { return ~x & y; }); }
+
+    inline Float4 min(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return x < y ? x : y; }); }
+    inline Float4 max(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return x > y ? x : y; }); }
+    inline Float4 sqrt(const Float4& a) { return Detail::map(a, [](const float x) { return std::sqrt(x); }); }
+    inline Float4 abs(const Float4& a) { return Detail::map(a, [](const float x) { return std::fabs(x); }); }
+
+    inline Float4 operator<(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return Detail::mask(x < y); }); }
+    inline Float4 operator<=(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return Detail::mask(x <= y); }); }
+    inline Float4 operator>(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return Detail::mask(x > y); }); }
+    inline Float4 operator>=(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return Detail::mask(x >= y); }); }
+    inline Float4 operator==(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return Detail::mask(x == y); }); }
+    inline Float4 operator!=(const Float4& a, const Float4& b) { return Detail::map(a, b, [](const float x, const float y) { return Detail::mask(x != y); }); }
+
+    inline Float4 select(const Float4& mask, const Float4& a, const Float4& b) { return (mask & a) | andNot(mask, b); }
+    inline int moveMask(const Float4& mask)
+    {
+        int m = 0;
+        for (int i = 0; i < 4; ++i) { m |= static_cast<int>(Detail::bits(mask.v[i]) >> 31) << i; }
+        return m;
+    }
+
+    inline Int4 asInt(const Float4& a) { Int4 r; std::memcpy(r.v, a.v, sizeof(r.v)); return r; }
+    inline Float4 asFloat(const Int4& a) { Float4 r; std::memcpy(r.v, a.v, sizeof(r.v)); return r; }
+    inline Int4 truncateToInt(const Float4& a) { return {static_cast<std::int32_t>(a.v[0]), static_cast<std::int32_t>(a.v[1]), static_cast<std::int32_t>(a.v[2]), static_cast<std::int32_t>(a.v[3])}; }
+    inline Int4 roundToInt(const Float4& a) { return {static_cast<std::int32_t>(std::nearbyint(a.v[0])), static_cast<std::int32_t>(std::nearbyint(a.v[1])), static_cast<std::int32_t>(std::nearbyint(a.v[2])), static_cast<std::int32_t>(std::nearbyint(a.v[3]))}; }
+    inline Float4 toFloat(const Int4& a) { return {static_cast<float>(a.v[0]), static_cast<float>(a.v[1]), static_cast<float>(a.v[2]), static_cast<float>(a.v[3])}; }
+    inline Float4 floor(const Float4& a) { return Detail::map(a, [](const float x) { return std::floor(x); }); }
+
+    inline float reduceAdd(const Float4& a) { return (a.v[0] + a.v[2]) + (a.v[1] + a.v[3]); }
+    inline float reduceMin(const Float4& a) { return std::fmin(std::fmin(a.v[0], a.v[1]), std::fmin(a.v[2], a.v[3])); }
+    inline float reduceMax(const Float4& a) { return std::fmax(std::fmax(a.v[0], a.v[1]), std::fmax(a.v[2], a.v[3])); }
+
+    inline void transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+    {
+        const Float4 ta = a, tb = b, tc = c, td = d;
+        a = {ta.v[0], tb.v[0], tc.v[0], td.v[0]};
+        b = {ta.v[1], tb.v[1], tc.v[1], td.v[1]};
+        c = {ta.v[2], tb.v[2], tc.v[2], td.v[2]};
+        d = {ta.v[3], tb.v[3], tc.v[3], td.v[3]};
+    }
+
+    inline Int4 operator+(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) + static_cast<std::uint32_t>(y)); }); }
+    inline Int4 operator-(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) - static_cast<std::uint32_t>(y)); }); }
+    inline Int4 operator*(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) * static_cast<std::uint32_t>(y)); }); }
+    inline Int4 operator&(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return x & y; }); }
+    inline Int4 operator|(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return x | y; }); }
+    inline Int4 operator^(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return x ^ y; }); }
+    inline Int4 operator<<(const Int4& a, const int n) { return Detail::map(a, [n](const std::int32_t x) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) << n); }); }
+    inline Int4 operator>>(const Int4& a, const int n) { return Detail::map(a, [n](const std::int32_t x) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) >> n); }); }
+    inline Int4 operator==(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return x == y ? -1 : 0; }); }
+    inline Int4 operator>(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return x > y ? -1 : 0; }); }
+    inline Int4 operator<(const Int4& a, const Int4& b) { return Detail::map(a, b, [](const std::int32_t x, const std::int32_t y) { return x < y ? -1 : 0; }); }
+
+    inline Int4 select(const Int4& mask, const Int4& a, const Int4& b) { return (mask & a) | Detail::map(mask, b, [](const std::int32_t m, const std::int32_t y) { return ~m & y; }); }
+    inline Int4 min(const Int4& a, const Int4& b) { return select(a < b, a, b); }
+    inline Int4 max(const Int4& a, const Int4& b) { return select(a > b, a, b); }
+#endif
+
+    inline Float4 multiplyAdd(const Float4& a, const Float4& b, const Float4& c) { return a * b + c; }
+    inline Float4 clamp(const Float4& a, const Float4& lo, const Float4& hi) { return min(max(a, lo), hi); }
+    inline Float4 lerp(const Float4& a, const Float4& b, const Float4& t) { return multiplyAdd(b - a, t, a); }
+    inline Float4 asMask(const Int4& a) { return asFloat(a); }
+    inline bool any(const Float4& mask) { return moveMask(mask) != 0; }
+    inline bool all(const Float4& mask) { return moveMask(mask) == 0xF; }
+
+    inline Float4 dot3(const Float4& ax, const Float4& ay, const Float4& az, const Float4& bx, const Float4& by, const Float4& bz) { return multiplyAdd(ax, bx, multiplyAdd(ay, by, az * bz)); }
+    inline Float4 rsqrt(const Float4& a) { return Float4(1.0f) / sqrt(a); }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::LinearAlgebra
+{
+    struct Vector3Streams
+    {
+        std::vector<float> x, y, z;
+
+        void resize(std::size_t n);
+        std::size_t size() const { return x.size(); }
+    };
+
+    struct Triplet
+    {
+        int row;
+        int column;
+        float value;
+    };
+
+    struct BlockTriplet
+    {
+        int row;
+        int column;
+        Math::Matrix3x3 value;
+    };
+
+    // compressed sparse rows; duplicate triplets are summed and columns are sorted within a row
+    class SparseMatrix
+    {
+    public:
+        SparseMatrix() = default;
+        SparseMatrix(int rows, int columns, std::vector<Triplet> entries);
+
+        int rowCount() const { return rows; }
+        int columnCount() const { return columns; }
+        std::size_t nonZeroCount() const { return values.size(); }
+
+        const std::vector<int>& rowOffsets() const { return offsets; }
+        const std::vector<int>& columnIndices() const { return indices; }
+        std::vector<float>& coefficients() { return values; }
+        const std::vector<float>& coefficients() const { return values; }
+
+        // null when (row, column) is outside the sparsity pattern
+        float* find(int row, int column);
+
+        void multiply(const float* x, float* y) const;
+
+    private:
+        int rows = 0;
+        int columns = 0;
+        std::vector<int> offsets {0};
+        std::vector<int> indices;
+        std::vector<float> values;
+    };
+
+    // block compressed sparse rows with 3x3 blocks, acting on Vector3Streams; the pattern is fixed at
+    // construction so per-step assembly only rewrites block values through find or setZero
+    class BlockSparseMatrix
+    {
+    public:
+        BlockSparseMatrix() = default;
+        BlockSparseMatrix(int blockRows, int blockColumns, std::vector<BlockTriplet> entries);
+
+        int blockRowCount() const { return rows; }
+        int blockColumnCount() const { return columns; }
+        std::size_t blockCount() const { return blocks.size(); }
+
+        const std::vector<int>& rowOffsets() const { return offsets; }
+        const std::vector<int>& columnIndices() const { return indices; }
+        std::vector<Math::Matrix3x3>& blockValues() { return blocks; }
+        const std::vector<Math::Matrix3x3>& blockValues() const { return blocks; }
+
+        // index of the diagonal block of a row, or -1 when the row has none
+        int diagonalIndex(const int row) const { return diagonals[row]; }
+
+        Math::Matrix3x3* find(int row, int column);
+        void setZero();
+
+        void multiply(const Vector3Streams& x, Vector3Streams& y) const;
+
+    private:
+        int rows = 0;
+        int columns = 0;
+        std::vector<int> offsets {0};
+        std::vector<int> indices;
+        std::vector<int> diagonals;
+        std::vector<Math::Matrix3x3> blocks;
+    };
+
+    enum class Preconditioner
+    {
+        None,
+        Jacobi,
+        IncompleteCholesky
+    };
+
+    struct ConjugateGradientParams
+    {
+        int maxIterations = 100;
+        // relative to the norm of the right-hand side
+        float tolerance = 1e-4f;
+        Preconditioner preconditioner = Preconditioner::Jacobi;
+    };
+
+    struct ConjugateGradientResult
+    {
+        int iterations = 0;
+        float residual = 0.0f;
+        bool converged = false;
+    };
+
+    // preconditioned CG for symmetric positive definite block systems. Jacobi inverts the 3x3 diagonal
+    // blocks and is fully parallel; incomplete Cholesky is IC(0) on the block pattern, converges in fewer
+    // iterations but applies serially, and falls back to Jacobi when the factorization breaks down.
+    // Scratch streams persist between calls so repeated solves of the same size do not allocate.
+    class ConjugateGradientSolver
+    {
+    public:
+        // x is the initial guess, zeroed when its size does not match; a zero right-hand side zeroes x
+        // and reports convergence without iterating
+        ConjugateGradientResult solve(const BlockSparseMatrix& a, const Vector3Streams& b, Vector3Streams& x, const ConjugateGradientParams& params = {});
+
+    private:
+        void buildJacobi(const BlockSparseMatrix& a);
+        bool buildIncompleteCholesky(const BlockSparseMatrix& a);
+        void applyPreconditioner(Preconditioner kind, const Vector3Streams& r, Vector3Streams& z) const;
+
+        Vector3Streams residual, preconditioned, direction, product;
+        std::vector<double> partialSums;
+        std::vector<Math::Matrix3x3> inverseDiagonal;
+        std::vector<int> lowerOffsets;
+        std::vector<int> lowerIndices;
+        std::vector<Math::Matrix3x3> lowerBlocks;
+    };
+}
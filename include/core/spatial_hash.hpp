@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Spatial
+{
+    struct Neighbor
+    {
+        std::uint32_t index;
+        float squaredDistance;
+    };
+
+    class SpatialHashGrid
+    {
+    public:
+        explicit SpatialHashGrid(float cellSize, std::size_t tableSize = 0);
+
+        void build(const Math::Vector3* points, std::size_t count);
+        bool update(const Math::Vector3* points, std::size_t count);
+
+        void queryRadius(const Math::Vector3& center, float radius, std::vector<std::uint32_t>& out) const;
+        void queryNearest(const Math::Vector3& center, std::size_t k, float maxRadius, std::vector<Neighbor>& out) const;
+
+        void queryRadiusBatch(const Math::Vector3* centers, std::size_t n, float radius,
+                              std::vector<std::uint32_t>& offsets, std::vector<std::uint32_t>& indices) const;
+        void queryNearestBatch(const Math::Vector3* centers, std::size_t n, std::size_t k, float maxRadius,
+                               std::uint32_t* outIndices, float* outSquaredDistances) const;
+
+        float cellSize() const { return size; }
+        std::size_t pointCount() const { return count; }
+        std::size_t movedCount() const { return overflow.size(); }
+        void setRebuildThreshold(const float fraction) { rebuildFraction = fraction; }
+
+    private:
+        struct MovedPoint
+        {
+            std::uint32_t bucket;
+            std::uint32_t index;
+            float x, y, z;
+        };
+
+        std::uint32_t bucketOf(const Math::Vector3& p) const;
+        std::uint32_t bucketOf(std::int32_t x, std::int32_t y, std::int32_t z) const;
+        void computeBuckets(const Math::Vector3* points, std::uint32_t* out) const;
+        template <typename Visitor> void visitCells(const Math::Vector3& center, float radius, Visitor&& visitor) const;
+        template <typename Visitor> void visitInRadius(const Math::Vector3& center, float radius, Visitor&& visitor) const;
+
+        float size;
+        float inverseSize;
+        std::size_t fixedTableSize;
+        std::uint32_t mask = 0;
+        std::size_t count = 0;
+        float rebuildFraction = 0.0625f;
+
+        std::vector<std::uint32_t> cellStart;
+        std::vector<std::uint32_t> entries;
+        std::vector<float> sortedX, sortedY, sortedZ;
+        std::vector<std::uint32_t> pointBucket;
+        std::vector<std::uint32_t> pointSlot;
+        std::vector<MovedPoint> overflow;
+        std::vector<std::uint32_t> histogram;
+        std::vector<std::uint32_t> scratchBuckets;
+    };
+}
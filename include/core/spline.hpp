@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Curves
+{
+    // piecewise cubic stored as power-basis coefficients per segment; the curve parameter u runs over
+    // [0, segmentCount()] with the integer part selecting the segment
+    template <typename Vector>
+    class Spline
+    {
+    public:
+        static constexpr int DIMENSION = sizeof(Vector) / sizeof(float);
+
+        // 3k + 1 control points, consecutive segments share their end point
+        static Spline bezier(const std::vector<Vector>& controlPoints);
+        // interpolates every point; alpha 0 is uniform, 0.5 centripetal, 1 chordal
+        static Spline catmullRom(const std::vector<Vector>& points, float alpha = 0.5f);
+        static Spline hermite(const std::vector<Vector>& points, const std::vector<Vector>& tangents);
+
+        std::size_t segmentCount() const { return segments; }
+
+        Vector evaluate(float u) const;
+        Vector tangent(float u) const;
+        // positions or tangents may be null
+        void evaluate(const float* u, std::size_t n, Vector* positions, Vector* tangents) const;
+
+        void buildArcLengthTable(std::size_t subdivisions = 16);
+        float length() const { return arcLengths.empty() ? 0.0f : arcLengths.back(); }
+        float parameterAtDistance(float distance) const;
+        void evaluateAtDistances(const float* distances, std::size_t n, Vector* positions, Vector* tangents) const;
+
+        // appends a polyline that stays within tolerance of the curve
+        void flatten(float tolerance, std::vector<Vector>& points) const;
+
+    private:
+        static constexpr int STRIDE = DIMENSION * 4;
+
+        void appendSegment(const Vector& p0, const Vector& p1, const Vector& m0, const Vector& m1);
+        float speed(std::size_t segment, float t) const;
+        float segmentLength(std::size_t segment, float t0, float t1) const;
+        void evaluateRange(const float* u, std::size_t n, Vector* positions, Vector* tangents) const;
+
+        std::vector<float> coefficients;
+        std::vector<float> arcLengths;
+        std::size_t segments = 0;
+        std::size_t arcSubdivisions = 0;
+    };
+
+    using Spline2 = Spline<Math::Vector2>;
+    using Spline3 = Spline<Math::Vector3>;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Math
+{
+    struct TransformTRS
+    {
+        Vector3 translation;
+        Quaternion rotation {0.0f, 0.0f, 0.0f, 1.0f};
+        Vector3 scale {1.0f, 1.0f, 1.0f};
+    };
+
+    enum class DecomposeMode
+    {
+        // column lengths and a direct matrix-to-quaternion conversion; exact for pure TRS matrices
+        Fast,
+        // nearest rotation by polar decomposition, robust against shear and drift
+        Polar
+    };
+
+    // matrices act on column vectors as T * R * S, with the translation in m03, m13, m23
+    Matrix4x4 compose(const TransformTRS& transform);
+    TransformTRS decompose(const Matrix4x4& m, DecomposeMode mode = DecomposeMode::Fast);
+
+    void compose(const TransformTRS* transforms, std::size_t n, Matrix4x4* out);
+    void decompose(const Matrix4x4* matrices, std::size_t n, TransformTRS* out, DecomposeMode mode = DecomposeMode::Fast);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+namespace Kronos::CoreSystems::Physics
+{
+    struct ParticleState
+    {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> previousX, previousY, previousZ;
+        std::vector<float> velocityX, velocityY, velocityZ;
+        std::vector<float> inverseMass;
+
+        void resize(std::size_t n);
+    };
+
+    struct DistanceConstraint
+    {
+        std::uint32_t a, b;
+        float restLength;
+        float compliance;
+    };
+
+    // triangle bending of Kelager et al. 2010: keeps the middle particle b at its rest distance from
+    // the centroid of (a, b, c); works for rope chains and for grid lines of cloth
+    struct BendingConstraint
+    {
+        std::uint32_t a, b, c;
+        float restDistance;
+        float compliance;
+    };
+
+    struct ClothConstraints
+    {
+        std::vector<DistanceConstraint> distances;
+        std::vector<BendingConstraint> bends;
+    };
+
+    // rest values are measured from the given positions
+    ClothConstraints makeRope(const std::vector<Math::Vector3>& positions, float stretchCompliance, float bendCompliance);
+    ClothConstraints makeClothGrid(const std::vector<Math::Vector3>& positions, int columns, int rows,
+                                   float stretchCompliance, float shearCompliance, float bendCompliance);
+
+    struct SphereCollider
+    {
+        Math::Vector3 center;
+        float radius;
+    };
+
+    struct CapsuleCollider
+    {
+        Math::Vector3 a, b;
+        float radius;
+    };
+
+    struct PlaneCollider
+    {
+        Math::Vector3 normal;
+        float distance;
+    };
+
+    struct ColliderSet
+    {
+        std::vector<SphereCollider> spheres;
+        std::vector<CapsuleCollider> capsules;
+        std::vector<PlaneCollider> planes;
+    };
+
+    struct XpbdParams
+    {
+        Math::Vector3 gravity {0.0f, -9.81f, 0.0f};
+        int substeps = 8;
+        int iterations = 1;
+        // fraction of velocity removed per second
+        float damping = 0.0f;
+        float particleRadius = 0.01f;
+    };
+
+    // Constraints are greedily graph coloured so no two constraints of a colour share a particle;
+    // each colour is then solved four constraints per SIMD group and split across workers without
+    // races. Constraints that would need more than MAX_COLORS colours are solved serially.
+    class XpbdSolver
+    {
+    public:
+        static constexpr int MAX_COLORS = 64;
+
+        XpbdSolver(const std::vector<Math::Vector3>& positions, const std::vector<float>& inverseMasses, const ClothConstraints& constraints);
+
+        void step(float dt, const XpbdParams& params, const ColliderSet* colliders = nullptr);
+
+        std::size_t particleCount() const { return count; }
+        const ParticleState& state() const { return particles; }
+        Math::Vector3 position(std::size_t i) const { return {particles.positionX[i], particles.positionY[i], particles.positionZ[i]}; }
+        // moves a particle without giving it velocity; intended for pinned (zero inverse mass) attachments
+        void setPosition(std::size_t i, const Math::Vector3& p);
+        void setInverseMass(std::size_t i, float w) { particles.inverseMass[i] = w; }
+
+        std::size_t distanceColorCount() const { return distanceColors.size(); }
+        std::size_t bendingColorCount() const { return bendingColors.size(); }
+
+    private:
+        struct ConstraintColor
+        {
+            std::vector<std::uint32_t> a, b, c;
+            std::vector<float> rest, compliance, lambda;
+            bool serial = false;
+
+            std::size_t size() const { return a.size(); }
+        };
+
+        void integrate(float h, const XpbdParams& params);
+        void solveColors(std::vector<ConstraintColor>& colors, bool bending, float h);
+        void collide(const ColliderSet& colliders, float radius);
+        void updateVelocities(float h, float damping);
+
+        ParticleState particles;
+        std::size_t count = 0;
+        std::vector<ConstraintColor> distanceColors;
+        std::vector<ConstraintColor> bendingColors;
+    };
+
+    struct SimulationJob
+    {
+        XpbdSolver* solver;
+        float dt;
+        const ColliderSet* colliders;
+    };
+
+    // steps independent solvers across workers; each solver then runs its colours inline
+    void simulateBatch(const SimulationJob* jobs, std::size_t n, const XpbdParams& params);
+}
@@ -0,0 +1,175 @@
+#include "animation.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Animation;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr int BLOCK_FLOATS = 16;
+
+    template <int Components>
+    constexpr int keysPerBlock() { return BLOCK_FLOATS / (Components + 1); }
+
+    void unpackVector(const Vector3& v, float* out) { out[0] = v.x; out[1] = v.y; out[2] = v.z; }
+    void unpackQuaternion(const Quaternion& q, float* out) { out[0] = q.x; out[1] = q.y; out[2] = q.z; out[3] = q.w; }
+
+    // keeps neighbouring rotation keys in one hemisphere so sampled output does not flip sign between intervals
+    std::vector<Keyframe<Quaternion>> makeContinuous(std::vector<Keyframe<Quaternion>> keys)
+    {
+        for (std::size_t i = 1; i < keys.size(); ++i)
+        {
+            if (keys[i].value.dot(keys[i - 1].value) < 0.0f) { keys[i].value = -keys[i].value; }
+        }
+        return keys;
+    }
+}
+
+void PoseStreams::resize(const std::size_t n)
+{
+    for (std::vector<float>* stream : {&translationX, &translationY, &translationZ, &rotationX, &rotationY, &rotationZ, &rotationW,
+                                       &scaleX, &scaleY, &scaleZ})
+    {
+        stream->assign(n, 0.0f);
+    }
+}
+
+AnimationClip::AnimationClip(const std::vector<JointTrack>& jointTracks) : joints(jointTracks.size()), paddedJoints(roundUpToWidth(jointTracks.size()))
+{
+    // padding joints get constant identity tracks so every SIMD group is full
+    const JointTrack identity;
+    tracks.resize(CHANNEL_COUNT * paddedJoints);
+    for (std::size_t j = 0; j < paddedJoints; ++j)
+    {
+        const JointTrack& joint = j < jointTracks.size() ? jointTracks[j] : identity;
+        tracks[TRANSLATION * paddedJoints + j] = appendTrack<3>(joint.translation, Vector3(0.0f, 0.0f, 0.0f), unpackVector);
+        tracks[ROTATION * paddedJoints + j] = appendTrack<4>(makeContinuous(joint.rotation), Quaternion(0.0f, 0.0f, 0.0f, 1.0f), unpackQuaternion);
+        tracks[SCALE * paddedJoints + j] = appendTrack<3>(joint.scale, Vector3(1.0f, 1.0f, 1.0f), unpackVector);
+    }
+}
+
+template <int Components, typename T, typename Unpack>
+AnimationClip::Track AnimationClip::appendTrack(const std::vector<Keyframe<T>>& keys, const T& fallback, Unpack unpack)
+{
+    constexpr int KEYS = keysPerBlock<Components>();
+    const std::size_t keyCount = std::max<std::size_t>(keys.size(), 1);
+    const std::size_t blockCount = std::max<std::size_t>(1, (keyCount - 1 + KEYS - 2) / (KEYS - 1));
+
+    const Track track {static_cast<std::uint32_t>(blocks.size()), static_cast<std::uint32_t>(blockCount)};
+    for (std::size_t b = 0; b < blockCount; ++b)
+    {
+        KeyBlock block {};
+        for (int k = 0; k < KEYS; ++k)
+        {
+            // the tail of the last block repeats the final key, giving zero-length intervals
+            const std::size_t source = std::min(b * (KEYS - 1) + k, keyCount - 1);
+            float* key = block.data + k * (Components + 1);
+            key[0] = keys.empty() ? 0.0f : keys[source].time;
+            unpack(keys.empty() ? fallback : keys[source].value, key + 1);
+        }
+        blocks.push_back(block);
+        blockStarts.push_back(block.data[0]);
+    }
+    if (!keys.empty()) { length = std::max(length, keys.back().time); }
+    return track;
+}
+
+std::uint32_t AnimationClip::locate(const Track& track, const std::uint32_t hint, const float time) const
+{
+    const float* starts = blockStarts.data() + track.firstBlock;
+
+    // sequential playback stays in the cached block or steps into the next one
+    if (hint < track.blockCount && starts[hint] <= time)
+    {
+        if (hint + 1 == track.blockCount || time < starts[hint + 1]) { return hint; }
+        if (hint + 2 == track.blockCount || time < starts[hint + 2]) { return hint + 1; }
+    }
+
+    const std::uint32_t upper = static_cast<std::uint32_t>(std::upper_bound(starts, starts + track.blockCount, time) - starts);
+    return upper == 0 ? 0 : upper - 1;
+}
+
+template <int Components>
+void AnimationClip::gather(const Channel channel, const std::size_t joint, const float time, std::uint32_t* hints,
+                           float (*from)[4], float (*to)[4], float* alpha) const
+{
+    constexpr int KEYS = keysPerBlock<Components>();
+    constexpr int STRIDE = Components + 1;
+
+    for (int lane = 0; lane < WIDTH; ++lane)
+    {
+        const std::size_t index = channel * paddedJoints + joint + lane;
+        const Track& track = tracks[index];
+        hints[index] = locate(track, hints[index], time);
+        const float* data = blocks[track.firstBlock + hints[index]].data;
+
+        int k = 0;
+        while (k + 2 < KEYS && data[(k + 1) * STRIDE] < time) { ++k; }
+        const float* a = data + k * STRIDE;
+        const float* b = a + STRIDE;
+
+        const float span = b[0] - a[0];
+        alpha[lane] = span > 0.0f ? std::clamp((time - a[0]) / span, 0.0f, 1.0f) : 0.0f;
+        for (int c = 0; c < Components; ++c)
+        {
+            from[c][lane] = a[c + 1];
+            to[c][lane] = b[c + 1];
+        }
+    }
+}
+
+void AnimationClip::sample(const float time, SamplingCursor& cursor, PoseStreams& pose) const
+{
+    if (cursor.blocks.size() != tracks.size()) { cursor.blocks.assign(tracks.size(), 0); }
+    if (pose.rotationW.size() < paddedJoints) { pose.resize(paddedJoints); }
+
+    std::uint32_t* hints = cursor.blocks.data();
+    alignas(16) float from[4][4];
+    alignas(16) float to[4][4];
+    alignas(16) float alpha[4];
+
+    for (std::size_t j = 0; j < paddedJoints; j += WIDTH)
+    {
+        gather<3>(TRANSLATION, j, time, hints, from, to, alpha);
+        Float4 t = Float4::load(alpha);
+        lerp(Float4::load(from[0]), Float4::load(to[0]), t).store(&pose.translationX[j]);
+        lerp(Float4::load(from[1]), Float4::load(to[1]), t).store(&pose.translationY[j]);
+        lerp(Float4::load(from[2]), Float4::load(to[2]), t).store(&pose.translationZ[j]);
+
+        gather<3>(SCALE, j, time, hints, from, to, alpha);
+        t = Float4::load(alpha);
+        lerp(Float4::load(from[0]), Float4::load(to[0]), t).store(&pose.scaleX[j]);
+        lerp(Float4::load(from[1]), Float4::load(to[1]), t).store(&pose.scaleY[j]);
+        lerp(Float4::load(from[2]), Float4::load(to[2]), t).store(&pose.scaleZ[j]);
+
+        gather<4>(ROTATION, j, time, hints, from, to, alpha);
+        t = Float4::load(alpha);
+        const Float4 ax = Float4::load(from[0]), ay = Float4::load(from[1]), az = Float4::load(from[2]), aw = Float4::load(from[3]);
+        Float4 bx = Float4::load(to[0]), by = Float4::load(to[1]), bz = Float4::load(to[2]), bw = Float4::load(to[3]);
+
+        // negate the target where it lies in the opposite hemisphere to take the short arc
+        const Float4 flip = multiplyAdd(ax, bx, multiplyAdd(ay, by, multiplyAdd(az, bz, aw * bw))) & Float4(-0.0f);
+        bx = bx ^ flip; by = by ^ flip; bz = bz ^ flip; bw = bw ^ flip;
+
+        const Float4 qx = lerp(ax, bx, t), qy = lerp(ay, by, t), qz = lerp(az, bz, t), qw = lerp(aw, bw, t);
+        const Float4 scale = rsqrt(multiplyAdd(qx, qx, multiplyAdd(qy, qy, multiplyAdd(qz, qz, qw * qw))));
+        (qx * scale).store(&pose.rotationX[j]);
+        (qy * scale).store(&pose.rotationY[j]);
+        (qz * scale).store(&pose.rotationZ[j]);
+        (qw * scale).store(&pose.rotationW[j]);
+    }
+}
+
+void Kronos::CoreSystems::Animation::sampleBatch(const SampleJob* jobs, const std::size_t count)
+{
+    Parallel::parallelFor(count, 4, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { jobs[i].clip->sample(jobs[i].time, *jobs[i].cursor, *jobs[i].pose); }
+    });
+}
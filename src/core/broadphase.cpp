@@ -0,0 +1,194 @@
+#include "broadphase.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Collision;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Geometry::AABB;
+
+namespace
+{
+    constexpr std::size_t SWEEP_GRAIN = 256;
+
+    std::uint64_t pairKey(const std::uint32_t a, const std::uint32_t b)
+    {
+        return a < b ? (static_cast<std::uint64_t>(a) << 32) | b : (static_cast<std::uint64_t>(b) << 32) | a;
+    }
+}
+
+SweepAndPrune::SweepAndPrune(const SweepAxis axis) : mode(axis), axis(axis == SweepAxis::Automatic ? 0 : static_cast<int>(axis)) {}
+
+std::uint32_t SweepAndPrune::add(const AABB& bounds, const std::uint32_t userData)
+{
+    std::uint32_t id;
+    if (!freeList.empty()) { id = freeList.back(); freeList.pop_back(); }
+    else { id = static_cast<std::uint32_t>(proxies.size()); proxies.emplace_back(); }
+
+    proxies[id] = {bounds, userData, true};
+    order.push_back({bounds.min[axis], id});
+    ++addedSinceUpdate;
+    return id;
+}
+
+void SweepAndPrune::remove(const std::uint32_t proxy)
+{
+    proxies[proxy].alive = false;
+    pendingFree.push_back(proxy);
+    orderDirty = true;
+}
+
+void SweepAndPrune::move(const std::uint32_t proxy, const AABB& bounds)
+{
+    proxies[proxy].bounds = bounds;
+}
+
+int SweepAndPrune::chooseAxis() const
+{
+    // removed proxies stay in the order until the next sort
+    double sum[3] = {0.0, 0.0, 0.0};
+    double sumSquared[3] = {0.0, 0.0, 0.0};
+    std::size_t live = 0;
+    for (const Endpoint& e : order)
+    {
+        if (!proxies[e.proxy].alive) { continue; }
+        const Math::Vector3 c = proxies[e.proxy].bounds.center();
+        for (int k = 0; k < 3; ++k) { sum[k] += c[k]; sumSquared[k] += static_cast<double>(c[k]) * c[k]; }
+        ++live;
+    }
+    if (live == 0) { return axis; }
+
+    double variance[3];
+    const double n = static_cast<double>(live);
+    for (int k = 0; k < 3; ++k) { variance[k] = sumSquared[k] / n - (sum[k] / n) * (sum[k] / n); }
+
+    // hysteresis keeps the axis stable, switching forces a full re-sort
+    const int best = static_cast<int>(std::max_element(variance, variance + 3) - variance);
+    return variance[best] > 1.5 * variance[axis] ? best : axis;
+}
+
+void SweepAndPrune::sortEndpoints(const bool full)
+{
+    if (orderDirty)
+    {
+        std::erase_if(order, [&](const Endpoint& e) { return !proxies[e.proxy].alive; });
+        orderDirty = false;
+    }
+    for (Endpoint& e : order) { e.value = proxies[e.proxy].bounds.min[axis]; }
+
+    if (full)
+    {
+        std::sort(order.begin(), order.end(), [](const Endpoint& a, const Endpoint& b) { return a.value < b.value; });
+        return;
+    }
+
+    // objects barely move between frames, so insertion sort runs in near linear time
+    for (std::size_t i = 1; i < order.size(); ++i)
+    {
+        const Endpoint e = order[i];
+        std::size_t j = i;
+        while (j > 0 && order[j - 1].value > e.value) { order[j] = order[j - 1]; --j; }
+        order[j] = e;
+    }
+}
+
+void SweepAndPrune::gatherSorted()
+{
+    const std::size_t n = order.size();
+    const int b = (axis + 1) % 3;
+    const int c = (axis + 2) % 3;
+    const float inf = std::numeric_limits<float>::infinity();
+
+    for (std::vector<float>* stream : {&minA, &maxA, &minB, &maxB, &minC, &maxC}) { stream->resize(n + WIDTH); }
+    sortedProxy.resize(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const AABB& box = proxies[order[i].proxy].bounds;
+        sortedProxy[i] = order[i].proxy;
+        minA[i] = box.min[axis]; maxA[i] = box.max[axis];
+        minB[i] = box.min[b]; maxB[i] = box.max[b];
+        minC[i] = box.min[c]; maxC[i] = box.max[c];
+    }
+    for (std::size_t i = n; i < n + WIDTH; ++i)
+    {
+        minA[i] = inf; maxA[i] = -inf;
+        minB[i] = inf; maxB[i] = -inf;
+        minC[i] = inf; maxC[i] = -inf;
+    }
+}
+
+void SweepAndPrune::sweep()
+{
+    const std::size_t n = order.size();
+    chunkPairs.resize((n + SWEEP_GRAIN - 1) / SWEEP_GRAIN);
+    for (std::vector<std::uint64_t>& pairs : chunkPairs) { pairs.clear(); }
+
+    Parallel::parallelFor(n, SWEEP_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::vector<std::uint64_t>& local = chunkPairs[begin / SWEEP_GRAIN];
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const Float4 limitA(maxA[i]);
+            const Float4 lowB(minB[i]), highB(maxB[i]);
+            const Float4 lowC(minC[i]), highC(maxC[i]);
+
+            // candidates are contiguous in sweep order; the first one starting past maxA ends the scan
+            for (std::size_t j = i + 1; j < n; j += WIDTH)
+            {
+                const Float4 inA = Float4::load(minA.data() + j) <= limitA;
+                const Float4 overlap = inA
+                    & (Float4::load(minB.data() + j) <= highB) & (Float4::load(maxB.data() + j) >= lowB)
+                    & (Float4::load(minC.data() + j) <= highC) & (Float4::load(maxC.data() + j) >= lowC);
+
+                int hits = moveMask(overlap);
+                while (hits)
+                {
+                    const int lane = std::countr_zero(static_cast<unsigned>(hits));
+                    local.push_back(pairKey(sortedProxy[i], sortedProxy[j + lane]));
+                    hits &= hits - 1;
+                }
+                if (!all(inA)) { break; }
+            }
+        }
+    });
+
+    currentPairs.clear();
+    for (const std::vector<std::uint64_t>& pairs : chunkPairs) { currentPairs.insert(currentPairs.end(), pairs.begin(), pairs.end()); }
+    std::sort(currentPairs.begin(), currentPairs.end());
+}
+
+void SweepAndPrune::update(std::vector<OverlapPair>& added, std::vector<OverlapPair>& removed)
+{
+    bool full = false;
+    if (mode == SweepAxis::Automatic)
+    {
+        const int best = chooseAxis();
+        full = best != axis;
+        axis = best;
+    }
+
+    sortEndpoints(full || addedSinceUpdate * 8 > order.size());
+    addedSinceUpdate = 0;
+    gatherSorted();
+    currentPairs.swap(previousPairs);
+    sweep();
+
+    added.clear();
+    removed.clear();
+    std::size_t p = 0, c = 0;
+    while (p < previousPairs.size() || c < currentPairs.size())
+    {
+        if (c == currentPairs.size() || (p < previousPairs.size() && previousPairs[p] < currentPairs[c])) { removed.push_back(decodePair(previousPairs[p++])); }
+        else if (p == previousPairs.size() || currentPairs[c] < previousPairs[p]) { added.push_back(decodePair(currentPairs[c++])); }
+        else { ++p; ++c; }
+    }
+
+    // ids are recycled only after their removal events have been reported
+    freeList.insert(freeList.end(), pendingFree.begin(), pendingFree.end());
+    pendingFree.clear();
+}
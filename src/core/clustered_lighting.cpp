@@ -0,0 +1,283 @@
+#include "clustered_lighting.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    constexpr std::size_t LIGHT_GRAIN = 1024;
+    constexpr float MIN_NEAR = 1e-4f;
+    constexpr float FAR_RATIO = 1e4f;
+}
+
+LightBounds Kronos::CoreSystems::Rendering::boundPointLight(const Vector3& position, const float radius)
+{
+    return {position, radius};
+}
+
+LightBounds Kronos::CoreSystems::Rendering::boundSpotLight(const Vector3& position, const Vector3& direction, const float range, const float outerAngle)
+{
+    Vector3 axis = direction;
+    axis.normalize();
+    const float cosine = std::cos(outerAngle);
+    // wide cones are bounded by their cap, narrow ones by the sphere through the apex and the cap rim
+    if (outerAngle > M_PI * 0.25f) { return {position + axis * (range * cosine), range * std::sin(outerAngle)}; }
+    const float radius = range / (2.0f * cosine);
+    return {position + axis * radius, radius};
+}
+
+ClusteredLightGrid::ClusteredLightGrid(const Matrix4x4& projection, const ClusterGridDesc& desc) : desc(desc)
+{
+    this->desc.tilesX = std::max(this->desc.tilesX, 1u);
+    this->desc.tilesY = std::max(this->desc.tilesY, 1u);
+    this->desc.slices = std::max(this->desc.slices, 1u);
+    setProjection(projection);
+}
+
+void ClusteredLightGrid::setProjection(const Matrix4x4& p)
+{
+    const std::uint32_t tx = desc.tilesX, ty = desc.tilesY, slices = desc.slices;
+    scaleX = p.m00;
+    offsetX = p.m02;
+    scaleY = p.m11;
+    offsetY = p.m12;
+
+    // clip z = m22 z + m23 and w = -z put the near and far planes at m23 / (m22 -+ 1)
+    nearPlane = desc.nearZ > 0.0f ? desc.nearZ : p.m23 / (p.m22 - 1.0f);
+    farPlane = desc.farZ > 0.0f ? desc.farZ : p.m23 / (p.m22 + 1.0f);
+    if (!(nearPlane >= MIN_NEAR)) { nearPlane = MIN_NEAR; }
+    if (!(farPlane > nearPlane) || !std::isfinite(farPlane)) { farPlane = nearPlane * FAR_RATIO; }
+
+    sliceDepth.resize(slices + 1);
+    for (std::uint32_t k = 0; k <= slices; ++k) { sliceDepth[k] = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(k) / static_cast<float>(slices)); }
+    sliceDepth[slices] = farPlane;
+
+    // x / depth and y / depth of the tile boundaries; rows run from the top of the screen down
+    std::vector<float> slopeX(tx + 1), slopeY(ty + 1);
+    for (std::uint32_t i = 0; i <= tx; ++i) { slopeX[i] = (2.0f * static_cast<float>(i) / static_cast<float>(tx) - 1.0f + offsetX) / scaleX; }
+    for (std::uint32_t j = 0; j <= ty; ++j) { slopeY[j] = (1.0f - 2.0f * static_cast<float>(j) / static_cast<float>(ty) + offsetY) / scaleY; }
+
+    paddedColumns = roundUpToWidth(tx);
+    columnMin.assign(slices * paddedColumns, INFINITY);
+    columnMax.assign(slices * paddedColumns, -INFINITY);
+    rowMin.resize(slices * ty);
+    rowMax.resize(slices * ty);
+    for (std::uint32_t k = 0; k < slices; ++k)
+    {
+        const float dn = sliceDepth[k], df = sliceDepth[k + 1];
+        for (std::uint32_t i = 0; i < tx; ++i)
+        {
+            const float left = std::min(slopeX[i], slopeX[i + 1]), right = std::max(slopeX[i], slopeX[i + 1]);
+            columnMin[k * paddedColumns + i] = std::min(left * dn, left * df);
+            columnMax[k * paddedColumns + i] = std::max(right * dn, right * df);
+        }
+        for (std::uint32_t j = 0; j < ty; ++j)
+        {
+            const float bottom = std::min(slopeY[j], slopeY[j + 1]), top = std::max(slopeY[j], slopeY[j + 1]);
+            rowMin[k * ty + j] = std::min(bottom * dn, bottom * df);
+            rowMax[k * ty + j] = std::max(top * dn, top * df);
+        }
+    }
+
+    ranges.assign(static_cast<std::size_t>(tx) * ty * slices, {0, 0});
+    indices.clear();
+    bins.resize(slices);
+    for (SliceBins& b : bins) { b.clusterCounts.resize(static_cast<std::size_t>(tx) * ty); }
+}
+
+std::uint32_t ClusteredLightGrid::sliceOf(const float viewDepth) const
+{
+    return static_cast<std::uint32_t>(std::upper_bound(sliceDepth.begin() + 1, sliceDepth.end() - 1, viewDepth) - (sliceDepth.begin() + 1));
+}
+
+AABB ClusteredLightGrid::clusterBounds(const std::size_t cluster) const
+{
+    const std::size_t tileX = cluster % desc.tilesX, tileY = cluster / desc.tilesX % desc.tilesY, slice = cluster / desc.tilesX / desc.tilesY;
+    return {{columnMin[slice * paddedColumns + tileX], rowMin[slice * desc.tilesY + tileY], -sliceDepth[slice + 1]},
+            {columnMax[slice * paddedColumns + tileX], rowMax[slice * desc.tilesY + tileY], -sliceDepth[slice]}};
+}
+
+void ClusteredLightGrid::assign(const LightBounds* lights, const std::size_t n, const Matrix4x4& view)
+{
+    const std::size_t padded = roundUpToWidth(n);
+    for (std::vector<float>* stream : {&lightX, &lightY, &lightZ, &lightRadius}) { stream->resize(padded); }
+    firstSlice.resize(padded);
+    lastSlice.resize(padded);
+
+    const Float4 r0(view.m00), r1(view.m01), r2(view.m02), r3(view.m03);
+    const Float4 u0(view.m10), u1(view.m11), u2(view.m12), u3(view.m13);
+    const Float4 f0(view.m20), f1(view.m21), f2(view.m22), f3(view.m23);
+    const Float4 nearDepth(nearPlane), farDepth(farPlane);
+    Parallel::parallelFor(padded / WIDTH, LIGHT_GRAIN / WIDTH, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t g = begin; g < end; ++g)
+        {
+            // four AoS spheres become SoA centre and radius registers through a 4x4 transpose
+            const std::size_t i = g * WIDTH;
+            const auto sphere = [&](const std::size_t k) { return k < n ? Float4::load(&lights[k].centre.x) : Float4(0.0f); };
+            Float4 x = sphere(i), y = sphere(i + 1), z = sphere(i + 2), radius = sphere(i + 3);
+            transpose(x, y, z, radius);
+            const Float4 vz = multiplyAdd(f0, x, multiplyAdd(f1, y, multiplyAdd(f2, z, f3)));
+            multiplyAdd(r0, x, multiplyAdd(r1, y, multiplyAdd(r2, z, r3))).store(lightX.data() + i);
+            multiplyAdd(u0, x, multiplyAdd(u1, y, multiplyAdd(u2, z, u3))).store(lightY.data() + i);
+            vz.store(lightZ.data() + i);
+            radius.store(lightRadius.data() + i);
+
+            // a slice index is the number of inner boundaries at or below the depth
+            const Float4 low = -vz - radius, high = -vz + radius;
+            Int4 first(0), last(0);
+            for (std::uint32_t k = 1; k < desc.slices; ++k)
+            {
+                const Float4 split(sliceDepth[k]);
+                first = first - asInt(split <= low);
+                last = last - asInt(split <= high);
+            }
+            const Int4 touches = asInt((radius > Float4(0.0f)) & (high >= nearDepth) & (low <= farDepth));
+            select(touches, first, Int4(1)).store(firstSlice.data() + i);
+            select(touches, last, Int4(0)).store(lastSlice.data() + i);
+        }
+    });
+
+    // lights of each slice in ascending order
+    sliceLightOffsets.assign(desc.slices + 1, 0);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        for (std::uint32_t k = firstSlice[i]; k <= lastSlice[i]; ++k) { ++sliceLightOffsets[k + 1]; }
+    }
+    std::partial_sum(sliceLightOffsets.begin(), sliceLightOffsets.end(), sliceLightOffsets.begin());
+    sliceLights.resize(sliceLightOffsets.back());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        for (std::uint32_t k = firstSlice[i]; k <= lastSlice[i]; ++k) { sliceLights[sliceLightOffsets[k]++] = static_cast<std::uint32_t>(i); }
+    }
+    // filling advanced every offset to the start of the next slice
+    std::copy_backward(sliceLightOffsets.begin(), sliceLightOffsets.end() - 1, sliceLightOffsets.end());
+    sliceLightOffsets[0] = 0;
+
+    Parallel::parallelFor(desc.slices, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t slice = begin; slice < end; ++slice) { assignSlice(static_cast<std::uint32_t>(slice)); }
+    });
+
+    // slices were listed independently; lay them out back to back
+    std::size_t total = 0;
+    std::vector<std::size_t> sliceOffsets(desc.slices);
+    for (std::uint32_t slice = 0; slice < desc.slices; ++slice)
+    {
+        sliceOffsets[slice] = total;
+        total += bins[slice].sorted.size();
+    }
+    indices.resize(total);
+    const std::size_t sliceClusters = static_cast<std::size_t>(desc.tilesX) * desc.tilesY;
+    Parallel::parallelFor(desc.slices, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t slice = begin; slice < end; ++slice)
+        {
+            const std::vector<std::uint32_t>& sorted = bins[slice].sorted;
+            std::copy(sorted.begin(), sorted.end(), indices.begin() + sliceOffsets[slice]);
+            for (std::size_t c = slice * sliceClusters; c < (slice + 1) * sliceClusters; ++c) { ranges[c].offset += static_cast<std::uint32_t>(sliceOffsets[slice]); }
+        }
+    });
+}
+
+void ClusteredLightGrid::assignSlice(const std::uint32_t slice)
+{
+    const std::uint32_t tx = desc.tilesX, ty = desc.tilesY;
+    SliceBins& b = bins[slice];
+    b.hitLights.clear();
+    b.hitClusters.clear();
+    std::fill(b.clusterCounts.begin(), b.clusterCounts.end(), 0u);
+
+    const float dn = sliceDepth[slice], df = sliceDepth[slice + 1];
+    const float* cMin = columnMin.data() + slice * paddedColumns;
+    const float* cMax = columnMax.data() + slice * paddedColumns;
+    const float* rMin = rowMin.data() + slice * ty;
+    const float* rMax = rowMax.data() + slice * ty;
+    const Float4 zero(0.0f), one(1.0f), half(0.5f), sliceNear(dn), sliceFar(df);
+    const Float4 columnCells(static_cast<float>(tx)), rowCells(static_cast<float>(ty));
+    const Float4 lastColumn(static_cast<float>(tx - 1)), lastRow(static_cast<float>(ty - 1));
+    const auto toNdc = [](const Float4& v, const Float4& depthIfNegative, const Float4& depthIfPositive, const float scale, const float offset)
+    {
+        return Float4(scale) * v / select(v >= Float4(0.0f), depthIfPositive, depthIfNegative) - Float4(offset);
+    };
+
+    const std::uint32_t* lights = sliceLights.data() + sliceLightOffsets[slice];
+    const std::uint32_t count = sliceLightOffsets[slice + 1] - sliceLightOffsets[slice];
+    for (std::uint32_t k = 0; k < count; k += WIDTH)
+    {
+        // four lights at a time: the part of the slab each sphere reaches and its candidate columns and rows
+        std::uint32_t light[WIDTH];
+        float gathered[4][WIDTH];
+        for (std::uint32_t lane = 0; lane < WIDTH; ++lane)
+        {
+            light[lane] = lights[std::min(k + lane, count - 1)];
+            gathered[0][lane] = lightX[light[lane]];
+            gathered[1][lane] = lightY[light[lane]];
+            gathered[2][lane] = -lightZ[light[lane]];
+            gathered[3][lane] = k + lane < count ? lightRadius[light[lane]] : -1.0f;
+        }
+        const Float4 cx = Float4::load(gathered[0]), cy = Float4::load(gathered[1]), depth = Float4::load(gathered[2]), r = Float4::load(gathered[3]);
+        const Float4 dz = max(max(sliceNear - depth, depth - sliceFar), zero);
+        const Float4 slab = r * r - dz * dz;
+
+        // the sphere's x / depth and y / depth extents over the depths it spans bound the froxels it reaches,
+        // so clusters whose box but not froxel the sphere touches drop out
+        const Float4 d0 = max(sliceNear, depth - r), d1 = min(sliceFar, depth + r);
+        const Float4 lowX = toNdc(cx - r, d0, d1, scaleX, offsetX), highX = toNdc(cx + r, d1, d0, scaleX, offsetX);
+        const Float4 lowY = toNdc(cy - r, d0, d1, scaleY, offsetY), highY = toNdc(cy + r, d1, d0, scaleY, offsetY);
+        const int valid = moveMask((r >= zero) & (slab >= zero) & (highX >= -one) & (lowX <= one) & (highY >= -one) & (lowY <= one));
+        if (valid == 0) { continue; }
+        const auto cell = [&](const Float4& position, const Float4& cells, const Float4& last) { return truncateToInt(floor(min(max(position * cells, zero), last))); };
+        const Int4 column0 = cell((lowX + one) * half, columnCells, lastColumn), column1 = cell((highX + one) * half, columnCells, lastColumn);
+        const Int4 row0 = cell((one - highY) * half, rowCells, lastRow), row1 = cell((one - lowY) * half, rowCells, lastRow);
+
+        for (std::uint32_t lane = 0; lane < WIDTH; ++lane)
+        {
+            if (!(valid >> lane & 1)) { continue; }
+            const float centreX = cx[lane], centreY = cy[lane], reach = slab[lane];
+            const Float4 x(centreX);
+            for (std::int32_t row = row0[lane]; row <= row1[lane]; ++row)
+            {
+                const float dy = std::max({rMin[row] - centreY, centreY - rMax[row], 0.0f});
+                const float remaining = reach - dy * dy;
+                if (remaining < 0.0f) { continue; }
+                for (std::int32_t column = column0[lane] / WIDTH * WIDTH; column <= column1[lane]; column += WIDTH)
+                {
+                    // padding columns have empty bounds and never hit
+                    const Float4 dx = max(max(Float4::load(cMin + column) - x, x - Float4::load(cMax + column)), zero);
+                    for (unsigned hits = static_cast<unsigned>(moveMask(dx * dx <= Float4(remaining))); hits != 0; hits &= hits - 1)
+                    {
+                        const std::uint32_t cluster = static_cast<std::uint32_t>(row) * tx + static_cast<std::uint32_t>(column) + static_cast<std::uint32_t>(std::countr_zero(hits));
+                        b.hitLights.push_back(light[lane]);
+                        b.hitClusters.push_back(cluster);
+                        ++b.clusterCounts[cluster];
+                    }
+                }
+            }
+        }
+    }
+
+    // counting sort by cluster keeps each cluster's lights in ascending order
+    ClusterLightRange* sliceRanges = ranges.data() + static_cast<std::size_t>(slice) * tx * ty;
+    std::uint32_t offset = 0;
+    for (std::size_t c = 0; c < b.clusterCounts.size(); ++c)
+    {
+        sliceRanges[c] = {offset, b.clusterCounts[c]};
+        offset += b.clusterCounts[c];
+        b.clusterCounts[c] = sliceRanges[c].offset;
+    }
+    b.sorted.resize(b.hitLights.size());
+    for (std::size_t h = 0; h < b.hitLights.size(); ++h) { b.sorted[b.clusterCounts[b.hitClusters[h]]++] = b.hitLights[h]; }
+}
@@ -0,0 +1,286 @@
+#include "compression.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Compression;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr float SQRT_HALF = 0.70710678f;
+    constexpr float LEVELS_15 = 32767.0f;
+    constexpr float LEVELS_10 = 1023.0f;
+    constexpr float LEVELS_16 = 65535.0f;
+    constexpr std::size_t DECODE_GRAIN = 8192;
+
+    struct SmallestThree
+    {
+        std::uint32_t largest;
+        float rest[3];
+    };
+
+    SmallestThree smallestThree(const Quaternion& q)
+    {
+        const float invLength = 1.0f / std::max(q.magnitude(), 1e-20f);
+        const float c[4] = {q.x * invLength, q.y * invLength, q.z * invLength, q.w * invLength};
+
+        std::uint32_t largest = 0;
+        for (std::uint32_t i = 1; i < 4; ++i) { if (std::fabs(c[i]) > std::fabs(c[largest])) { largest = i; } }
+
+        // q and -q are the same rotation, so the dropped component is made positive
+        const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+        SmallestThree result {largest, {}};
+        for (std::uint32_t i = 0, j = 0; i < 4; ++i) { if (i != largest) { result.rest[j++] = c[i] * sign; } }
+        return result;
+    }
+
+    std::uint32_t quantizeUnit(const float v, const float levels)
+    {
+        return static_cast<std::uint32_t>(std::clamp(v * SQRT_HALF + 0.5f, 0.0f, 1.0f) * levels + 0.5f);
+    }
+
+    float dequantizeUnit(const std::uint32_t q, const float levels) { return (static_cast<float>(q) * (1.0f / levels) - 0.5f) * (2.0f * SQRT_HALF); }
+
+    Quaternion rebuild(const std::uint32_t largest, const float a, const float b, const float c)
+    {
+        const float l = std::sqrt(std::max(0.0f, 1.0f - a * a - b * b - c * c));
+        switch (largest)
+        {
+            case 0: return {l, a, b, c};
+            case 1: return {a, l, b, c};
+            case 2: return {a, b, l, c};
+            default: return {a, b, c, l};
+        }
+    }
+
+    // places the rebuilt component into the lane's dropped slot and shifts the rest around it
+    void rebuild(const Int4& largest, const Float4& a, const Float4& b, const Float4& c, float* x, float* y, float* z, float* w)
+    {
+        const Float4 l = sqrt(max(Float4(0.0f), Float4(1.0f) - a * a - b * b - c * c));
+        const Float4 is0 = asFloat(largest == Int4(0));
+        const Float4 is1 = asFloat(largest == Int4(1));
+        const Float4 is2 = asFloat(largest == Int4(2));
+        const Float4 is3 = asFloat(largest == Int4(3));
+        select(is0, l, a).store(x);
+        select(is0, a, select(is1, l, b)).store(y);
+        select(is3, c, select(is2, l, b)).store(z);
+        select(is3, l, c).store(w);
+    }
+
+    Float4 dequantizeLanes(const Int4& q, const float levels)
+    {
+        return (toFloat(q) * Float4(1.0f / levels) - Float4(0.5f)) * Float4(2.0f * SQRT_HALF);
+    }
+
+    double angleBetween(const Quaternion& a, const Quaternion& b)
+    {
+        // 2 atan2(|a - b|, |a + b|) stays accurate for the tiny angles acos loses to rounding
+        const double sign = static_cast<double>(a.x) * b.x + static_cast<double>(a.y) * b.y + static_cast<double>(a.z) * b.z + static_cast<double>(a.w) * b.w < 0.0 ? -1.0 : 1.0;
+        const double dx = a.x - sign * b.x, dy = a.y - sign * b.y, dz = a.z - sign * b.z, dw = a.w - sign * b.w;
+        const double sx = a.x + sign * b.x, sy = a.y + sign * b.y, sz = a.z + sign * b.z, sw = a.w + sign * b.w;
+        return 2.0 * std::atan2(std::sqrt(dx * dx + dy * dy + dz * dz + dw * dw), std::sqrt(sx * sx + sy * sy + sz * sz + sw * sw));
+    }
+
+    template <typename Packed>
+    ErrorStats measureRotations(const Quaternion* q, const std::size_t n, const Packed* packed)
+    {
+        ErrorStats stats;
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double error = angleBetween(q[i], unpackQuaternion(packed[i]));
+            stats.maximum = std::max(stats.maximum, static_cast<float>(error));
+            sum += error;
+        }
+        stats.mean = n > 0 ? static_cast<float>(sum / static_cast<double>(n)) : 0.0f;
+        return stats;
+    }
+
+    float rotationBound(const float levels)
+    {
+        // each stored component is off by at most half a step; the rebuilt one by at most three times that
+        // because it is the largest (>= 1/2), and the angle is twice the quaternion distance to first order
+        const float halfStep = SQRT_HALF / levels;
+        return 2.0f * std::sqrt(12.0f) * halfStep;
+    }
+}
+
+PackedQuaternion48 Kronos::CoreSystems::Compression::packQuaternion48(const Quaternion& q)
+{
+    const SmallestThree s = smallestThree(q);
+    PackedQuaternion48 p;
+    p.data[0] = static_cast<std::uint16_t>(quantizeUnit(s.rest[0], LEVELS_15) | (s.largest >> 1) << 15);
+    p.data[1] = static_cast<std::uint16_t>(quantizeUnit(s.rest[1], LEVELS_15) | (s.largest & 1) << 15);
+    p.data[2] = static_cast<std::uint16_t>(quantizeUnit(s.rest[2], LEVELS_15));
+    return p;
+}
+
+PackedQuaternion32 Kronos::CoreSystems::Compression::packQuaternion32(const Quaternion& q)
+{
+    const SmallestThree s = smallestThree(q);
+    return {s.largest << 30 | quantizeUnit(s.rest[0], LEVELS_10) << 20 | quantizeUnit(s.rest[1], LEVELS_10) << 10 | quantizeUnit(s.rest[2], LEVELS_10)};
+}
+
+Quaternion Kronos::CoreSystems::Compression::unpackQuaternion(const PackedQuaternion48& p)
+{
+    const std::uint32_t largest = (p.data[0] >> 15) << 1 | p.data[1] >> 15;
+    return rebuild(largest, dequantizeUnit(p.data[0] & 0x7FFF, LEVELS_15), dequantizeUnit(p.data[1] & 0x7FFF, LEVELS_15), dequantizeUnit(p.data[2] & 0x7FFF, LEVELS_15));
+}
+
+Quaternion Kronos::CoreSystems::Compression::unpackQuaternion(const PackedQuaternion32& p)
+{
+    return rebuild(p.bits >> 30, dequantizeUnit(p.bits >> 20 & 0x3FF, LEVELS_10), dequantizeUnit(p.bits >> 10 & 0x3FF, LEVELS_10), dequantizeUnit(p.bits & 0x3FF, LEVELS_10));
+}
+
+PackedVector3 Kronos::CoreSystems::Compression::packVector3(const Vector3& v, const AABB& range)
+{
+    const Vector3 size = range.max - range.min;
+    const auto quantize = [](const float value, const float min, const float extent)
+    {
+        const float t = extent > 0.0f ? (value - min) / extent : 0.0f;
+        return static_cast<std::uint16_t>(std::clamp(t, 0.0f, 1.0f) * LEVELS_16 + 0.5f);
+    };
+    return {quantize(v.x, range.min.x, size.x), quantize(v.y, range.min.y, size.y), quantize(v.z, range.min.z, size.z)};
+}
+
+Vector3 Kronos::CoreSystems::Compression::unpackVector3(const PackedVector3& p, const AABB& range)
+{
+    const Vector3 step = (range.max - range.min) * (1.0f / LEVELS_16);
+    return {range.min.x + p.x * step.x, range.min.y + p.y * step.y, range.min.z + p.z * step.z};
+}
+
+void Kronos::CoreSystems::Compression::packQuaternions(const Quaternion* q, const std::size_t n, PackedQuaternion48* out)
+{
+    Parallel::parallelFor(n, DECODE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { out[i] = packQuaternion48(q[i]); }
+    });
+}
+
+void Kronos::CoreSystems::Compression::packQuaternions(const Quaternion* q, const std::size_t n, PackedQuaternion32* out)
+{
+    Parallel::parallelFor(n, DECODE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { out[i] = packQuaternion32(q[i]); }
+    });
+}
+
+void Kronos::CoreSystems::Compression::packVectors(const Vector3* v, const std::size_t n, const AABB& range, PackedVector3* out)
+{
+    Parallel::parallelFor(n, DECODE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { out[i] = packVector3(v[i], range); }
+    });
+}
+
+void Kronos::CoreSystems::Compression::unpackQuaternions(const PackedQuaternion48* p, const std::size_t n, float* x, float* y, float* z, float* w)
+{
+    Parallel::parallelFor(n, DECODE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            const Int4 d0(p[i].data[0], p[i + 1].data[0], p[i + 2].data[0], p[i + 3].data[0]);
+            const Int4 d1(p[i].data[1], p[i + 1].data[1], p[i + 2].data[1], p[i + 3].data[1]);
+            const Int4 d2(p[i].data[2], p[i + 1].data[2], p[i + 2].data[2], p[i + 3].data[2]);
+            const Int4 mask(0x7FFF);
+            const Int4 largest = (d0 >> 15) << 1 | d1 >> 15;
+            rebuild(largest, dequantizeLanes(d0 & mask, LEVELS_15), dequantizeLanes(d1 & mask, LEVELS_15), dequantizeLanes(d2 & mask, LEVELS_15),
+                    x + i, y + i, z + i, w + i);
+        }
+        for (; i < end; ++i)
+        {
+            const Quaternion q = unpackQuaternion(p[i]);
+            x[i] = q.x; y[i] = q.y; z[i] = q.z; w[i] = q.w;
+        }
+    });
+}
+
+void Kronos::CoreSystems::Compression::unpackQuaternions(const PackedQuaternion32* p, const std::size_t n, float* x, float* y, float* z, float* w)
+{
+    Parallel::parallelFor(n, DECODE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            const Int4 bits = Int4::load(&p[i].bits);
+            const Int4 mask(0x3FF);
+            rebuild(bits >> 30, dequantizeLanes(bits >> 20 & mask, LEVELS_10), dequantizeLanes(bits >> 10 & mask, LEVELS_10), dequantizeLanes(bits & mask, LEVELS_10),
+                    x + i, y + i, z + i, w + i);
+        }
+        for (; i < end; ++i)
+        {
+            const Quaternion q = unpackQuaternion(p[i]);
+            x[i] = q.x; y[i] = q.y; z[i] = q.z; w[i] = q.w;
+        }
+    });
+}
+
+void Kronos::CoreSystems::Compression::unpackVectors(const PackedVector3* p, const std::size_t n, const AABB& range, float* x, float* y, float* z)
+{
+    const Vector3 step = (range.max - range.min) * (1.0f / LEVELS_16);
+    const Float4 minX(range.min.x), minY(range.min.y), minZ(range.min.z);
+    const Float4 stepX(step.x), stepY(step.y), stepZ(step.z);
+
+    Parallel::parallelFor(n, DECODE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            multiplyAdd(toFloat(Int4(p[i].x, p[i + 1].x, p[i + 2].x, p[i + 3].x)), stepX, minX).store(x + i);
+            multiplyAdd(toFloat(Int4(p[i].y, p[i + 1].y, p[i + 2].y, p[i + 3].y)), stepY, minY).store(y + i);
+            multiplyAdd(toFloat(Int4(p[i].z, p[i + 1].z, p[i + 2].z, p[i + 3].z)), stepZ, minZ).store(z + i);
+        }
+        for (; i < end; ++i)
+        {
+            const Vector3 v = unpackVector3(p[i], range);
+            x[i] = v.x; y[i] = v.y; z[i] = v.z;
+        }
+    });
+}
+
+ErrorStats Kronos::CoreSystems::Compression::measureError(const Quaternion* q, const std::size_t n, const PackedQuaternion48* packed)
+{
+    return measureRotations(q, n, packed);
+}
+
+ErrorStats Kronos::CoreSystems::Compression::measureError(const Quaternion* q, const std::size_t n, const PackedQuaternion32* packed)
+{
+    return measureRotations(q, n, packed);
+}
+
+ErrorStats Kronos::CoreSystems::Compression::measureError(const Vector3* v, const std::size_t n, const PackedVector3* packed, const AABB& range)
+{
+    ErrorStats stats;
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const float error = (v[i] - unpackVector3(packed[i], range)).magnitude();
+        stats.maximum = std::max(stats.maximum, error);
+        sum += error;
+    }
+    stats.mean = n > 0 ? static_cast<float>(sum / static_cast<double>(n)) : 0.0f;
+    return stats;
+}
+
+float Kronos::CoreSystems::Compression::rotationErrorBound48()
+{
+    return rotationBound(LEVELS_15);
+}
+
+float Kronos::CoreSystems::Compression::rotationErrorBound32()
+{
+    return rotationBound(LEVELS_10);
+}
+
+Vector3 Kronos::CoreSystems::Compression::vectorErrorBound(const AABB& range)
+{
+    return (range.max - range.min) * (0.5f / LEVELS_16);
+}
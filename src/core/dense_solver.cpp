@@ -0,0 +1,239 @@
+#include "dense_solver.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::LinearAlgebra;
+using namespace Kronos::CoreSystems::Simd;
+
+namespace
+{
+    constexpr std::size_t BATCH_GRAIN = 256;
+
+    template <int N>
+    struct SystemLanes
+    {
+        Float4 a[N][N];
+        Float4 b[N];
+    };
+
+    template <int N>
+    SystemLanes<N> loadSystems(const MatrixN<N>* a, const VectorN<N>* b, const std::size_t count)
+    {
+        // lanes past count repeat the last system so a partial group stays finite
+        std::size_t lane[WIDTH];
+        for (std::size_t k = 0; k < WIDTH; ++k) { lane[k] = k < count ? k : count - 1; }
+
+        SystemLanes<N> s;
+        for (int i = 0; i < N; ++i)
+        {
+            for (int j = 0; j < N; ++j) { s.a[i][j] = Float4(a[lane[0]].m[i][j], a[lane[1]].m[i][j], a[lane[2]].m[i][j], a[lane[3]].m[i][j]); }
+            s.b[i] = Float4(b[lane[0]].v[i], b[lane[1]].v[i], b[lane[2]].v[i], b[lane[3]].v[i]);
+        }
+        return s;
+    }
+
+    // elimination on the augmented system with per-lane partial pivoting, swapping rows through selects
+    template <int N>
+    Float4 luLanes(SystemLanes<N>& s)
+    {
+        Float4 failed(0.0f);
+        for (int k = 0; k < N; ++k)
+        {
+            Float4 best = abs(s.a[k][k]);
+            Float4 row(static_cast<float>(k));
+            for (int i = k + 1; i < N; ++i)
+            {
+                const Float4 v = abs(s.a[i][k]);
+                const Float4 larger = v > best;
+                best = select(larger, v, best);
+                row = select(larger, Float4(static_cast<float>(i)), row);
+            }
+            const Float4 singular = best == Float4(0.0f);
+            failed = failed | singular;
+
+            for (int i = k + 1; i < N; ++i)
+            {
+                const Float4 swap = row == Float4(static_cast<float>(i));
+                if (!any(swap)) { continue; }
+                for (int j = k; j < N; ++j)
+                {
+                    const Float4 t = s.a[k][j];
+                    s.a[k][j] = select(swap, s.a[i][j], t);
+                    s.a[i][j] = select(swap, t, s.a[i][j]);
+                }
+                const Float4 t = s.b[k];
+                s.b[k] = select(swap, s.b[i], t);
+                s.b[i] = select(swap, t, s.b[i]);
+            }
+
+            const Float4 inv = Float4(1.0f) / select(singular, Float4(1.0f), s.a[k][k]);
+            for (int i = k + 1; i < N; ++i)
+            {
+                const Float4 l = s.a[i][k] * inv;
+                for (int j = k + 1; j < N; ++j) { s.a[i][j] = s.a[i][j] - l * s.a[k][j]; }
+                s.b[i] = s.b[i] - l * s.b[k];
+            }
+        }
+
+        for (int i = N - 1; i >= 0; --i)
+        {
+            Float4 sum = s.b[i];
+            for (int j = i + 1; j < N; ++j) { sum = sum - s.a[i][j] * s.b[j]; }
+            s.b[i] = sum / s.a[i][i];
+        }
+        return failed;
+    }
+
+    template <int N>
+    Float4 choleskyLanes(SystemLanes<N>& s)
+    {
+        Float4 failed(0.0f);
+        for (int j = 0; j < N; ++j)
+        {
+            Float4 d = s.a[j][j];
+            for (int k = 0; k < j; ++k) { d = d - s.a[j][k] * s.a[j][k]; }
+            const Float4 positive = d > Float4(0.0f);
+            failed = failed | andNot(positive, Float4(asFloat(Int4(-1))));
+            const Float4 l = sqrt(select(positive, d, Float4(1.0f)));
+            s.a[j][j] = l;
+
+            const Float4 inv = Float4(1.0f) / l;
+            for (int i = j + 1; i < N; ++i)
+            {
+                Float4 sum = s.a[i][j];
+                for (int k = 0; k < j; ++k) { sum = sum - s.a[i][k] * s.a[j][k]; }
+                s.a[i][j] = sum * inv;
+            }
+        }
+
+        for (int i = 0; i < N; ++i)
+        {
+            for (int j = 0; j < i; ++j) { s.b[i] = s.b[i] - s.a[i][j] * s.b[j]; }
+            s.b[i] = s.b[i] / s.a[i][i];
+        }
+        for (int i = N - 1; i >= 0; --i)
+        {
+            for (int j = i + 1; j < N; ++j) { s.b[i] = s.b[i] - s.a[j][i] * s.b[j]; }
+            s.b[i] = s.b[i] / s.a[i][i];
+        }
+        return failed;
+    }
+
+    template <int N>
+    Float4 ldltLanes(SystemLanes<N>& s)
+    {
+        Float4 failed(0.0f);
+        for (int j = 0; j < N; ++j)
+        {
+            Float4 d = s.a[j][j];
+            for (int k = 0; k < j; ++k) { d = d - s.a[j][k] * s.a[j][k] * s.a[k][k]; }
+            const Float4 singular = d == Float4(0.0f);
+            failed = failed | singular;
+            d = select(singular, Float4(1.0f), d);
+            s.a[j][j] = d;
+
+            const Float4 inv = Float4(1.0f) / d;
+            for (int i = j + 1; i < N; ++i)
+            {
+                Float4 sum = s.a[i][j];
+                for (int k = 0; k < j; ++k) { sum = sum - s.a[i][k] * s.a[j][k] * s.a[k][k]; }
+                s.a[i][j] = sum * inv;
+            }
+        }
+
+        for (int i = 1; i < N; ++i) { for (int j = 0; j < i; ++j) { s.b[i] = s.b[i] - s.a[i][j] * s.b[j]; } }
+        for (int i = 0; i < N; ++i) { s.b[i] = s.b[i] / s.a[i][i]; }
+        for (int i = N - 2; i >= 0; --i) { for (int j = i + 1; j < N; ++j) { s.b[i] = s.b[i] - s.a[j][i] * s.b[j]; } }
+        return failed;
+    }
+}
+
+bool Kronos::CoreSystems::LinearAlgebra::luFactor(DenseMatrix& a, std::vector<int>& pivots)
+{
+    pivots.resize(static_cast<std::size_t>(a.dimension()));
+    return Detail::luFactor<0>(a.data(), a.dimension(), pivots.data());
+}
+
+void Kronos::CoreSystems::LinearAlgebra::luSolve(const DenseMatrix& lu, const std::vector<int>& pivots, float* b)
+{
+    Detail::luSolve<0>(lu.data(), lu.dimension(), pivots.data(), b);
+}
+
+bool Kronos::CoreSystems::LinearAlgebra::choleskyFactor(DenseMatrix& a)
+{
+    return Detail::choleskyFactor<0>(a.data(), a.dimension());
+}
+
+void Kronos::CoreSystems::LinearAlgebra::choleskySolve(const DenseMatrix& l, float* b)
+{
+    Detail::choleskySolve<0>(l.data(), l.dimension(), b);
+}
+
+bool Kronos::CoreSystems::LinearAlgebra::ldltFactor(DenseMatrix& a)
+{
+    return Detail::ldltFactor<0>(a.data(), a.dimension());
+}
+
+void Kronos::CoreSystems::LinearAlgebra::ldltSolve(const DenseMatrix& ld, float* b)
+{
+    Detail::ldltSolve<0>(ld.data(), ld.dimension(), b);
+}
+
+int Kronos::CoreSystems::LinearAlgebra::gaussSeidel(const DenseMatrix& a, const float* b, float* x, const int maxIterations, const float tolerance)
+{
+    return Detail::gaussSeidel<0>(a.data(), a.dimension(), b, x, maxIterations, tolerance);
+}
+
+bool Kronos::CoreSystems::LinearAlgebra::solve(const Factorization kind, DenseMatrix a, float* b)
+{
+    switch (kind)
+    {
+        case Factorization::LU:
+        {
+            std::vector<int> pivots;
+            if (!luFactor(a, pivots)) { return false; }
+            luSolve(a, pivots, b);
+            return true;
+        }
+        case Factorization::Cholesky: if (!choleskyFactor(a)) { return false; } choleskySolve(a, b); return true;
+        default: if (!ldltFactor(a)) { return false; } ldltSolve(a, b); return true;
+    }
+}
+
+template <int N>
+void Kronos::CoreSystems::LinearAlgebra::solveBatch(const Factorization kind, const MatrixN<N>* a, const VectorN<N>* b, const std::size_t count, VectorN<N>* x, bool* solved)
+{
+    Parallel::parallelFor(count, BATCH_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            const std::size_t lanes = std::min<std::size_t>(WIDTH, end - i);
+            SystemLanes<N> s = loadSystems(a + i, b + i, lanes);
+            const Float4 failed = kind == Factorization::LU ? luLanes(s) : kind == Factorization::Cholesky ? choleskyLanes(s) : ldltLanes(s);
+
+            const int failures = moveMask(failed);
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                const int lane = static_cast<int>(k);
+                for (int r = 0; r < N; ++r) { x[i + k].v[r] = s.b[r][lane]; }
+                if (solved) { solved[i + k] = (failures >> lane & 1) == 0; }
+            }
+        }
+    });
+}
+
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<1>(Factorization, const MatrixN<1>*, const VectorN<1>*, std::size_t, VectorN<1>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<2>(Factorization, const MatrixN<2>*, const VectorN<2>*, std::size_t, VectorN<2>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<3>(Factorization, const MatrixN<3>*, const VectorN<3>*, std::size_t, VectorN<3>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<4>(Factorization, const MatrixN<4>*, const VectorN<4>*, std::size_t, VectorN<4>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<5>(Factorization, const MatrixN<5>*, const VectorN<5>*, std::size_t, VectorN<5>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<6>(Factorization, const MatrixN<6>*, const VectorN<6>*, std::size_t, VectorN<6>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<7>(Factorization, const MatrixN<7>*, const VectorN<7>*, std::size_t, VectorN<7>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<8>(Factorization, const MatrixN<8>*, const VectorN<8>*, std::size_t, VectorN<8>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<9>(Factorization, const MatrixN<9>*, const VectorN<9>*, std::size_t, VectorN<9>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<10>(Factorization, const MatrixN<10>*, const VectorN<10>*, std::size_t, VectorN<10>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<11>(Factorization, const MatrixN<11>*, const VectorN<11>*, std::size_t, VectorN<11>*, bool*);
+template void Kronos::CoreSystems::LinearAlgebra::solveBatch<12>(Factorization, const MatrixN<12>*, const VectorN<12>*, std::size_t, VectorN<12>*, bool*);
@@ -0,0 +1,84 @@
+#include "depth_sort.hpp"
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr std::size_t KEY_GRAIN = 16384;
+
+    // maps IEEE floats onto unsigned integers that compare in the same order
+    Int4 sortableKeys(const Float4& depth, const Int4& invert)
+    {
+        const Int4 bits = asInt(depth);
+        const Int4 sign = bits >> 31;
+        const Int4 mask = (Int4(0) - sign) | Int4(static_cast<std::int32_t>(0x80000000u));
+        return bits ^ mask ^ invert;
+    }
+
+    Int4 invertMask(const DepthOrder order) { return Int4(order == DepthOrder::Descending ? -1 : 0); }
+
+    std::uint32_t scalarKey(const Matrix4x4& view, const float x, const float y, const float z, const DepthOrder order)
+    {
+        const std::uint32_t key = floatToSortable(view.m20 * x + view.m21 * y + view.m22 * z + view.m23);
+        return order == DepthOrder::Descending ? ~key : key;
+    }
+}
+
+void Kronos::CoreSystems::Rendering::computeDepthKeys(const Matrix4x4& view, const Vector3* centers, const std::size_t n, const DepthOrder order, std::uint32_t* keys)
+{
+    const Float4 rx(view.m20), ry(view.m21), rz(view.m22), rw(view.m23);
+    const Int4 invert = invertMask(order);
+
+    Parallel::parallelFor(n, KEY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            // four AoS centers become three SoA registers through a 4x4 transpose
+            Float4 a = Float4::load(&centers[i].x);
+            Float4 b = Float4::load(&centers[i + 1].x);
+            Float4 c = Float4::load(&centers[i + 2].x);
+            Float4 d(centers[i + 3].x, centers[i + 3].y, centers[i + 3].z, 0.0f);
+            transpose(a, b, c, d);
+            sortableKeys(multiplyAdd(a, rx, multiplyAdd(b, ry, multiplyAdd(c, rz, rw))), invert).store(keys + i);
+        }
+        for (; i < end; ++i) { keys[i] = scalarKey(view, centers[i].x, centers[i].y, centers[i].z, order); }
+    });
+}
+
+void Kronos::CoreSystems::Rendering::computeDepthKeys(const Matrix4x4& view, const float* x, const float* y, const float* z, const std::size_t n, const DepthOrder order, std::uint32_t* keys)
+{
+    const Float4 rx(view.m20), ry(view.m21), rz(view.m22), rw(view.m23);
+    const Int4 invert = invertMask(order);
+
+    Parallel::parallelFor(n, KEY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            const Float4 depth = multiplyAdd(Float4::load(x + i), rx, multiplyAdd(Float4::load(y + i), ry, multiplyAdd(Float4::load(z + i), rz, rw)));
+            sortableKeys(depth, invert).store(keys + i);
+        }
+        for (; i < end; ++i) { keys[i] = scalarKey(view, x[i], y[i], z[i], order); }
+    });
+}
+
+void DepthSorter::sort(const Matrix4x4& view, const Vector3* centers, const std::size_t n, const DepthOrder order, std::uint32_t* drawIndices)
+{
+    keys.resize(n);
+    computeDepthKeys(view, centers, n, order, keys.data());
+    sorter.sortPermutation(keys.data(), drawIndices, n);
+}
+
+void DepthSorter::sort(const Matrix4x4& view, const float* x, const float* y, const float* z, const std::size_t n, const DepthOrder order, std::uint32_t* drawIndices)
+{
+    keys.resize(n);
+    computeDepthKeys(view, x, y, z, n, order, keys.data());
+    sorter.sortPermutation(keys.data(), drawIndices, n);
+}
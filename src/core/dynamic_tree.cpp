@@ -0,0 +1,319 @@
+#include "dynamic_tree.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "parallel.hpp"
+
+using namespace Kronos::CoreSystems::Spatial;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Geometry::Ray;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // refit fat bounds with more than this times the area of freshly fattened ones are shrunk
+    constexpr float SHRINK_AREA_RATIO = 2.0f;
+
+    bool sameBounds(const AABB& a, const AABB& b)
+    {
+        return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z && a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+    }
+}
+
+DynamicAABBTree::DynamicAABBTree(const float margin, const float displacementMultiplier) : margin(margin), displacementMultiplier(displacementMultiplier) {}
+
+std::int32_t DynamicAABBTree::allocateNode()
+{
+    if (freeList == NULL_NODE)
+    {
+        // grow the pool and thread the new nodes onto the free list
+        const std::int32_t first = static_cast<std::int32_t>(nodes.size());
+        const std::int32_t grown = std::max<std::int32_t>(16, first);
+        nodes.resize(static_cast<std::size_t>(first + grown));
+        tightBounds.resize(nodes.size());
+        for (std::int32_t i = first; i < first + grown - 1; ++i) { nodes[i].parent = i + 1; }
+        nodes[first + grown - 1].parent = NULL_NODE;
+        freeList = first;
+    }
+
+    const std::int32_t node = freeList;
+    freeList = nodes[node].parent;
+    nodes[node] = Node();
+    nodes[node].height = 0;
+    return node;
+}
+
+void DynamicAABBTree::freeNode(const std::int32_t node)
+{
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+std::int32_t DynamicAABBTree::createProxy(const AABB& bounds, const std::uint32_t userData)
+{
+    const std::int32_t proxy = allocateNode();
+    nodes[proxy].bounds = bounds.expanded(margin);
+    nodes[proxy].userData = userData;
+    tightBounds[proxy] = bounds;
+    insertLeaf(proxy);
+    ++leafCount;
+    return proxy;
+}
+
+void DynamicAABBTree::destroyProxy(const std::int32_t proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --leafCount;
+}
+
+bool DynamicAABBTree::moveProxy(const std::int32_t proxy, const AABB& bounds, const Vector3& displacement)
+{
+    tightBounds[proxy] = bounds;
+    if (nodes[proxy].bounds.contains(bounds)) { return false; }
+
+    // fatten by the margin and stretch along the predicted motion so small moves never reinsert
+    AABB fat = bounds.expanded(margin);
+    const Vector3 d = displacement * displacementMultiplier;
+    fat.min += Math::min(d, Vector3::ZERO);
+    fat.max += Math::max(d, Vector3::ZERO);
+
+    removeLeaf(proxy);
+    nodes[proxy].bounds = fat;
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicAABBTree::refitProxy(const std::int32_t proxy, const AABB& bounds)
+{
+    tightBounds[proxy] = bounds;
+    const AABB fat = bounds.expanded(margin);
+    const AABB& current = nodes[proxy].bounds;
+    if (current.contains(bounds) && current.surfaceArea() <= SHRINK_AREA_RATIO * fat.surfaceArea()) { return; }
+
+    // a leaf leaving its parent would only ever stretch the branch, so it is reinserted where it now belongs
+    const std::int32_t parent = nodes[proxy].parent;
+    if (parent != NULL_NODE && !nodes[parent].bounds.contains(fat))
+    {
+        removeLeaf(proxy);
+        nodes[proxy].bounds = fat;
+        insertLeaf(proxy);
+        return;
+    }
+    nodes[proxy].bounds = fat;
+
+    // ancestors take the exact union of their children so they shrink with the leaf
+    for (std::int32_t index = nodes[proxy].parent; index != NULL_NODE; index = nodes[index].parent)
+    {
+        const AABB refit = Geometry::merge(nodes[nodes[index].child1].bounds, nodes[nodes[index].child2].bounds);
+        if (sameBounds(nodes[index].bounds, refit)) { break; }
+        nodes[index].bounds = refit;
+    }
+}
+
+void DynamicAABBTree::insertLeaf(const std::int32_t leaf)
+{
+    if (root == NULL_NODE)
+    {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // descend by the surface area heuristic, the cost of a branch includes the growth it forces on its ancestors
+    const AABB leafBounds = nodes[leaf].bounds;
+    std::int32_t index = root;
+    while (!nodes[index].isLeaf())
+    {
+        const std::int32_t child1 = nodes[index].child1;
+        const std::int32_t child2 = nodes[index].child2;
+
+        const float area = nodes[index].bounds.surfaceArea();
+        const float combinedArea = Geometry::merge(nodes[index].bounds, leafBounds).surfaceArea();
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](const std::int32_t child)
+        {
+            const float merged = Geometry::merge(leafBounds, nodes[child].bounds).surfaceArea();
+            return (nodes[child].isLeaf() ? merged : merged - nodes[child].bounds.surfaceArea()) + inheritanceCost;
+        };
+        const float cost1 = descendCost(child1);
+        const float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) { break; }
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    const std::int32_t sibling = index;
+    const std::int32_t oldParent = nodes[sibling].parent;
+    const std::int32_t newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].bounds = Geometry::merge(leafBounds, nodes[sibling].bounds);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) { root = newParent; }
+    else if (nodes[oldParent].child1 == sibling) { nodes[oldParent].child1 = newParent; }
+    else { nodes[oldParent].child2 = newParent; }
+
+    for (index = nodes[leaf].parent; index != NULL_NODE; index = nodes[index].parent)
+    {
+        index = balance(index);
+        const Node& a = nodes[nodes[index].child1];
+        const Node& b = nodes[nodes[index].child2];
+        nodes[index].height = 1 + std::max(a.height, b.height);
+        nodes[index].bounds = Geometry::merge(a.bounds, b.bounds);
+    }
+}
+
+void DynamicAABBTree::removeLeaf(const std::int32_t leaf)
+{
+    if (leaf == root)
+    {
+        root = NULL_NODE;
+        return;
+    }
+
+    const std::int32_t parent = nodes[leaf].parent;
+    const std::int32_t grandParent = nodes[parent].parent;
+    const std::int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE)
+    {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes[grandParent].child1 == parent) { nodes[grandParent].child1 = sibling; }
+    else { nodes[grandParent].child2 = sibling; }
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    for (std::int32_t index = grandParent; index != NULL_NODE; index = nodes[index].parent)
+    {
+        index = balance(index);
+        const Node& a = nodes[nodes[index].child1];
+        const Node& b = nodes[nodes[index].child2];
+        nodes[index].bounds = Geometry::merge(a.bounds, b.bounds);
+        nodes[index].height = 1 + std::max(a.height, b.height);
+    }
+}
+
+// rotates the taller grandchild up when the subtree heights differ by more than one
+std::int32_t DynamicAABBTree::balance(const std::int32_t iA)
+{
+    Node& a = nodes[iA];
+    if (a.isLeaf() || a.height < 2) { return iA; }
+
+    const std::int32_t iB = a.child1;
+    const std::int32_t iC = a.child2;
+    Node& b = nodes[iB];
+    Node& c = nodes[iC];
+    const std::int32_t difference = c.height - b.height;
+
+    auto rotate = [&](const std::int32_t iUp, const std::int32_t iStay, const bool upIsChild2)
+    {
+        Node& up = nodes[iUp];
+        Node& stay = nodes[iStay];
+        const std::int32_t iF = up.child1;
+        const std::int32_t iG = up.child2;
+        Node& f = nodes[iF];
+        Node& g = nodes[iG];
+
+        up.child1 = iA;
+        up.parent = a.parent;
+        a.parent = iUp;
+
+        if (up.parent == NULL_NODE) { root = iUp; }
+        else if (nodes[up.parent].child1 == iA) { nodes[up.parent].child1 = iUp; }
+        else { nodes[up.parent].child2 = iUp; }
+
+        const bool keepG = f.height > g.height;
+        const std::int32_t iKeep = keepG ? iF : iG;
+        const std::int32_t iMove = keepG ? iG : iF;
+        Node& kept = nodes[iKeep];
+        Node& moved = nodes[iMove];
+
+        up.child2 = iKeep;
+        if (upIsChild2) { a.child2 = iMove; } else { a.child1 = iMove; }
+        moved.parent = iA;
+        a.bounds = Geometry::merge(stay.bounds, moved.bounds);
+        up.bounds = Geometry::merge(a.bounds, kept.bounds);
+        a.height = 1 + std::max(stay.height, moved.height);
+        up.height = 1 + std::max(a.height, kept.height);
+        return iUp;
+    };
+
+    if (difference > 1) { return rotate(iC, iB, true); }
+    if (difference < -1) { return rotate(iB, iC, false); }
+    return iA;
+}
+
+float DynamicAABBTree::areaRatio() const
+{
+    if (root == NULL_NODE) { return 0.0f; }
+
+    float total = 0.0f;
+    for (const Node& node : nodes) { if (node.height >= 0) { total += node.bounds.surfaceArea(); } }
+    return total / nodes[root].bounds.surfaceArea();
+}
+
+void DynamicAABBTree::queryBatch(const AABB* bounds, const std::size_t n, std::vector<std::uint32_t>& offsets, std::vector<std::int32_t>& proxies) const
+{
+    constexpr std::size_t BLOCK = 256;
+    const std::size_t blocks = (n + BLOCK - 1) / BLOCK;
+    std::vector<std::vector<std::int32_t>> blockProxies(blocks);
+    offsets.assign(n + 1, 0);
+
+    Parallel::parallelFor(blocks, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t block = begin; block < end; ++block)
+        {
+            std::vector<std::int32_t>& local = blockProxies[block];
+            for (std::size_t q = block * BLOCK; q < std::min(n, (block + 1) * BLOCK); ++q)
+            {
+                const std::size_t before = local.size();
+                query(bounds[q], [&](const std::int32_t proxy) { local.push_back(proxy); return true; });
+                offsets[q + 1] = static_cast<std::uint32_t>(local.size() - before);
+            }
+        }
+    });
+
+    for (std::size_t q = 0; q < n; ++q) { offsets[q + 1] += offsets[q]; }
+    proxies.resize(offsets[n]);
+    for (std::size_t block = 0; block < blocks; ++block)
+    {
+        std::copy(blockProxies[block].begin(), blockProxies[block].end(), proxies.begin() + offsets[block * BLOCK]);
+    }
+}
+
+void DynamicAABBTree::raycastBatch(const Ray* rays, const std::size_t n, std::int32_t* hitProxies, float* hitDistances) const
+{
+    Parallel::parallelFor(n, 64, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t r = begin; r < end; ++r)
+        {
+            const Vector3 inverseDirection(1.0f / rays[r].direction.x, 1.0f / rays[r].direction.y, 1.0f / rays[r].direction.z);
+            std::int32_t best = NULL_NODE;
+            float bestDistance = std::numeric_limits<float>::infinity();
+            raycast(rays[r], [&](const std::int32_t proxy, const Ray& clipped)
+            {
+                float t;
+                if (!Geometry::intersect(tightBounds[proxy], clipped.origin, inverseDirection, clipped.maxDistance, t)) { return -1.0f; }
+                best = proxy;
+                bestDistance = t;
+                return std::max(t, std::numeric_limits<float>::min());
+            });
+            hitProxies[r] = best;
+            hitDistances[r] = bestDistance;
+        }
+    });
+}
@@ -0,0 +1,430 @@
+#include "ik.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Animation;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    constexpr float EPSILON = 1e-6f;
+    // keeps the middle joint off the fully extended and fully folded singularities
+    constexpr float REACH_MARGIN = 1e-4f;
+    constexpr std::size_t JOB_GRAIN = 16;
+
+    Vector3 unit(const Vector3& v)
+    {
+        const float m = v.magnitude();
+        return m > EPSILON ? v * (1.0f / m) : Vector3();
+    }
+
+    Vector3 perpendicular(const Vector3& v)
+    {
+        const Vector3 axis = std::fabs(v.x) < std::fabs(v.y) ? (std::fabs(v.x) < std::fabs(v.z) ? Vector3(1.0f, 0.0f, 0.0f) : Vector3(0.0f, 0.0f, 1.0f))
+                                                             : (std::fabs(v.y) < std::fabs(v.z) ? Vector3(0.0f, 1.0f, 0.0f) : Vector3(0.0f, 0.0f, 1.0f));
+        return unit(v.cross(axis));
+    }
+
+    // shortest arc between unit vectors, turning about a perpendicular axis when they are opposite
+    Quaternion rotationBetween(const Vector3& from, const Vector3& to)
+    {
+        const float w = 1.0f + from.dot(to);
+        if (w < EPSILON)
+        {
+            const Vector3 axis = perpendicular(from);
+            return {axis.x, axis.y, axis.z, 0.0f};
+        }
+        const Vector3 c = from.cross(to);
+        Quaternion q(c.x, c.y, c.z, w);
+        q.normalize();
+        return q;
+    }
+
+    Quaternion axisAngle(const Vector3& axis, const float angle)
+    {
+        const float s = std::sin(0.5f * angle);
+        return {axis.x * s, axis.y * s, axis.z * s, std::cos(0.5f * angle)};
+    }
+
+    Quaternion limitAngle(const Quaternion& q, const float maxAngle)
+    {
+        const Quaternion r = q.w < 0.0f ? -q : q;
+        const float angle = 2.0f * std::acos(std::min(r.w, 1.0f));
+        if (angle <= maxAngle) { return r; }
+        return axisAngle(unit({r.x, r.y, r.z}), maxAngle);
+    }
+
+    // q = swing * twist with the twist about the bone axis; both parts are clamped independently
+    Quaternion constrain(const Quaternion& local, const JointLimit& limit, const Vector3& boneAxis)
+    {
+        Quaternion relative = limit.reference.conjugate() * local;
+        if (relative.w < 0.0f) { relative = -relative; }
+
+        const float projection = boneAxis.x * relative.x + boneAxis.y * relative.y + boneAxis.z * relative.z;
+        Quaternion twist(boneAxis.x * projection, boneAxis.y * projection, boneAxis.z * projection, relative.w);
+        if (twist.squaredMagnitude() < EPSILON) { twist = Quaternion::IDENTITY; }
+        twist.normalize();
+        Quaternion swing = relative * twist.conjugate();
+        if (swing.w < 0.0f) { swing = -swing; }
+
+        const float twistAngle = 2.0f * std::atan2(boneAxis.x * twist.x + boneAxis.y * twist.y + boneAxis.z * twist.z, twist.w);
+        const float swingAngle = 2.0f * std::acos(std::min(swing.w, 1.0f));
+        const float clampedTwist = std::clamp(twistAngle, limit.minTwist, limit.maxTwist);
+        if (clampedTwist == twistAngle && swingAngle <= limit.maxSwing) { return local; }
+
+        const Quaternion clampedSwing = swingAngle <= limit.maxSwing ? swing : axisAngle(unit({swing.x, swing.y, swing.z}), limit.maxSwing);
+        return limit.reference * (clampedSwing * axisAngle(boneAxis, clampedTwist));
+    }
+
+    // rotates joint j and everything below it about joint j; renormalizing keeps repeated corrections
+    // from shrinking the chain
+    void rotateFrom(const IkChain& chain, const std::size_t j, Quaternion delta)
+    {
+        delta.normalize();
+        const Vector3 pivot = chain.positions[j];
+        for (std::size_t k = j + 1; k < chain.count; ++k) { chain.positions[k] = pivot + delta.rotate(chain.positions[k] - pivot); }
+        for (std::size_t k = j; k < chain.count; ++k)
+        {
+            chain.rotations[k] = delta * chain.rotations[k];
+            chain.rotations[k].normalize();
+        }
+    }
+
+    Quaternion parentOf(const IkChain& chain, const std::size_t j) { return j == 0 ? chain.parentRotation : chain.rotations[j - 1]; }
+
+    void enforceLimit(const IkChain& chain, const std::size_t j, const Vector3& boneAxis)
+    {
+        const Quaternion parent = parentOf(chain, j);
+        const Quaternion world = parent * constrain(parent.conjugate() * chain.rotations[j], chain.limits[j], boneAxis);
+        rotateFrom(chain, j, world * chain.rotations[j].conjugate());
+    }
+
+    // bone directions in each joint's own frame and bone lengths; both are invariant while solving
+    void measureBones(const IkChain& chain, Vector3* axes, float* lengths)
+    {
+        for (std::size_t j = 0; j + 1 < chain.count; ++j)
+        {
+            const Vector3 bone = chain.positions[j + 1] - chain.positions[j];
+            axes[j] = unit(chain.rotations[j].conjugate().rotate(bone));
+            lengths[j] = bone.magnitude();
+        }
+    }
+
+    float remaining(const IkChain& chain, const Vector3& target) { return chain.count == 0 ? 0.0f : (chain.positions[chain.count - 1] - target).magnitude(); }
+
+    // turns each bone onto the solved positions from the root down, then lays positions out again from
+    // the (possibly limited) rotations so the chain stays rigid
+    void fitRotations(const IkChain& chain, const Vector3* axes, const float* lengths)
+    {
+        Quaternion inherited = Quaternion::IDENTITY;
+        for (std::size_t j = 0; j + 1 < chain.count; ++j)
+        {
+            Quaternion rotation = inherited * chain.rotations[j];
+            const Vector3 wanted = unit(chain.positions[j + 1] - chain.positions[j]);
+            if (!wanted.isZero()) { rotation = rotationBetween(rotation.rotate(axes[j]), wanted) * rotation; }
+            rotation.normalize();
+            if (chain.limits)
+            {
+                const Quaternion parent = parentOf(chain, j);
+                rotation = parent * constrain(parent.conjugate() * rotation, chain.limits[j], axes[j]);
+            }
+            inherited = rotation * chain.rotations[j].conjugate();
+            chain.rotations[j] = rotation;
+            chain.positions[j + 1] = chain.positions[j] + rotation.rotate(axes[j]) * lengths[j];
+        }
+        chain.rotations[chain.count - 1] = inherited * chain.rotations[chain.count - 1];
+    }
+
+    struct Lanes3
+    {
+        Float4 x, y, z;
+    };
+
+    Lanes3 operator+(const Lanes3& a, const Lanes3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    Lanes3 operator-(const Lanes3& a, const Lanes3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    Lanes3 operator*(const Lanes3& a, const Float4& s) { return {a.x * s, a.y * s, a.z * s}; }
+    Float4 dot(const Lanes3& a, const Lanes3& b) { return dot3(a.x, a.y, a.z, b.x, b.y, b.z); }
+    Lanes3 cross(const Lanes3& a, const Lanes3& b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+    Float4 length(const Lanes3& a) { return sqrt(dot(a, a)); }
+    Lanes3 select(const Float4& mask, const Lanes3& a, const Lanes3& b) { return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z)}; }
+
+    // zero length lanes come out as zero
+    Lanes3 unit(const Lanes3& a)
+    {
+        const Float4 m = length(a);
+        return a * select(m > Float4(EPSILON), Float4(1.0f) / m, Float4(0.0f));
+    }
+
+    Lanes3 perpendicular(const Lanes3& v)
+    {
+        const Float4 zero(0.0f);
+        const Float4 useX = abs(v.x) < Float4(0.9f);
+        return unit({select(useX, zero, -v.z), select(useX, v.z, zero), select(useX, -v.y, v.x)});
+    }
+
+    struct QuaternionLanes
+    {
+        Float4 x, y, z, w;
+    };
+
+    QuaternionLanes operator*(const QuaternionLanes& a, const QuaternionLanes& b)
+    {
+        return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+    }
+
+    Lanes3 rotate(const QuaternionLanes& q, const Lanes3& v)
+    {
+        const Lanes3 u {q.x, q.y, q.z};
+        const Lanes3 t = cross(u, v) * Float4(2.0f);
+        return v + t * q.w + cross(u, t);
+    }
+
+    // rotation about a unit axis given the cosine and sine of the full angle
+    QuaternionLanes fromCosSin(const Lanes3& axis, const Float4& cosine, const Float4& sine)
+    {
+        const Float4 half(0.5f), zero(0.0f);
+        const Float4 c = sqrt(max(half + half * cosine, zero));
+        const Float4 s = sqrt(max(half - half * cosine, zero));
+        const Float4 signedS = select(sine < zero, -s, s);
+        return {axis.x * signedS, axis.y * signedS, axis.z * signedS, c};
+    }
+
+    // shortest arc between unit vectors; opposite vectors turn half way about the fallback axis
+    QuaternionLanes between(const Lanes3& from, const Lanes3& to, const Lanes3& fallbackAxis)
+    {
+        const Float4 w = Float4(1.0f) + dot(from, to);
+        const Float4 opposite = w < Float4(EPSILON);
+        const Lanes3 axis = select(opposite, fallbackAxis, cross(from, to));
+        const QuaternionLanes q {axis.x, axis.y, axis.z, select(opposite, Float4(0.0f), w)};
+        const Float4 inverse = Float4(1.0f) / sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        return {q.x * inverse, q.y * inverse, q.z * inverse, q.w * inverse};
+    }
+
+    QuaternionLanes select(const Float4& mask, const QuaternionLanes& a, const QuaternionLanes& b)
+    {
+        return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z), select(mask, a.w, b.w)};
+    }
+
+    Lanes3 gather(const Vector3 (&v)[WIDTH]) { return {Float4(v[0].x, v[1].x, v[2].x, v[3].x), Float4(v[0].y, v[1].y, v[2].y, v[3].y), Float4(v[0].z, v[1].z, v[2].z, v[3].z)}; }
+
+    QuaternionLanes gather(const Quaternion (&q)[WIDTH])
+    {
+        return {Float4(q[0].x, q[1].x, q[2].x, q[3].x), Float4(q[0].y, q[1].y, q[2].y, q[3].y),
+                Float4(q[0].z, q[1].z, q[2].z, q[3].z), Float4(q[0].w, q[1].w, q[2].w, q[3].w)};
+    }
+
+    Vector3 lane(const Lanes3& v, const int k) { return {v.x[k], v.y[k], v.z[k]}; }
+    Quaternion lane(const QuaternionLanes& q, const int k) { return {q.x[k], q.y[k], q.z[k], q.w[k]}; }
+
+    // Law of cosines without trigonometry: the bend about the current hinge turns the upper bone and
+    // the middle joint to the angles that put the end at the (clamped) target distance, a swing about
+    // the root aims the limb at the target and a twist about the limb axis turns the bend towards the pole.
+    void solveTwoBoneGroup(const IkJob* const (&group)[WIDTH], const std::size_t lanes, float* errors)
+    {
+        Vector3 rootIn[WIDTH], middleIn[WIDTH], endIn[WIDTH], targetIn[WIDTH], poleIn[WIDTH];
+        Quaternion rootRotationIn[WIDTH], middleRotationIn[WIDTH], endRotationIn[WIDTH];
+        float usePoleIn[WIDTH];
+        for (std::size_t k = 0; k < WIDTH; ++k)
+        {
+            const IkJob& job = *group[k < lanes ? k : 0];
+            rootIn[k] = job.chain.positions[0];
+            middleIn[k] = job.chain.positions[1];
+            endIn[k] = job.chain.positions[2];
+            rootRotationIn[k] = job.chain.rotations[0];
+            middleRotationIn[k] = job.chain.rotations[1];
+            endRotationIn[k] = job.chain.rotations[2];
+            targetIn[k] = job.target;
+            poleIn[k] = job.pole;
+            usePoleIn[k] = job.usePole ? 1.0f : 0.0f;
+        }
+
+        const Float4 zero(0.0f), one(1.0f), two(2.0f), tiny(EPSILON);
+        const Lanes3 a = gather(rootIn), b = gather(middleIn), c = gather(endIn), target = gather(targetIn);
+        const Lanes3 toPole = gather(poleIn) - a;
+        const Float4 usePole = Float4::load(usePoleIn) > zero;
+
+        const Float4 upper = max(length(b - a), tiny), lower = max(length(c - b), tiny);
+        const Lanes3 toTarget = target - a;
+        const Float4 targetDistance = length(toTarget);
+        const Float4 reach = min(max(targetDistance, abs(upper - lower) + Float4(REACH_MARGIN) * (upper + lower)), (upper + lower) * Float4(1.0f - REACH_MARGIN));
+
+        const Lanes3 limb = unit(c - a), upperBone = (b - a) * (one / upper);
+        const Lanes3 hinge = cross(limb, upperBone);
+        const Float4 hingeLength = length(hinge);
+        const Lanes3 poleHinge = unit(cross(limb, toPole));
+        const Lanes3 straightHinge = select(usePole & (dot(poleHinge, poleHinge) > Float4(0.5f)), poleHinge, perpendicular(limb));
+        const Lanes3 axis = select(hingeLength > Float4(1e-4f), hinge * (one / max(hingeLength, tiny)), straightHinge);
+
+        // current and wanted angles at the root (between limb and upper bone) and at the middle joint
+        const Float4 cosRoot = dot(limb, upperBone), sinRoot = hingeLength;
+        const Lanes3 toRoot = (a - b) * (one / upper), toEnd = (c - b) * (one / lower);
+        const Float4 cosMiddle = dot(toRoot, toEnd), sinMiddle = length(cross(toRoot, toEnd));
+        const Float4 cosRootWanted = max(min((upper * upper + reach * reach - lower * lower) / (two * upper * reach), one), -one);
+        const Float4 cosMiddleWanted = max(min((upper * upper + lower * lower - reach * reach) / (two * upper * lower), one), -one);
+        const Float4 sinRootWanted = sqrt(max(one - cosRootWanted * cosRootWanted, zero));
+        const Float4 sinMiddleWanted = sqrt(max(one - cosMiddleWanted * cosMiddleWanted, zero));
+
+        const QuaternionLanes rootBend = fromCosSin(axis, cosRootWanted * cosRoot + sinRootWanted * sinRoot, sinRootWanted * cosRoot - cosRootWanted * sinRoot);
+        const QuaternionLanes middleBend = fromCosSin(axis, cosMiddleWanted * cosMiddle + sinMiddleWanted * sinMiddle, sinMiddleWanted * cosMiddle - cosMiddleWanted * sinMiddle);
+        const QuaternionLanes lowerBend = middleBend * rootBend;
+        const Lanes3 bentUpper = rotate(rootBend, b - a);
+        const Lanes3 bentLimb = bentUpper + rotate(lowerBend, c - b);
+
+        const Lanes3 aim = select(targetDistance > tiny, toTarget * (one / max(targetDistance, tiny)), limb);
+        const QuaternionLanes swing = between(unit(bentLimb), aim, axis);
+        const Lanes3 swungUpper = rotate(swing, bentUpper);
+
+        const Lanes3 middleOffset = swungUpper - aim * dot(swungUpper, aim);
+        const Lanes3 poleOffset = toPole - aim * dot(toPole, aim);
+        const Float4 canTwist = usePole & (dot(middleOffset, middleOffset) > tiny) & (dot(poleOffset, poleOffset) > tiny);
+        const QuaternionLanes identity {zero, zero, zero, one};
+        const QuaternionLanes twist = select(canTwist, between(unit(middleOffset), unit(poleOffset), aim), identity);
+
+        const QuaternionLanes rootDelta = twist * swing * rootBend;
+        const QuaternionLanes lowerDelta = twist * swing * lowerBend;
+        const Lanes3 middle = a + rotate(twist, swungUpper);
+        const Lanes3 end = a + rotate(twist * swing, bentLimb);
+        const QuaternionLanes rootRotation = rootDelta * gather(rootRotationIn);
+        const QuaternionLanes middleRotation = lowerDelta * gather(middleRotationIn);
+        const QuaternionLanes endRotation = lowerDelta * gather(endRotationIn);
+        const Float4 error = length(end - target);
+
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            const IkChain& chain = group[k]->chain;
+            const int i = static_cast<int>(k);
+            chain.positions[1] = lane(middle, i);
+            chain.positions[2] = lane(end, i);
+            chain.rotations[0] = lane(rootRotation, i);
+            chain.rotations[1] = lane(middleRotation, i);
+            chain.rotations[2] = lane(endRotation, i);
+            errors[k] = error[i];
+        }
+    }
+
+    float solveJob(const IkJob& job, const IkParams& params)
+    {
+        switch (job.method)
+        {
+            case IkMethod::Ccd: return solveCcd(job.chain, job.target, params);
+            case IkMethod::Fabrik: return solveFabrik(job.chain, job.target, params);
+            default: return solveTwoBone(job.chain, job.target, job.usePole ? &job.pole : nullptr);
+        }
+    }
+}
+
+float Kronos::CoreSystems::Animation::solveTwoBone(const IkChain& chain, const Vector3& target, const Vector3* pole)
+{
+    if (chain.count != 3) { return remaining(chain, target); }
+    const IkJob job {chain, target, pole ? *pole : Vector3(), pole != nullptr, IkMethod::TwoBone};
+    const IkJob* const group[WIDTH] = {&job, &job, &job, &job};
+    float error;
+    solveTwoBoneGroup(group, 1, &error);
+    return error;
+}
+
+float Kronos::CoreSystems::Animation::solveCcd(const IkChain& chain, const Vector3& target, const IkParams& params)
+{
+    const std::size_t n = chain.count;
+    if (n < 2 || n > MAX_IK_JOINTS) { return remaining(chain, target); }
+
+    Vector3 axes[MAX_IK_JOINTS];
+    float lengths[MAX_IK_JOINTS];
+    measureBones(chain, axes, lengths);
+
+    float error = remaining(chain, target);
+    for (int iteration = 0; iteration < params.maxIterations && error > params.tolerance; ++iteration)
+    {
+        for (std::size_t j = n - 1; j-- > 0;)
+        {
+            const Vector3 from = unit(chain.positions[n - 1] - chain.positions[j]), to = unit(target - chain.positions[j]);
+            if (from.isZero() || to.isZero()) { continue; }
+            rotateFrom(chain, j, limitAngle(rotationBetween(from, to), params.maxStepAngle));
+            if (chain.limits) { enforceLimit(chain, j, axes[j]); }
+        }
+        error = remaining(chain, target);
+    }
+    return error;
+}
+
+float Kronos::CoreSystems::Animation::solveFabrik(const IkChain& chain, const Vector3& target, const IkParams& params)
+{
+    const std::size_t n = chain.count;
+    if (n < 2 || n > MAX_IK_JOINTS) { return remaining(chain, target); }
+
+    Vector3 axes[MAX_IK_JOINTS];
+    float lengths[MAX_IK_JOINTS];
+    measureBones(chain, axes, lengths);
+    Vector3* p = chain.positions;
+    const Vector3 root = p[0];
+
+    float total = 0.0f;
+    for (std::size_t j = 0; j + 1 < n; ++j) { total += lengths[j]; }
+
+    float error = remaining(chain, target);
+    if ((target - root).magnitude() >= total)
+    {
+        // out of reach: one pass lays the chain straight towards the target
+        const Vector3 direction = unit(target - root);
+        for (std::size_t j = 0; j + 1 < n; ++j) { p[j + 1] = p[j] + direction * lengths[j]; }
+        fitRotations(chain, axes, lengths);
+        return remaining(chain, target);
+    }
+
+    for (int iteration = 0; iteration < params.maxIterations && error > params.tolerance; ++iteration)
+    {
+        p[n - 1] = target;
+        for (std::size_t j = n - 1; j-- > 0;) { p[j] = p[j + 1] + unit(p[j] - p[j + 1]) * lengths[j]; }
+        p[0] = root;
+        for (std::size_t j = 0; j + 1 < n; ++j) { p[j + 1] = p[j] + unit(p[j + 1] - p[j]) * lengths[j]; }
+
+        // limits act on rotations, so a limited chain is re-fitted every iteration
+        if (chain.limits) { fitRotations(chain, axes, lengths); }
+        error = remaining(chain, target);
+    }
+    if (!chain.limits) { fitRotations(chain, axes, lengths); }
+    return remaining(chain, target);
+}
+
+void Kronos::CoreSystems::Animation::solveBatch(const IkJob* jobs, const std::size_t n, const IkParams& params, float* errors)
+{
+    Parallel::parallelFor(n, JOB_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        const IkJob* group[WIDTH] = {};
+        std::size_t indices[WIDTH];
+        std::size_t lanes = 0;
+        float groupErrors[WIDTH];
+        const auto flush = [&]
+        {
+            if (lanes == 0) { return; }
+            solveTwoBoneGroup(group, lanes, groupErrors);
+            if (errors) { for (std::size_t k = 0; k < lanes; ++k) { errors[indices[k]] = groupErrors[k]; } }
+            lanes = 0;
+        };
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const IkJob& job = jobs[i];
+            if (job.method == IkMethod::TwoBone && job.chain.count == 3)
+            {
+                group[lanes] = &job;
+                indices[lanes] = i;
+                if (++lanes == WIDTH) { flush(); }
+                continue;
+            }
+            const float error = solveJob(job, params);
+            if (errors) { errors[i] = error; }
+        }
+        flush();
+    });
+}
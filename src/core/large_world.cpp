@@ -0,0 +1,202 @@
+#include "large_world.hpp"
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Math;
+using namespace Kronos::CoreSystems::Simd;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+const DVector3 DVector3::ZERO(0.0, 0.0, 0.0);
+
+const DMatrix4x4 DMatrix4x4::ZERO(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+const DMatrix4x4 DMatrix4x4::IDENTITY(1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0);
+
+namespace
+{
+    constexpr std::size_t CONVERT_GRAIN = 4096;
+    constexpr std::size_t MATRIX_GRAIN = 256;
+
+    float narrow(const double d) { return static_cast<float>(d); }
+}
+
+Matrix4x4 DMatrix4x4::toMatrix4x4() const
+{
+    return {narrow(m00), narrow(m01), narrow(m02), narrow(m03),
+            narrow(m10), narrow(m11), narrow(m12), narrow(m13),
+            narrow(m20), narrow(m21), narrow(m22), narrow(m23),
+            narrow(m30), narrow(m31), narrow(m32), narrow(m33)};
+}
+
+DMatrix4x4 Kronos::CoreSystems::Math::operator*(const DMatrix4x4& a, const DMatrix4x4& b)
+{
+    return
+    {
+        a.m00 * b.m00 + a.m01 * b.m10 + a.m02 * b.m20 + a.m03 * b.m30,
+        a.m00 * b.m01 + a.m01 * b.m11 + a.m02 * b.m21 + a.m03 * b.m31,
+        a.m00 * b.m02 + a.m01 * b.m12 + a.m02 * b.m22 + a.m03 * b.m32,
+        a.m00 * b.m03 + a.m01 * b.m13 + a.m02 * b.m23 + a.m03 * b.m33,
+        a.m10 * b.m00 + a.m11 * b.m10 + a.m12 * b.m20 + a.m13 * b.m30,
+        a.m10 * b.m01 + a.m11 * b.m11 + a.m12 * b.m21 + a.m13 * b.m31,
+        a.m10 * b.m02 + a.m11 * b.m12 + a.m12 * b.m22 + a.m13 * b.m32,
+        a.m10 * b.m03 + a.m11 * b.m13 + a.m12 * b.m23 + a.m13 * b.m33,
+        a.m20 * b.m00 + a.m21 * b.m10 + a.m22 * b.m20 + a.m23 * b.m30,
+        a.m20 * b.m01 + a.m21 * b.m11 + a.m22 * b.m21 + a.m23 * b.m31,
+        a.m20 * b.m02 + a.m21 * b.m12 + a.m22 * b.m22 + a.m23 * b.m32,
+        a.m20 * b.m03 + a.m21 * b.m13 + a.m22 * b.m23 + a.m23 * b.m33,
+        a.m30 * b.m00 + a.m31 * b.m10 + a.m32 * b.m20 + a.m33 * b.m30,
+        a.m30 * b.m01 + a.m31 * b.m11 + a.m32 * b.m21 + a.m33 * b.m31,
+        a.m30 * b.m02 + a.m31 * b.m12 + a.m32 * b.m22 + a.m33 * b.m32,
+        a.m30 * b.m03 + a.m31 * b.m13 + a.m32 * b.m23 + a.m33 * b.m33
+    };
+}
+
+Vector3 Kronos::CoreSystems::Math::toCameraRelative(const DVector3& position, const DVector3& origin)
+{
+    return (position - origin).toVector3();
+}
+
+Matrix4x4 Kronos::CoreSystems::Math::toCameraRelative(const DMatrix4x4& transform, const DVector3& origin)
+{
+    // the translation is the only large term; subtracting it first keeps the float matrix small
+    Matrix4x4 m = transform.toMatrix4x4();
+    m.m03 = narrow(transform.m03 - origin.x * transform.m33);
+    m.m13 = narrow(transform.m13 - origin.y * transform.m33);
+    m.m23 = narrow(transform.m23 - origin.z * transform.m33);
+    return m;
+}
+
+void Kronos::CoreSystems::Math::toCameraRelative(const DVector3* positions, const std::size_t n, const DVector3& origin, Vector3* out)
+{
+    static_assert(sizeof(DVector3) == 3 * sizeof(double) && sizeof(Vector3) == 3 * sizeof(float));
+    Parallel::parallelFor(n, CONVERT_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+#ifdef KRONOS_SIMD_SSE2
+        // four positions are twelve components: six double pairs narrowed into three float quads, with the
+        // origin repeating every three pairs
+        const __m128d o0 = _mm_setr_pd(origin.x, origin.y), o1 = _mm_setr_pd(origin.z, origin.x), o2 = _mm_setr_pd(origin.y, origin.z);
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            const double* p = &positions[i].x;
+            const __m128 a = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p), o0));
+            const __m128 b = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 2), o1));
+            const __m128 c = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 4), o2));
+            const __m128 d = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 6), o0));
+            const __m128 e = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 8), o1));
+            const __m128 f = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 10), o2));
+            float* r = &out[i].x;
+            _mm_storeu_ps(r, _mm_movelh_ps(a, b));
+            _mm_storeu_ps(r + 4, _mm_movelh_ps(c, d));
+            _mm_storeu_ps(r + 8, _mm_movelh_ps(e, f));
+        }
+#endif
+        for (; i < end; ++i) { out[i] = toCameraRelative(positions[i], origin); }
+    });
+}
+
+void Kronos::CoreSystems::Math::toCameraRelative(const double* x, const double* y, const double* z, const std::size_t n, const DVector3& origin, float* outX, float* outY, float* outZ)
+{
+    Parallel::parallelFor(n, CONVERT_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+#ifdef KRONOS_SIMD_SSE2
+        const auto narrowFour = [](const double* p, const __m128d o, float* r)
+        {
+            _mm_storeu_ps(r, _mm_movelh_ps(_mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p), o)), _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 2), o))));
+        };
+        const __m128d ox = _mm_set1_pd(origin.x), oy = _mm_set1_pd(origin.y), oz = _mm_set1_pd(origin.z);
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            narrowFour(x + i, ox, outX + i);
+            narrowFour(y + i, oy, outY + i);
+            narrowFour(z + i, oz, outZ + i);
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            outX[i] = narrow(x[i] - origin.x);
+            outY[i] = narrow(y[i] - origin.y);
+            outZ[i] = narrow(z[i] - origin.z);
+        }
+    });
+}
+
+void Kronos::CoreSystems::Math::toCameraRelative(const DMatrix4x4* transforms, const std::size_t n, const DVector3& origin, Matrix4x4* out)
+{
+    Parallel::parallelFor(n, MATRIX_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { out[i] = toCameraRelative(transforms[i], origin); }
+    });
+}
+
+void Kronos::CoreSystems::Math::rebase(Vector3* positions, const std::size_t n, const Vector3& offset)
+{
+    float* p = &positions->x;
+    // four positions span three quads, each with the offset rotated by one component
+    const Float4 o0(offset.x, offset.y, offset.z, offset.x), o1(offset.y, offset.z, offset.x, offset.y), o2(offset.z, offset.x, offset.y, offset.z);
+    Parallel::parallelFor(n, CONVERT_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            float* r = p + i * 3;
+            (Float4::load(r) + o0).store(r);
+            (Float4::load(r + 4) + o1).store(r + 4);
+            (Float4::load(r + 8) + o2).store(r + 8);
+        }
+        for (; i < end; ++i) { positions[i] += offset; }
+    });
+}
+
+void Kronos::CoreSystems::Math::rebase(float* x, float* y, float* z, const std::size_t n, const Vector3& offset)
+{
+    const Float4 ox(offset.x), oy(offset.y), oz(offset.z);
+    Parallel::parallelFor(n, CONVERT_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            (Float4::load(x + i) + ox).store(x + i);
+            (Float4::load(y + i) + oy).store(y + i);
+            (Float4::load(z + i) + oz).store(z + i);
+        }
+        for (; i < end; ++i)
+        {
+            x[i] += offset.x;
+            y[i] += offset.y;
+            z[i] += offset.z;
+        }
+    });
+}
+
+void Kronos::CoreSystems::Math::rebase(Matrix4x4* transforms, const std::size_t n, const Vector3& offset)
+{
+    Parallel::parallelFor(n, MATRIX_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Matrix4x4& m = transforms[i];
+            m.m03 += offset.x * m.m33;
+            m.m13 += offset.y * m.m33;
+            m.m23 += offset.z * m.m33;
+        }
+    });
+}
+
+FloatingOrigin::FloatingOrigin(const double threshold, const double gridSize, const DVector3& origin)
+    : threshold(threshold > 0.0 ? threshold : 0.0), gridSize(gridSize > 0.0 ? gridSize : 0.0), current(origin)
+{
+}
+
+bool FloatingOrigin::update(const DVector3& camera, Vector3& offset)
+{
+    if ((camera - current).squaredMagnitude() <= threshold * threshold) { return false; }
+
+    const auto snap = [this](const double v) { return gridSize > 0.0 ? std::round(v / gridSize) * gridSize : v; };
+    const DVector3 next(snap(camera.x), snap(camera.y), snap(camera.z));
+    // positions relative to the old origin become relative to the new one by adding old - new
+    offset = (current - next).toVector3();
+    current = next;
+    return true;
+}
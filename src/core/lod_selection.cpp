@@ -0,0 +1,134 @@
+#include "lod_selection.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    constexpr std::size_t CHUNK_OBJECTS = 4096;
+    constexpr std::int32_t NO_HISTORY = -1;
+    constexpr float MIN_DISTANCE = 1e-6f;
+
+    // LODs finer than the one holding size: the number of thresholds size is below
+    Int4 countBelow(const Float4& size, const Float4* thresholds, const std::uint32_t count)
+    {
+        Int4 lod(0);
+        for (std::uint32_t k = 0; k < count; ++k) { lod = lod - asInt(size < thresholds[k]); }
+        return lod;
+    }
+}
+
+void LodSelector::resetHistory()
+{
+    std::fill(objectLods.begin(), objectLods.end(), NO_HISTORY);
+}
+
+void LodSelector::select(const float* x, const float* y, const float* z, const float* radius, const std::size_t n,
+                         const Vector3& camera, const Matrix4x4& projection, const LodThresholds& thresholds)
+{
+    const std::uint32_t lodCount = std::clamp(thresholds.lodCount, 1u, MAX_LODS);
+    // buckets 0..lodCount-1 hold drawn objects and bucket lodCount the culled ones
+    const std::uint32_t buckets = lodCount + 1;
+    const std::size_t chunks = (n + CHUNK_OBJECTS - 1) / CHUNK_OBJECTS;
+    objectLods.resize(n, NO_HISTORY);
+    chunkCounts.assign(chunks * buckets, 0);
+
+    // projected size is radius * m11 / distance under perspective and radius * m11 under an orthographic projection
+    const bool perspective = projection.m33 == 0.0f;
+    const Float4 scale(projection.m11), cx(camera.x), cy(camera.y), cz(camera.z);
+    const float lenient = 1.0f - thresholds.hysteresis, strict = 1.0f + thresholds.hysteresis;
+    Float4 exact[MAX_LODS], lenientThresholds[MAX_LODS], strictThresholds[MAX_LODS];
+    for (std::uint32_t k = 0; k < lodCount; ++k)
+    {
+        exact[k] = Float4(thresholds.screenSize[k]);
+        lenientThresholds[k] = Float4(thresholds.screenSize[k] * lenient);
+        strictThresholds[k] = Float4(thresholds.screenSize[k] * strict);
+    }
+
+    Parallel::parallelFor(chunks, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t chunk = begin; chunk < end; ++chunk)
+        {
+            const std::size_t first = chunk * CHUNK_OBJECTS, last = std::min(first + CHUNK_OBJECTS, n);
+            std::uint32_t* counts = chunkCounts.data() + chunk * buckets;
+            std::int32_t* lods = objectLods.data() + first;
+            // per lane counts of each LOD, summed when the chunk is done
+            Int4 laneCounts[MAX_LODS + 1];
+            std::fill(laneCounts, laneCounts + buckets, Int4(0));
+            std::size_t i = first;
+            for (; i + WIDTH <= last; i += WIDTH)
+            {
+                const Float4 dx = Float4::load(x + i) - cx, dy = Float4::load(y + i) - cy, dz = Float4::load(z + i) - cz;
+                const Float4 distance = perspective ? max(sqrt(multiplyAdd(dx, dx, multiplyAdd(dy, dy, dz * dz))), Float4(MIN_DISTANCE)) : Float4(1.0f);
+                const Float4 size = Float4::load(radius + i) * scale / distance;
+
+                // an object keeps its last LOD while that stays inside the band the hysteresis allows around
+                // the thresholds, and otherwise moves to the nearest LOD inside it
+                const Int4 finest = countBelow(size, lenientThresholds, lodCount);
+                const Int4 coarsest = countBelow(size, strictThresholds, lodCount);
+                const Int4 previous = Int4::load(lods + (i - first));
+                const Int4 kept = min(max(previous, finest), coarsest);
+                const Int4 lod = Kronos::CoreSystems::Simd::select(previous < Int4(0), countBelow(size, exact, lodCount), kept);
+                lod.store(lods + (i - first));
+                for (std::uint32_t bucket = 0; bucket < buckets; ++bucket) { laneCounts[bucket] = laneCounts[bucket] - (lod == Int4(static_cast<std::int32_t>(bucket))); }
+            }
+            for (std::uint32_t bucket = 0; bucket < buckets; ++bucket)
+            {
+                for (int lane = 0; lane < WIDTH; ++lane) { counts[bucket] += static_cast<std::uint32_t>(laneCounts[bucket][lane]); }
+            }
+            for (; i < last; ++i)
+            {
+                const float dx = x[i] - camera.x, dy = y[i] - camera.y, dz = z[i] - camera.z;
+                const float distance = perspective ? std::max(std::sqrt(dx * dx + dy * dy + dz * dz), MIN_DISTANCE) : 1.0f;
+                const float size = radius[i] * projection.m11 / distance;
+                std::int32_t finest = 0, coarsest = 0, raw = 0;
+                for (std::uint32_t k = 0; k < lodCount; ++k)
+                {
+                    finest += size < thresholds.screenSize[k] * lenient;
+                    coarsest += size < thresholds.screenSize[k] * strict;
+                    raw += size < thresholds.screenSize[k];
+                }
+                std::int32_t& lod = lods[i - first];
+                lod = lod < 0 ? raw : std::clamp(lod, finest, coarsest);
+                ++counts[lod];
+            }
+        }
+    });
+
+    // bucket offsets, then each chunk's starting position inside every bucket
+    std::fill(bucketOffsets.begin(), bucketOffsets.end(), 0);
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+    {
+        for (std::uint32_t lod = 0; lod < buckets; ++lod) { bucketOffsets[lod + 1] += chunkCounts[chunk * buckets + lod]; }
+    }
+    for (std::uint32_t lod = 0; lod < buckets; ++lod) { bucketOffsets[lod + 1] += bucketOffsets[lod]; }
+    std::fill(bucketOffsets.begin() + buckets + 1, bucketOffsets.end(), bucketOffsets[buckets]);
+    for (std::uint32_t lod = 0; lod < buckets; ++lod)
+    {
+        std::size_t cursor = bucketOffsets[lod];
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            const std::uint32_t count = chunkCounts[chunk * buckets + lod];
+            chunkCounts[chunk * buckets + lod] = static_cast<std::uint32_t>(cursor);
+            cursor += count;
+        }
+    }
+
+    bucketIndices.resize(n);
+    Parallel::parallelFor(chunks, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t chunk = begin; chunk < end; ++chunk)
+        {
+            std::uint32_t* cursors = chunkCounts.data() + chunk * buckets;
+            for (std::size_t i = chunk * CHUNK_OBJECTS; i < std::min((chunk + 1) * CHUNK_OBJECTS, n); ++i) { bucketIndices[cursors[objectLods[i]]++] = static_cast<std::uint32_t>(i); }
+        }
+    });
+}
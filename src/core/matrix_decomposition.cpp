@@ -0,0 +1,241 @@
+#include "matrix_decomposition.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Math;
+using namespace Kronos::CoreSystems::Simd;
+
+namespace
+{
+    constexpr std::size_t DECOMPOSE_GRAIN = 1024;
+    constexpr int JACOBI_SWEEPS = 6;
+    constexpr float GIVENS_GAMMA = 5.828427125f;
+    constexpr float COS_PI_8 = 0.9238795325f;
+    constexpr float SIN_PI_8 = 0.3826834324f;
+    constexpr float QR_EPSILON = 1e-30f;
+
+    struct Matrix3Lanes
+    {
+        Float4 m[3][3];
+    };
+
+    struct QuaternionLanes
+    {
+        Float4 x, y, z, w;
+    };
+
+    Matrix3Lanes loadMatrices(const Matrix3x3* a, const std::size_t count)
+    {
+        // lanes past count repeat the last matrix so a partial group stays finite
+        const Matrix3x3* lane[WIDTH];
+        for (std::size_t k = 0; k < WIDTH; ++k) { lane[k] = a + (k < count ? k : count - 1); }
+
+        Matrix3Lanes result;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                const std::size_t offset = static_cast<std::size_t>(i * 3 + j);
+                result.m[i][j] = Float4((&lane[0]->m00)[offset], (&lane[1]->m00)[offset], (&lane[2]->m00)[offset], (&lane[3]->m00)[offset]);
+            }
+        }
+        return result;
+    }
+
+    Matrix3x3 matrixAt(const Matrix3Lanes& a, const int k)
+    {
+        return {a.m[0][0][k], a.m[0][1][k], a.m[0][2][k],
+                a.m[1][0][k], a.m[1][1][k], a.m[1][2][k],
+                a.m[2][0][k], a.m[2][1][k], a.m[2][2][k]};
+    }
+
+    // one Jacobi conjugation S <- G^T S G in the (p, q) plane, G being a rotation about axis k;
+    // the half angle comes from the approximate Givens rotation of McAdams et al. 2011
+    void jacobiRotate(Matrix3Lanes& s, QuaternionLanes& v, const int p, const int q, const int k)
+    {
+        const Float4 a = Float4(2.0f) * (s.m[p][p] - s.m[q][q]);
+        const Float4 b = s.m[p][q];
+        const Float4 approximate = Float4(GIVENS_GAMMA) * b * b < a * a;
+        const Float4 w = rsqrt(a * a + b * b);
+        const Float4 ch = select(approximate, w * a, Float4(COS_PI_8));
+        const Float4 sh = select(approximate, w * b, Float4(SIN_PI_8));
+
+        const Float4 c = ch * ch - sh * sh;
+        const Float4 sn = Float4(2.0f) * ch * sh;
+        const Float4 cc = c * c, ss = sn * sn, cs = c * sn;
+
+        const Float4 pp = s.m[p][p], qq = s.m[q][q], pq = s.m[p][q], pk = s.m[p][k], qk = s.m[q][k];
+        s.m[p][p] = cc * pp + Float4(2.0f) * cs * pq + ss * qq;
+        s.m[q][q] = ss * pp - Float4(2.0f) * cs * pq + cc * qq;
+        s.m[p][q] = s.m[q][p] = cs * (qq - pp) + (cc - ss) * pq;
+        s.m[p][k] = s.m[k][p] = c * pk + sn * qk;
+        s.m[q][k] = s.m[k][q] = c * qk - sn * pk;
+
+        // V <- V G as the quaternion product v * (sh e_k, ch)
+        Float4 g[3] = {Float4(0.0f), Float4(0.0f), Float4(0.0f)};
+        g[k] = sh;
+        const QuaternionLanes r = v;
+        v.w = r.w * ch - r.x * g[0] - r.y * g[1] - r.z * g[2];
+        v.x = r.w * g[0] + r.x * ch + r.y * g[2] - r.z * g[1];
+        v.y = r.w * g[1] - r.x * g[2] + r.y * ch + r.z * g[0];
+        v.z = r.w * g[2] + r.x * g[1] - r.y * g[0] + r.z * ch;
+    }
+
+    Matrix3Lanes jacobi(Matrix3Lanes& s)
+    {
+        QuaternionLanes v {Float4(0.0f), Float4(0.0f), Float4(0.0f), Float4(1.0f)};
+        for (int sweep = 0; sweep < JACOBI_SWEEPS; ++sweep)
+        {
+            jacobiRotate(s, v, 0, 1, 2);
+            jacobiRotate(s, v, 1, 2, 0);
+            jacobiRotate(s, v, 2, 0, 1);
+        }
+
+        const Float4 inv = rsqrt(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+        const Float4 x = v.x * inv, y = v.y * inv, z = v.z * inv, w = v.w * inv;
+        const Float4 one(1.0f), two(2.0f);
+        Matrix3Lanes r;
+        r.m[0][0] = one - two * (y * y + z * z); r.m[0][1] = two * (x * y - z * w);       r.m[0][2] = two * (x * z + y * w);
+        r.m[1][0] = two * (x * y + z * w);       r.m[1][1] = one - two * (x * x + z * z); r.m[1][2] = two * (y * z - x * w);
+        r.m[2][0] = two * (x * z - y * w);       r.m[2][1] = two * (y * z + x * w);       r.m[2][2] = one - two * (x * x + y * y);
+        return r;
+    }
+
+    // orders columns by descending key; each swap negates one column so rotations stay proper
+    void sortColumns(Float4 (&key)[3], Matrix3Lanes& a, Matrix3Lanes* b)
+    {
+        constexpr int PAIRS[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+        for (const auto& pair : PAIRS)
+        {
+            const int i = pair[0], j = pair[1];
+            const Float4 swap = key[i] < key[j];
+            const Float4 flip = swap & Float4(-0.0f);
+            const Float4 ki = key[i];
+            key[i] = select(swap, key[j], ki);
+            key[j] = select(swap, ki, key[j]);
+            for (Matrix3Lanes* m : {&a, b})
+            {
+                if (!m) { continue; }
+                for (int row = 0; row < 3; ++row)
+                {
+                    const Float4 ci = m->m[row][i];
+                    m->m[row][i] = select(swap, m->m[row][j], ci);
+                    m->m[row][j] = select(swap, ci, m->m[row][j]) ^ flip;
+                }
+            }
+        }
+    }
+
+    // Givens rotation from the left zeroing b[q][column] against b[p][column], accumulated into u
+    void qrRotate(Matrix3Lanes& b, Matrix3Lanes& u, const int p, const int q, const int column)
+    {
+        const Float4 a1 = b.m[p][column], a2 = b.m[q][column];
+        const Float4 rho2 = a1 * a1 + a2 * a2;
+        const Float4 valid = rho2 > Float4(QR_EPSILON);
+        const Float4 inv = rsqrt(max(rho2, Float4(QR_EPSILON)));
+        const Float4 c = select(valid, a1 * inv, Float4(1.0f));
+        const Float4 s = select(valid, a2 * inv, Float4(0.0f));
+
+        for (int j = 0; j < 3; ++j)
+        {
+            const Float4 bp = b.m[p][j], bq = b.m[q][j];
+            b.m[p][j] = c * bp + s * bq;
+            b.m[q][j] = c * bq - s * bp;
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            const Float4 up = u.m[i][p], uq = u.m[i][q];
+            u.m[i][p] = c * up + s * uq;
+            u.m[i][q] = c * uq - s * up;
+        }
+    }
+
+    void eigenLanes(const Matrix3Lanes& a, Float4 (&values)[3], Matrix3Lanes& vectors)
+    {
+        Matrix3Lanes s = a;
+        vectors = jacobi(s);
+        for (int i = 0; i < 3; ++i) { values[i] = s.m[i][i]; }
+        sortColumns(values, vectors, nullptr);
+    }
+
+    void svdLanes(const Matrix3Lanes& a, Matrix3Lanes& u, Float4 (&sigma)[3], Matrix3Lanes& v)
+    {
+        Matrix3Lanes s;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j) { s.m[i][j] = a.m[0][i] * a.m[0][j] + a.m[1][i] * a.m[1][j] + a.m[2][i] * a.m[2][j]; }
+        }
+        v = jacobi(s);
+
+        Matrix3Lanes b;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j) { b.m[i][j] = a.m[i][0] * v.m[0][j] + a.m[i][1] * v.m[1][j] + a.m[i][2] * v.m[2][j]; }
+        }
+
+        Float4 norms[3];
+        for (int j = 0; j < 3; ++j) { norms[j] = b.m[0][j] * b.m[0][j] + b.m[1][j] * b.m[1][j] + b.m[2][j] * b.m[2][j]; }
+        sortColumns(norms, b, &v);
+
+        for (int i = 0; i < 3; ++i) { for (int j = 0; j < 3; ++j) { u.m[i][j] = Float4(i == j ? 1.0f : 0.0f); } }
+        qrRotate(b, u, 0, 1, 0);
+        qrRotate(b, u, 0, 2, 0);
+        qrRotate(b, u, 1, 2, 1);
+        for (int i = 0; i < 3; ++i) { sigma[i] = b.m[i][i]; }
+    }
+}
+
+SymmetricEigen Kronos::CoreSystems::Math::eigenSymmetric(const Matrix3x3& a)
+{
+    SymmetricEigen result;
+    eigenSymmetric(&a, 1, &result);
+    return result;
+}
+
+SingularValueDecomposition Kronos::CoreSystems::Math::svd(const Matrix3x3& a)
+{
+    SingularValueDecomposition result;
+    svd(&a, 1, &result);
+    return result;
+}
+
+void Kronos::CoreSystems::Math::eigenSymmetric(const Matrix3x3* matrices, const std::size_t n, SymmetricEigen* out)
+{
+    Parallel::parallelFor(n, DECOMPOSE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            const std::size_t count = std::min<std::size_t>(WIDTH, end - i);
+            Float4 values[3];
+            Matrix3Lanes vectors;
+            eigenLanes(loadMatrices(matrices + i, count), values, vectors);
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                const int lane = static_cast<int>(k);
+                out[i + k] = {{values[0][lane], values[1][lane], values[2][lane]}, matrixAt(vectors, lane)};
+            }
+        }
+    });
+}
+
+void Kronos::CoreSystems::Math::svd(const Matrix3x3* matrices, const std::size_t n, SingularValueDecomposition* out)
+{
+    Parallel::parallelFor(n, DECOMPOSE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            const std::size_t count = std::min<std::size_t>(WIDTH, end - i);
+            Matrix3Lanes u, v;
+            Float4 sigma[3];
+            svdLanes(loadMatrices(matrices + i, count), u, sigma, v);
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                const int lane = static_cast<int>(k);
+                out[i + k] = {matrixAt(u, lane), {sigma[0][lane], sigma[1][lane], sigma[2][lane]}, matrixAt(v, lane)};
+            }
+        }
+    });
+}
@@ -0,0 +1,215 @@
+#include "morph_target.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Animation;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    // x, y and z lanes of one vertex group
+    constexpr std::size_t BLOCK = 3 * WIDTH;
+    // 2048 vertices: the six output streams of a chunk stay in L2 while every active target is added
+    constexpr std::size_t CHUNK_GROUPS = 512;
+    constexpr float SNORM16_MAX = 32767.0f;
+
+    Float4 loadDelta(const float* p) { return Float4::load(p); }
+
+    Float4 loadDelta(const std::int16_t* p)
+    {
+#ifdef KRONOS_SIMD_SSE2
+        const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return toFloat(Int4(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16)));
+#else
+        return toFloat(Int4(p[0], p[1], p[2], p[3]));
+#endif
+    }
+
+    Vector3 quantizationScale(const std::vector<float>& blocks)
+    {
+        float range[3] = {};
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+            const std::size_t component = i % BLOCK / WIDTH;
+            range[component] = std::max(range[component], std::fabs(blocks[i]));
+        }
+        const auto scale = [](const float r) { return r > 0.0f ? r / SNORM16_MAX : 1.0f; };
+        return {scale(range[0]), scale(range[1]), scale(range[2])};
+    }
+
+    void appendBlock(const float* block, const Vector3& scale, std::vector<float>& out, std::vector<std::int16_t>& packed, const bool quantize)
+    {
+        if (!quantize)
+        {
+            out.insert(out.end(), block, block + BLOCK);
+            return;
+        }
+        for (std::size_t i = 0; i < BLOCK; ++i)
+        {
+            const float s = (&scale.x)[i / WIDTH];
+            packed.push_back(static_cast<std::int16_t>(std::clamp(std::lround(block[i] / s), -32767l, 32767l)));
+        }
+    }
+
+    void accumulateStreams(const Float4& wx, const Float4& wy, const Float4& wz, const Float4& dx, const Float4& dy, const Float4& dz, float* x, float* y, float* z)
+    {
+        multiplyAdd(dx, wx, Float4::load(x)).store(x);
+        multiplyAdd(dy, wy, Float4::load(y)).store(y);
+        multiplyAdd(dz, wz, Float4::load(z)).store(z);
+    }
+}
+
+void VertexStreams::resize(const std::size_t n)
+{
+    for (std::vector<float>* stream : {&positionX, &positionY, &positionZ, &normalX, &normalY, &normalZ}) { stream->resize(n, 0.0f); }
+}
+
+MorphTargetSet::MorphTargetSet(const std::size_t vertexCount, const std::vector<MorphTargetDesc>& descs, const MorphDeltaFormat format, const std::uint32_t mergeGap)
+    : vertices(vertexCount), paddedVertices(roundUpToWidth(vertexCount)), chunks((paddedVertices / WIDTH + CHUNK_GROUPS - 1) / CHUNK_GROUPS), format(format)
+{
+    targets.reserve(descs.size());
+    chunkRuns.reserve(descs.size() * (chunks + 1));
+    for (const MorphTargetDesc& desc : descs) { appendTarget(desc, mergeGap); }
+}
+
+void MorphTargetSet::appendTarget(const MorphTargetDesc& desc, const std::uint32_t mergeGap)
+{
+    const bool hasNormals = !desc.normalDeltas.empty() && desc.normalDeltas.size() == desc.indices.size();
+    std::vector<std::uint32_t> order(std::min(desc.indices.size(), desc.positionDeltas.size()));
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](const std::uint32_t a, const std::uint32_t b) { return desc.indices[a] < desc.indices[b]; });
+
+    // scatter the sparse deltas into blocks of touched vertex groups; repeated indices add up
+    std::vector<std::uint32_t> groups;
+    std::vector<float> positionBlocks, normalBlocks;
+    for (const std::uint32_t k : order)
+    {
+        const std::uint32_t index = desc.indices[k];
+        if (index >= vertices) { continue; }
+        const std::uint32_t group = index / WIDTH, lane = index % WIDTH;
+        if (groups.empty() || groups.back() != group)
+        {
+            groups.push_back(group);
+            positionBlocks.resize(positionBlocks.size() + BLOCK, 0.0f);
+            if (hasNormals) { normalBlocks.resize(normalBlocks.size() + BLOCK, 0.0f); }
+        }
+        float* position = positionBlocks.data() + positionBlocks.size() - BLOCK;
+        position[lane] += desc.positionDeltas[k].x;
+        position[WIDTH + lane] += desc.positionDeltas[k].y;
+        position[2 * WIDTH + lane] += desc.positionDeltas[k].z;
+        if (!hasNormals) { continue; }
+        float* normal = normalBlocks.data() + normalBlocks.size() - BLOCK;
+        normal[lane] += desc.normalDeltas[k].x;
+        normal[WIDTH + lane] += desc.normalDeltas[k].y;
+        normal[2 * WIDTH + lane] += desc.normalDeltas[k].z;
+    }
+
+    const bool quantize = format == MorphDeltaFormat::Snorm16;
+    const Vector3 one(1.0f, 1.0f, 1.0f);
+    const Target target {quantize ? quantizationScale(positionBlocks) : one, quantize && hasNormals ? quantizationScale(normalBlocks) : one, hasNormals};
+    targets.push_back(target);
+
+    const auto blocksIn = [&](const std::vector<float>& floats, const std::vector<std::int16_t>& packed)
+    {
+        return static_cast<std::uint32_t>((quantize ? packed.size() : floats.size()) / BLOCK);
+    };
+    const float zero[BLOCK] = {};
+    const std::size_t firstRun = runs.size();
+    for (std::size_t i = 0; i < groups.size(); ++i)
+    {
+        const std::uint32_t group = groups[i];
+        Run* run = runs.size() > firstRun ? &runs.back() : nullptr;
+        const std::uint32_t runEnd = run ? run->firstGroup + run->groupCount : 0;
+        if (run && group - runEnd <= mergeGap && group / CHUNK_GROUPS == run->firstGroup / CHUNK_GROUPS)
+        {
+            // bridging a short gap with zero deltas is cheaper than starting another run
+            for (std::uint32_t g = runEnd; g < group; ++g)
+            {
+                appendBlock(zero, target.positionScale, positionDeltas, packedPositionDeltas, quantize);
+                if (hasNormals) { appendBlock(zero, target.normalScale, normalDeltas, packedNormalDeltas, quantize); }
+            }
+            run->groupCount = group + 1 - run->firstGroup;
+        }
+        else
+        {
+            runs.push_back({group, 1, blocksIn(positionDeltas, packedPositionDeltas), hasNormals ? blocksIn(normalDeltas, packedNormalDeltas) : 0});
+        }
+        appendBlock(positionBlocks.data() + i * BLOCK, target.positionScale, positionDeltas, packedPositionDeltas, quantize);
+        if (hasNormals) { appendBlock(normalBlocks.data() + i * BLOCK, target.normalScale, normalDeltas, packedNormalDeltas, quantize); }
+    }
+
+    std::size_t r = firstRun;
+    for (std::size_t c = 0; c <= chunks; ++c)
+    {
+        while (r < runs.size() && runs[r].firstGroup / CHUNK_GROUPS < c) { ++r; }
+        chunkRuns.push_back(static_cast<std::uint32_t>(r));
+    }
+}
+
+std::size_t MorphTargetSet::deltaBytes() const
+{
+    return (positionDeltas.size() + normalDeltas.size()) * sizeof(float) + (packedPositionDeltas.size() + packedNormalDeltas.size()) * sizeof(std::int16_t) +
+           runs.size() * sizeof(Run) + chunkRuns.size() * sizeof(std::uint32_t);
+}
+
+template <typename Delta>
+void MorphTargetSet::accumulate(const Run& run, const Delta* positions, const Delta* normals, const Target& target, const float weight, VertexStreams& out, const bool withNormals) const
+{
+    const Delta* d = positions + run.positionOffset * BLOCK;
+    const Float4 px(weight * target.positionScale.x), py(weight * target.positionScale.y), pz(weight * target.positionScale.z);
+    std::size_t v = run.firstGroup * WIDTH;
+    for (std::uint32_t g = 0; g < run.groupCount; ++g, d += BLOCK, v += WIDTH)
+    {
+        accumulateStreams(px, py, pz, loadDelta(d), loadDelta(d + WIDTH), loadDelta(d + 2 * WIDTH), out.positionX.data() + v, out.positionY.data() + v, out.positionZ.data() + v);
+    }
+    if (!withNormals || !target.hasNormals) { return; }
+
+    const Delta* n = normals + run.normalOffset * BLOCK;
+    const Float4 nx(weight * target.normalScale.x), ny(weight * target.normalScale.y), nz(weight * target.normalScale.z);
+    v = run.firstGroup * WIDTH;
+    for (std::uint32_t g = 0; g < run.groupCount; ++g, n += BLOCK, v += WIDTH)
+    {
+        accumulateStreams(nx, ny, nz, loadDelta(n), loadDelta(n + WIDTH), loadDelta(n + 2 * WIDTH), out.normalX.data() + v, out.normalY.data() + v, out.normalZ.data() + v);
+    }
+}
+
+void MorphTargetSet::applyChunk(const std::size_t chunk, const VertexStreams& base, const float* weights, VertexStreams& out, const float threshold) const
+{
+    const bool normals = !base.normalX.empty();
+    if (&base != &out)
+    {
+        const std::size_t begin = chunk * CHUNK_GROUPS * WIDTH, end = std::min(begin + CHUNK_GROUPS * WIDTH, paddedVertices);
+        const std::pair<const std::vector<float>*, std::vector<float>*> streams[] = {
+            {&base.positionX, &out.positionX}, {&base.positionY, &out.positionY}, {&base.positionZ, &out.positionZ},
+            {&base.normalX, &out.normalX}, {&base.normalY, &out.normalY}, {&base.normalZ, &out.normalZ}};
+        for (std::size_t s = 0; s < (normals ? 6u : 3u); ++s) { std::copy(streams[s].first->begin() + begin, streams[s].first->begin() + end, streams[s].second->begin() + begin); }
+    }
+
+    for (std::size_t t = 0; t < targets.size(); ++t)
+    {
+        const float weight = weights[t];
+        if (!(std::fabs(weight) > threshold)) { continue; }
+        const std::uint32_t* bounds = chunkRuns.data() + t * (chunks + 1) + chunk;
+        for (std::uint32_t r = bounds[0]; r < bounds[1]; ++r)
+        {
+            if (format == MorphDeltaFormat::Snorm16) { accumulate(runs[r], packedPositionDeltas.data(), packedNormalDeltas.data(), targets[t], weight, out, normals); }
+            else { accumulate(runs[r], positionDeltas.data(), normalDeltas.data(), targets[t], weight, out, normals); }
+        }
+    }
+}
+
+void MorphTargetSet::apply(const VertexStreams& base, const float* weights, VertexStreams& out, const float threshold) const
+{
+    if (&base != &out && (out.positionX.size() < paddedVertices || (!base.normalX.empty() && out.normalX.size() < paddedVertices))) { out.resize(paddedVertices); }
+    Parallel::parallelFor(chunks, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t c = begin; c < end; ++c) { applyChunk(c, base, weights, out, threshold); }
+    });
+}
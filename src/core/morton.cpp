@@ -0,0 +1,147 @@
+#include "morton.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+#include "parallel.hpp"
+#include "radix_sort.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Spatial;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr float GRID_30 = 1023.0f;
+    constexpr float GRID_63 = 2097151.0f;
+
+    Vector3 quantizeScale(const AABB& bounds, const float grid)
+    {
+        const Vector3 size = bounds.max - bounds.min;
+        return {grid / std::fmax(size.x, FLT_MIN), grid / std::fmax(size.y, FLT_MIN), grid / std::fmax(size.z, FLT_MIN)};
+    }
+
+    std::uint32_t quantize(const float v, const float min, const float scale, const float grid)
+    {
+        return static_cast<std::uint32_t>(std::clamp((v - min) * scale, 0.0f, grid));
+    }
+
+    Int4 spreadLanes(Int4 v)
+    {
+        v = v & Int4(0x3FF);
+        v = (v | v << 16) & Int4(0x030000FF);
+        v = (v | v << 8) & Int4(0x0300F00F);
+        v = (v | v << 4) & Int4(0x030C30C3);
+        v = (v | v << 2) & Int4(0x09249249);
+        return v;
+    }
+
+    struct QuantizedBlock
+    {
+        Int4 x, y, z;
+    };
+
+    QuantizedBlock quantize(const Vector3* p, const AABB& bounds, const Vector3& scale, const float grid)
+    {
+        const Float4 zero(0.0f), limit(grid);
+        const Float4 x(p[0].x, p[1].x, p[2].x, p[3].x);
+        const Float4 y(p[0].y, p[1].y, p[2].y, p[3].y);
+        const Float4 z(p[0].z, p[1].z, p[2].z, p[3].z);
+        return {truncateToInt(clamp((x - Float4(bounds.min.x)) * Float4(scale.x), zero, limit)),
+                truncateToInt(clamp((y - Float4(bounds.min.y)) * Float4(scale.y), zero, limit)),
+                truncateToInt(clamp((z - Float4(bounds.min.z)) * Float4(scale.z), zero, limit))};
+    }
+
+    thread_local Kronos::CoreSystems::Sorting::RadixSorter mortonSorter;
+}
+
+std::uint64_t Kronos::CoreSystems::Spatial::morton63(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z)
+{
+    // interleave in three 7-bit groups so every partial code fits a 32-bit lane
+    std::uint64_t code = 0;
+    for (int group = 2; group >= 0; --group)
+    {
+        const std::uint32_t shift = static_cast<std::uint32_t>(group) * 7;
+        code = code << 21 | morton30(x >> shift & 0x7F, y >> shift & 0x7F, z >> shift & 0x7F);
+    }
+    return code;
+}
+
+std::uint32_t Kronos::CoreSystems::Spatial::morton30(const Vector3& p, const AABB& bounds)
+{
+    const Vector3 scale = quantizeScale(bounds, GRID_30);
+    return morton30(quantize(p.x, bounds.min.x, scale.x, GRID_30), quantize(p.y, bounds.min.y, scale.y, GRID_30), quantize(p.z, bounds.min.z, scale.z, GRID_30));
+}
+
+std::uint64_t Kronos::CoreSystems::Spatial::morton63(const Vector3& p, const AABB& bounds)
+{
+    const Vector3 scale = quantizeScale(bounds, GRID_63);
+    return morton63(quantize(p.x, bounds.min.x, scale.x, GRID_63), quantize(p.y, bounds.min.y, scale.y, GRID_63), quantize(p.z, bounds.min.z, scale.z, GRID_63));
+}
+
+void Kronos::CoreSystems::Spatial::encodeMorton30(const Vector3* points, const std::size_t n, const AABB& bounds, std::uint32_t* codes)
+{
+    const Vector3 scale = quantizeScale(bounds, GRID_30);
+    Parallel::parallelFor(n, 8192, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            const QuantizedBlock q = quantize(points + i, bounds, scale, GRID_30);
+            (spreadLanes(q.x) | spreadLanes(q.y) << 1 | spreadLanes(q.z) << 2).store(codes + i);
+        }
+        for (; i < end; ++i) { codes[i] = morton30(quantize(points[i].x, bounds.min.x, scale.x, GRID_30), quantize(points[i].y, bounds.min.y, scale.y, GRID_30), quantize(points[i].z, bounds.min.z, scale.z, GRID_30)); }
+    });
+}
+
+void Kronos::CoreSystems::Spatial::encodeMorton63(const Vector3* points, const std::size_t n, const AABB& bounds, std::uint64_t* codes)
+{
+    const Vector3 scale = quantizeScale(bounds, GRID_63);
+    Parallel::parallelFor(n, 8192, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            const QuantizedBlock q = quantize(points + i, bounds, scale, GRID_63);
+            const Int4 seven(0x7F);
+            alignas(16) std::uint32_t parts[3][WIDTH];
+            for (int group = 0; group < 3; ++group)
+            {
+                const int shift = group * 7;
+                const Int4 part = spreadLanes(q.x >> shift & seven) | spreadLanes(q.y >> shift & seven) << 1 | spreadLanes(q.z >> shift & seven) << 2;
+                part.store(parts[group]);
+            }
+            for (int lane = 0; lane < WIDTH; ++lane)
+            {
+                codes[i + lane] = static_cast<std::uint64_t>(parts[2][lane]) << 42 | static_cast<std::uint64_t>(parts[1][lane]) << 21 | parts[0][lane];
+            }
+        }
+        for (; i < end; ++i) { codes[i] = morton63(quantize(points[i].x, bounds.min.x, scale.x, GRID_63), quantize(points[i].y, bounds.min.y, scale.y, GRID_63), quantize(points[i].z, bounds.min.z, scale.z, GRID_63)); }
+    });
+}
+
+AABB Kronos::CoreSystems::Spatial::computeBounds(const Vector3* points, const std::size_t n)
+{
+    constexpr std::size_t CHUNK = 16384;
+    const std::size_t chunks = std::max<std::size_t>(1, (n + CHUNK - 1) / CHUNK);
+    std::vector<AABB> partial(chunks, AABB({FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}));
+
+    Parallel::parallelFor(n, CHUNK, [&](const std::size_t begin, const std::size_t end)
+    {
+        AABB& box = partial[begin / CHUNK];
+        for (std::size_t i = begin; i < end; ++i) { box.min = Math::min(box.min, points[i]); box.max = Math::max(box.max, points[i]); }
+    });
+
+    AABB result = partial[0];
+    for (std::size_t c = 1; c < chunks; ++c) { result = Geometry::merge(result, partial[c]); }
+    return result;
+}
+
+void Kronos::CoreSystems::Spatial::sortByMorton(const Vector3* points, const std::size_t n, const AABB& bounds, std::uint32_t* codes, std::uint32_t* permutation)
+{
+    encodeMorton30(points, n, bounds, codes);
+    mortonSorter.sortPermutation(codes, permutation, n);
+}
@@ -0,0 +1,533 @@
+#include "narrowphase.hpp"
+
+#include <cfloat>
+#include <initializer_list>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Collision;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr int GJK_MAX_ITERATIONS = 64;
+    constexpr float GJK_TOLERANCE = 1.0e-6f;
+    constexpr float CONTACT_TOLERANCE = 1.0e-5f;
+    constexpr int EPA_MAX_ITERATIONS = 64;
+    constexpr int EPA_MAX_VERTICES = EPA_MAX_ITERATIONS + 4;
+    constexpr int EPA_MAX_FACES = 2 * EPA_MAX_VERTICES;
+    constexpr float EPA_TOLERANCE = 1.0e-4f;
+
+    struct SupportPoint
+    {
+        Vector3 w, a, b, direction;
+    };
+
+    struct Simplex
+    {
+        SupportPoint points[4];
+        float weights[4];
+        int count = 0;
+    };
+
+    SupportPoint supportPoint(const ConvexShape& a, const ConvexShape& b, const Vector3& direction, const bool core)
+    {
+        const Vector3 pa = core ? a.coreSupport(direction) : a.support(direction);
+        const Vector3 pb = core ? b.coreSupport(-direction) : b.support(-direction);
+        return {pa - pb, pa, pb, direction};
+    }
+
+    void keep(Simplex& s, const int i0, const float w0) { s.points[0] = s.points[i0]; s.weights[0] = w0; s.count = 1; }
+    void keep(Simplex& s, const int i0, const int i1, const float w0, const float w1)
+    {
+        const SupportPoint p0 = s.points[i0], p1 = s.points[i1];
+        s.points[0] = p0; s.points[1] = p1;
+        s.weights[0] = w0; s.weights[1] = w1;
+        s.count = 2;
+    }
+    void keep(Simplex& s, const int i0, const int i1, const int i2, const float w0, const float w1, const float w2)
+    {
+        const SupportPoint p0 = s.points[i0], p1 = s.points[i1], p2 = s.points[i2];
+        s.points[0] = p0; s.points[1] = p1; s.points[2] = p2;
+        s.weights[0] = w0; s.weights[1] = w1; s.weights[2] = w2;
+        s.count = 3;
+    }
+
+    Vector3 weighted(const Simplex& s)
+    {
+        Vector3 v;
+        for (int i = 0; i < s.count; ++i) { v += s.points[i].w * s.weights[i]; }
+        return v;
+    }
+
+    Vector3 closestOnSegment(Simplex& s, const int ia, const int ib)
+    {
+        const Vector3& a = s.points[ia].w;
+        const Vector3 ab = s.points[ib].w - a;
+        const float length = ab.squaredMagnitude();
+        const float t = length > FLT_MIN ? -a.dot(ab) / length : 0.0f;
+        if (t <= 0.0f) { keep(s, ia, 1.0f); }
+        else if (t >= 1.0f) { keep(s, ib, 1.0f); }
+        else { keep(s, ia, ib, 1.0f - t, t); }
+        return weighted(s);
+    }
+
+    // Ericson, Real-Time Collision Detection 5.1.5, specialised for the origin
+    Vector3 closestOnTriangle(Simplex& s, const int ia, const int ib, const int ic)
+    {
+        const Vector3& a = s.points[ia].w;
+        const Vector3& b = s.points[ib].w;
+        const Vector3& c = s.points[ic].w;
+        const Vector3 ab = b - a, ac = c - a;
+
+        const float d1 = -ab.dot(a), d2 = -ac.dot(a);
+        if (d1 <= 0.0f && d2 <= 0.0f) { keep(s, ia, 1.0f); return weighted(s); }
+
+        const float d3 = -ab.dot(b), d4 = -ac.dot(b);
+        if (d3 >= 0.0f && d4 <= d3) { keep(s, ib, 1.0f); return weighted(s); }
+
+        const float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) { const float v = d1 / (d1 - d3); keep(s, ia, ib, 1.0f - v, v); return weighted(s); }
+
+        const float d5 = -ab.dot(c), d6 = -ac.dot(c);
+        if (d6 >= 0.0f && d5 <= d6) { keep(s, ic, 1.0f); return weighted(s); }
+
+        const float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) { const float w = d2 / (d2 - d6); keep(s, ia, ic, 1.0f - w, w); return weighted(s); }
+
+        const float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+        {
+            const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            keep(s, ib, ic, 1.0f - w, w);
+            return weighted(s);
+        }
+
+        const float sum = va + vb + vc;
+        if (sum <= FLT_MIN)
+        {
+            // degenerate triangle, fall back to its best edge
+            Simplex e0 = s, e1 = s;
+            const float l0 = closestOnSegment(e0, ia, ib).squaredMagnitude();
+            const float l1 = closestOnSegment(e1, ia, ic).squaredMagnitude();
+            s = l0 <= l1 ? e0 : e1;
+            return weighted(s);
+        }
+        const float v = vb / sum, w = vc / sum;
+        keep(s, ia, ib, ic, 1.0f - v - w, v, w);
+        return weighted(s);
+    }
+
+    bool originOutsidePlane(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d)
+    {
+        const Vector3 n = (b - a).cross(c - a);
+        const float signOrigin = -a.dot(n);
+        const float signOpposite = (d - a).dot(n);
+        return signOrigin * signOpposite <= 0.0f;
+    }
+
+    Vector3 closestOnTetrahedron(Simplex& s)
+    {
+        const Vector3& a = s.points[0].w;
+        const Vector3& b = s.points[1].w;
+        const Vector3& c = s.points[2].w;
+        const Vector3& d = s.points[3].w;
+        const int faces[4][3] = {{0, 1, 2}, {0, 2, 3}, {0, 3, 1}, {1, 3, 2}};
+        const bool outside[4] = {originOutsidePlane(a, b, c, d), originOutsidePlane(a, c, d, b), originOutsidePlane(a, d, b, c), originOutsidePlane(b, d, c, a)};
+
+        if (!outside[0] && !outside[1] && !outside[2] && !outside[3])
+        {
+            s.weights[0] = s.weights[1] = s.weights[2] = s.weights[3] = 0.25f;
+            return Vector3::ZERO;
+        }
+
+        Simplex best = s;
+        float bestDistance = FLT_MAX;
+        for (int f = 0; f < 4; ++f)
+        {
+            if (!outside[f]) { continue; }
+            Simplex candidate = s;
+            const float length = closestOnTriangle(candidate, faces[f][0], faces[f][1], faces[f][2]).squaredMagnitude();
+            if (length < bestDistance) { bestDistance = length; best = candidate; }
+        }
+        s = best;
+        return weighted(s);
+    }
+
+    Vector3 closestPoint(Simplex& s)
+    {
+        switch (s.count)
+        {
+            case 1: s.weights[0] = 1.0f; return s.points[0].w;
+            case 2: return closestOnSegment(s, 0, 1);
+            case 3: return closestOnTriangle(s, 0, 1, 2);
+            default: return closestOnTetrahedron(s);
+        }
+    }
+
+    bool contains(const Simplex& s, const Vector3& w)
+    {
+        for (int i = 0; i < s.count; ++i) { if ((s.points[i].w - w).squaredMagnitude() <= FLT_EPSILON * FLT_EPSILON) { return true; } }
+        return false;
+    }
+
+    DistanceResult runGjk(const ConvexShape& a, const ConvexShape& b, SimplexCache* cache, const bool core, Simplex& s)
+    {
+        s.count = 0;
+        if (cache)
+        {
+            for (int i = 0; i < cache->count && s.count < 4; ++i)
+            {
+                const SupportPoint p = supportPoint(a, b, cache->directions[i], core);
+                if (!contains(s, p.w)) { s.points[s.count++] = p; }
+            }
+        }
+        if (s.count == 0)
+        {
+            Vector3 direction = a.position - b.position;
+            if (direction.squaredMagnitude() <= FLT_MIN) { direction = {1.0f, 0.0f, 0.0f}; }
+            s.points[s.count++] = supportPoint(a, b, -direction, core);
+        }
+
+        DistanceResult result;
+        Vector3 v = closestPoint(s);
+        for (; result.iterations < GJK_MAX_ITERATIONS; ++result.iterations)
+        {
+            const float vv = v.squaredMagnitude();
+            if (s.count == 4 || vv <= GJK_TOLERANCE * GJK_TOLERANCE) { result.intersecting = true; break; }
+
+            const SupportPoint p = supportPoint(a, b, -v, core);
+            if (vv - v.dot(p.w) <= GJK_TOLERANCE * vv || contains(s, p.w)) { break; }
+
+            const Simplex previous = s;
+            s.points[s.count++] = p;
+            const Vector3 next = closestPoint(s);
+            if (next.squaredMagnitude() >= vv) { s = previous; break; }
+            v = next;
+        }
+
+        if (cache)
+        {
+            cache->count = static_cast<std::uint8_t>(s.count);
+            for (int i = 0; i < s.count; ++i) { cache->directions[i] = s.points[i].direction; }
+        }
+
+        if (!result.intersecting)
+        {
+            for (int i = 0; i < s.count; ++i)
+            {
+                result.pointA += s.points[i].a * s.weights[i];
+                result.pointB += s.points[i].b * s.weights[i];
+            }
+            result.distance = v.magnitude();
+            result.normal = -v / result.distance;
+        }
+        return result;
+    }
+
+    struct Polytope
+    {
+        struct Face
+        {
+            int a, b, c;
+            Vector3 normal;
+            float distance;
+        };
+
+        SupportPoint vertices[EPA_MAX_VERTICES];
+        Face faces[EPA_MAX_FACES];
+        int edges[EPA_MAX_FACES * 3][2];
+        int vertexCount = 0;
+        int faceCount = 0;
+
+        bool addFace(const int a, const int b, const int c)
+        {
+            if (faceCount == EPA_MAX_FACES) { return false; }
+            Vector3 n = (vertices[b].w - vertices[a].w).cross(vertices[c].w - vertices[a].w);
+            const float length = n.magnitude();
+            const bool valid = length > FLT_MIN;
+            if (valid) { n /= length; }
+            faces[faceCount++] = {a, b, c, n, valid ? n.dot(vertices[a].w) : FLT_MAX};
+            return true;
+        }
+    };
+
+    bool expandToTetrahedron(const ConvexShape& a, const ConvexShape& b, Simplex& s)
+    {
+        const Vector3 axes[6] = {{1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+
+        for (int i = 0; i < 6 && s.count < 2; ++i)
+        {
+            const SupportPoint p = supportPoint(a, b, axes[i], false);
+            if (!contains(s, p.w)) { s.points[s.count++] = p; }
+        }
+        if (s.count == 2)
+        {
+            const Vector3 d = s.points[1].w - s.points[0].w;
+            for (int i = 0; i < 6 && s.count < 3; ++i)
+            {
+                Vector3 side = d.cross(axes[i]);
+                if (side.squaredMagnitude() <= FLT_EPSILON) { continue; }
+                const SupportPoint p = supportPoint(a, b, side, false);
+                if (d.cross(p.w - s.points[0].w).squaredMagnitude() > FLT_EPSILON * d.squaredMagnitude()) { s.points[s.count++] = p; }
+            }
+        }
+        if (s.count == 3)
+        {
+            const Vector3 n = (s.points[1].w - s.points[0].w).cross(s.points[2].w - s.points[0].w);
+            for (const float sign : {1.0f, -1.0f})
+            {
+                const SupportPoint p = supportPoint(a, b, n * sign, false);
+                if (std::fabs(n.dot(p.w - s.points[0].w)) > FLT_EPSILON * n.magnitude()) { s.points[s.count++] = p; break; }
+            }
+        }
+        return s.count == 4;
+    }
+
+    ContactResult runEpa(const ConvexShape& a, const ConvexShape& b, Simplex& s)
+    {
+        ContactResult result;
+        result.colliding = true;
+        if (!expandToTetrahedron(a, b, s)) { result.normal = {0.0f, 1.0f, 0.0f}; result.pointA = result.pointB = s.points[0].a; return result; }
+
+        Polytope poly;
+        for (int i = 0; i < 4; ++i) { poly.vertices[i] = s.points[i]; }
+        poly.vertexCount = 4;
+
+        // wind the initial faces so every normal points away from the opposite vertex
+        const int faces[4][4] = {{0, 1, 2, 3}, {0, 3, 1, 2}, {0, 2, 3, 1}, {1, 3, 2, 0}};
+        for (const auto& f : faces)
+        {
+            const Vector3 n = (poly.vertices[f[1]].w - poly.vertices[f[0]].w).cross(poly.vertices[f[2]].w - poly.vertices[f[0]].w);
+            if (n.dot(poly.vertices[f[3]].w - poly.vertices[f[0]].w) > 0.0f) { poly.addFace(f[0], f[2], f[1]); }
+            else { poly.addFace(f[0], f[1], f[2]); }
+        }
+
+        int closest = 0;
+        for (int iteration = 0; iteration < EPA_MAX_ITERATIONS; ++iteration)
+        {
+            closest = 0;
+            for (int f = 1; f < poly.faceCount; ++f) { if (poly.faces[f].distance < poly.faces[closest].distance) { closest = f; } }
+
+            const Polytope::Face face = poly.faces[closest];
+            const SupportPoint p = supportPoint(a, b, face.normal, false);
+            if (p.w.dot(face.normal) - face.distance <= EPA_TOLERANCE * std::fmax(1.0f, face.distance)) { break; }
+            if (poly.vertexCount == EPA_MAX_VERTICES) { break; }
+
+            const int index = poly.vertexCount;
+            poly.vertices[poly.vertexCount++] = p;
+
+            // remove every face the new point can see and remember the horizon edges
+            int edgeCount = 0;
+            for (int f = 0; f < poly.faceCount;)
+            {
+                const Polytope::Face& visible = poly.faces[f];
+                if (visible.normal.dot(p.w - poly.vertices[visible.a].w) <= 0.0f) { ++f; continue; }
+
+                const int edge[3][2] = {{visible.a, visible.b}, {visible.b, visible.c}, {visible.c, visible.a}};
+                for (const auto& e : edge)
+                {
+                    bool shared = false;
+                    for (int k = 0; k < edgeCount; ++k)
+                    {
+                        if (poly.edges[k][0] == e[1] && poly.edges[k][1] == e[0])
+                        {
+                            poly.edges[k][0] = poly.edges[edgeCount - 1][0];
+                            poly.edges[k][1] = poly.edges[edgeCount - 1][1];
+                            --edgeCount;
+                            shared = true;
+                            break;
+                        }
+                    }
+                    if (!shared) { poly.edges[edgeCount][0] = e[0]; poly.edges[edgeCount][1] = e[1]; ++edgeCount; }
+                }
+                poly.faces[f] = poly.faces[--poly.faceCount];
+            }
+
+            bool full = false;
+            for (int k = 0; k < edgeCount && !full; ++k) { full = !poly.addFace(poly.edges[k][0], poly.edges[k][1], index); }
+            if (full || poly.faceCount == 0) { break; }
+        }
+
+        closest = 0;
+        for (int f = 1; f < poly.faceCount; ++f) { if (poly.faces[f].distance < poly.faces[closest].distance) { closest = f; } }
+        const Polytope::Face& face = poly.faces[closest];
+
+        // barycentric coordinates of the origin's projection onto the closest face
+        const SupportPoint& pa = poly.vertices[face.a];
+        const SupportPoint& pb = poly.vertices[face.b];
+        const SupportPoint& pc = poly.vertices[face.c];
+        const Vector3 q = face.normal * face.distance;
+        const Vector3 v0 = pb.w - pa.w, v1 = pc.w - pa.w, v2 = q - pa.w;
+        const float d00 = v0.dot(v0), d01 = v0.dot(v1), d11 = v1.dot(v1), d20 = v2.dot(v0), d21 = v2.dot(v1);
+        const float denominator = d00 * d11 - d01 * d01;
+        float v = 0.0f, w = 0.0f;
+        if (std::fabs(denominator) > FLT_MIN) { v = (d11 * d20 - d01 * d21) / denominator; w = (d00 * d21 - d01 * d20) / denominator; }
+        const float u = 1.0f - v - w;
+
+        result.depth = std::fmax(face.distance, 0.0f);
+        result.normal = face.normal;
+        result.pointA = pa.a * u + pb.a * v + pc.a * w;
+        result.pointB = pa.b * u + pb.b * v + pc.b * w;
+        return result;
+    }
+}
+
+ConvexShape ConvexShape::sphere(const Vector3& center, const float radius)
+{
+    ConvexShape s;
+    s.type = ShapeType::Sphere;
+    s.position = center;
+    s.radius = radius;
+    return s;
+}
+
+ConvexShape ConvexShape::box(const Vector3& center, const Quaternion& rotation, const Vector3& halfExtents)
+{
+    ConvexShape s;
+    s.type = ShapeType::Box;
+    s.position = center;
+    s.rotation = rotation;
+    s.halfExtents = halfExtents;
+    return s;
+}
+
+ConvexShape ConvexShape::capsule(const Vector3& center, const Quaternion& rotation, const float halfHeight, const float radius)
+{
+    ConvexShape s;
+    s.type = ShapeType::Capsule;
+    s.position = center;
+    s.rotation = rotation;
+    s.halfHeight = halfHeight;
+    s.radius = radius;
+    return s;
+}
+
+ConvexShape ConvexShape::convexHull(const Vector3& position, const Quaternion& rotation, const Vector3* vertices, const std::uint32_t count)
+{
+    ConvexShape s;
+    s.type = ShapeType::ConvexHull;
+    s.position = position;
+    s.rotation = rotation;
+    s.vertices = vertices;
+    s.vertexCount = count;
+    return s;
+}
+
+Vector3 ConvexShape::coreSupport(const Vector3& direction) const
+{
+    switch (type)
+    {
+        case ShapeType::Sphere:
+            return position;
+        case ShapeType::Capsule:
+        {
+            const Vector3 local = rotation.conjugate().rotate(direction);
+            return position + rotation.rotate({0.0f, local.y >= 0.0f ? halfHeight : -halfHeight, 0.0f});
+        }
+        case ShapeType::Box:
+        {
+            const Vector3 local = rotation.conjugate().rotate(direction);
+            return position + rotation.rotate({local.x >= 0.0f ? halfExtents.x : -halfExtents.x,
+                                               local.y >= 0.0f ? halfExtents.y : -halfExtents.y,
+                                               local.z >= 0.0f ? halfExtents.z : -halfExtents.z});
+        }
+        case ShapeType::ConvexHull:
+        {
+            using namespace Kronos::CoreSystems::Simd;
+            const Vector3 local = rotation.conjugate().rotate(direction);
+            const Float4 dx(local.x), dy(local.y), dz(local.z);
+            Float4 best(-FLT_MAX);
+            Int4 bestIndex(0);
+            Int4 index(0, 1, 2, 3);
+            std::uint32_t i = 0;
+            for (; i + WIDTH <= vertexCount; i += WIDTH, index = index + Int4(WIDTH))
+            {
+                const Vector3* v = vertices + i;
+                const Float4 d = dot3(Float4(v[0].x, v[1].x, v[2].x, v[3].x), Float4(v[0].y, v[1].y, v[2].y, v[3].y), Float4(v[0].z, v[1].z, v[2].z, v[3].z), dx, dy, dz);
+                const Float4 better = d > best;
+                best = select(better, d, best);
+                bestIndex = select(asInt(better), index, bestIndex);
+            }
+
+            float bestDot = -FLT_MAX;
+            std::uint32_t bestVertex = 0;
+            for (int lane = 0; lane < WIDTH && i > 0; ++lane) { if (best[lane] > bestDot) { bestDot = best[lane]; bestVertex = static_cast<std::uint32_t>(bestIndex[lane]); } }
+            for (; i < vertexCount; ++i) { if (const float d = vertices[i].dot(local); d > bestDot) { bestDot = d; bestVertex = i; } }
+            return position + rotation.rotate(vertices[bestVertex]);
+        }
+    }
+    return position;
+}
+
+Vector3 ConvexShape::support(const Vector3& direction) const
+{
+    const float m = margin();
+    if (m == 0.0f) { return coreSupport(direction); }
+    Vector3 n = direction;
+    n.normalize();
+    return coreSupport(direction) + n * m;
+}
+
+DistanceResult Kronos::CoreSystems::Collision::distance(const ConvexShape& a, const ConvexShape& b, SimplexCache* cache)
+{
+    Simplex s;
+    DistanceResult result = runGjk(a, b, cache, true, s);
+    if (result.intersecting) { return result; }
+
+    // spheres and capsules are swept points and segments, so GJK runs on the core and the radii are applied afterwards
+    const float ma = a.margin(), mb = b.margin();
+    result.pointA += result.normal * ma;
+    result.pointB -= result.normal * mb;
+    result.distance -= ma + mb;
+    if (result.distance <= 0.0f) { result.distance = 0.0f; result.intersecting = true; }
+    return result;
+}
+
+bool Kronos::CoreSystems::Collision::intersect(const ConvexShape& a, const ConvexShape& b, SimplexCache* cache)
+{
+    return distance(a, b, cache).intersecting;
+}
+
+ContactResult Kronos::CoreSystems::Collision::penetration(const ConvexShape& a, const ConvexShape& b, SimplexCache* cache)
+{
+    Simplex s;
+    const DistanceResult core = runGjk(a, b, cache, true, s);
+    const float margins = a.margin() + b.margin();
+
+    ContactResult result;
+    if (!core.intersecting)
+    {
+        // cores closer than the tolerance touch: EPA has no simplex around the origin to start from, so the
+        // witness normal stands with a depth of minus the gap
+        if (core.distance > margins && core.distance > CONTACT_TOLERANCE) { return result; }
+        result.colliding = true;
+        result.depth = margins - core.distance;
+        result.normal = core.normal;
+        result.pointA = core.pointA + core.normal * a.margin();
+        result.pointB = core.pointB - core.normal * b.margin();
+        return result;
+    }
+
+    // the cores overlap, so the full shapes need an enclosing simplex for EPA
+    runGjk(a, b, nullptr, false, s);
+    return runEpa(a, b, s);
+}
+
+void Kronos::CoreSystems::Collision::distanceBatch(const ConvexShape* a, const ConvexShape* b, SimplexCache* caches, DistanceResult* results, const std::size_t count)
+{
+    Parallel::parallelFor(count, 64, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { results[i] = distance(a[i], b[i], caches ? caches + i : nullptr); }
+    });
+}
+
+void Kronos::CoreSystems::Collision::penetrationBatch(const ConvexShape* a, const ConvexShape* b, SimplexCache* caches, ContactResult* results, const std::size_t count)
+{
+    Parallel::parallelFor(count, 64, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { results[i] = penetration(a[i], b[i], caches ? caches + i : nullptr); }
+    });
+}
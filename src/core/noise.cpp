@@ -0,0 +1,483 @@
+#include "noise.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Noise;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Vector2;
+using Kronos::CoreSystems::Math::Vector3;
+using Kronos::CoreSystems::Math::Vector4;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    constexpr std::size_t SAMPLE_GRAIN = 1024;
+
+    constexpr std::int32_t PRIMES[4] = {501125321, 1136930381, 1720413743, 1066037191};
+    constexpr std::int32_t HASH_MULTIPLIER = 0x27d4eb2d;
+    constexpr std::int32_t JITTER_MULTIPLIER = 0x1b56c4e9;
+    constexpr std::uint32_t JITTER_STREAM = 0x68e31da4u;
+    constexpr std::uint32_t OCTAVE_SEED_STEP = 0x9e3779b9u;
+    constexpr std::int32_t SIGN_MASK = static_cast<std::int32_t>(0x80000000u);
+    constexpr std::int32_t FLOAT_ONE_BITS = 0x3f800000;
+
+    // simplex skew and unskew factors (sqrt(D + 1) - 1) / D and (1 - 1 / sqrt(D + 1)) / D, and the
+    // squared kernel radius, indexed by dimension
+    constexpr float SIMPLEX_SKEW[5] = {0.0f, 0.0f, 0.3660254038f, 1.0f / 3.0f, 0.3090169944f};
+    constexpr float SIMPLEX_UNSKEW[5] = {0.0f, 0.0f, 0.2113248654f, 1.0f / 6.0f, 0.1381966011f};
+    constexpr float SIMPLEX_RADIUS_SQUARED[5] = {0.0f, 0.0f, 0.5f, 0.5f, 0.5f};
+
+    // bring the peaks of each gradient noise to about one
+    constexpr float PERLIN_SCALE[5] = {0.0f, 0.0f, 1.0f, 0.9f, 0.8f};
+    constexpr float SIMPLEX_SCALE[5] = {0.0f, 0.0f, 66.0f, 60.0f, 52.0f};
+
+    constexpr float MIN_DISTANCE = 1e-12f;
+
+    template <typename Vector>
+    constexpr int DIMENSION = sizeof(Vector) / sizeof(float);
+
+    constexpr int power3(const int d) { return d == 0 ? 1 : 3 * power3(d - 1); }
+
+    Int4 finalize(const Int4& h)
+    {
+        const Int4 m = h * Int4(HASH_MULTIPLIER);
+        return m ^ (m >> 15);
+    }
+
+    // Lattice gradients with components of +-1, zero on at most one axis: bits 8-23 pick the zeroed axis
+    // (or none) and the top bits the signs.
+    template <int D>
+    void latticeGradient(const Int4& h, Float4* g)
+    {
+        const Int4 zeroAxis = (((h >> 8) & Int4(0xffff)) * Int4(D + 1)) >> 16;
+        for (int k = 0; k < D; ++k)
+        {
+            const Float4 sign = asFloat((h << k) & Int4(SIGN_MASK));
+            g[k] = andNot(asFloat(zeroAxis == Int4(k)), Float4(1.0f) ^ sign);
+        }
+    }
+
+    // uniform in [0, 1) from the mantissa bits of a rehash
+    Float4 jitter(const Int4& h, const int stream)
+    {
+        const Int4 r = (h ^ Int4(static_cast<std::int32_t>(JITTER_STREAM * static_cast<std::uint32_t>(stream)))) * Int4(JITTER_MULTIPLIER);
+        return asFloat((r >> 9) | Int4(FLOAT_ONE_BITS)) - Float4(1.0f);
+    }
+
+    template <int D>
+    Float4 perlinLanes(const Float4* p, const Int4& seed, Float4* derivative)
+    {
+        Int4 lower[D], upper[D];
+        Float4 f[D], u[D], v[D], du[D];
+        for (int k = 0; k < D; ++k)
+        {
+            const Float4 cell = floor(p[k]);
+            f[k] = p[k] - cell;
+            // quintic fade 6f^5 - 15f^4 + 10f^3 and its derivative 30f^2 (f - 1)^2
+            u[k] = f[k] * f[k] * f[k] * multiplyAdd(f[k], multiplyAdd(f[k], Float4(6.0f), Float4(-15.0f)), Float4(10.0f));
+            v[k] = Float4(1.0f) - u[k];
+            const Float4 g = f[k] - Float4(1.0f);
+            du[k] = Float4(30.0f) * f[k] * f[k] * g * g;
+            lower[k] = truncateToInt(cell) * Int4(PRIMES[k]);
+            upper[k] = lower[k] + Int4(PRIMES[k]);
+        }
+
+        Float4 value;
+        if (derivative) { std::fill(derivative, derivative + D, Float4()); }
+        for (int corner = 0; corner < (1 << D); ++corner)
+        {
+            Int4 h = seed;
+            for (int k = 0; k < D; ++k) { h = h ^ ((corner >> k & 1) ? upper[k] : lower[k]); }
+            Float4 g[D];
+            latticeGradient<D>(finalize(h), g);
+
+            Float4 dot, weight(1.0f);
+            for (int k = 0; k < D; ++k)
+            {
+                const bool high = corner >> k & 1;
+                dot = multiplyAdd(g[k], high ? f[k] - Float4(1.0f) : f[k], dot);
+                weight = weight * (high ? u[k] : v[k]);
+            }
+            value = multiplyAdd(weight, dot, value);
+
+            if (derivative)
+            {
+                for (int k = 0; k < D; ++k)
+                {
+                    Float4 partial = (corner >> k & 1) ? du[k] : -du[k];
+                    for (int j = 0; j < D; ++j)
+                    {
+                        if (j != k) { partial = partial * ((corner >> j & 1) ? u[j] : v[j]); }
+                    }
+                    derivative[k] = derivative[k] + multiplyAdd(weight, g[k], partial * dot);
+                }
+            }
+        }
+
+        const Float4 scale(PERLIN_SCALE[D]);
+        if (derivative) { for (int k = 0; k < D; ++k) { derivative[k] = derivative[k] * scale; } }
+        return value * scale;
+    }
+
+    template <int D>
+    Float4 simplexLanes(const Float4* p, const Int4& seed, Float4* derivative)
+    {
+        Float4 skew;
+        for (int k = 0; k < D; ++k) { skew = skew + p[k]; }
+        skew = skew * Float4(SIMPLEX_SKEW[D]);
+
+        Float4 cell[D], unskew;
+        Int4 primed[D];
+        for (int k = 0; k < D; ++k)
+        {
+            cell[k] = floor(p[k] + skew);
+            primed[k] = truncateToInt(cell[k]) * Int4(PRIMES[k]);
+            unskew = unskew + cell[k];
+        }
+        unskew = unskew * Float4(SIMPLEX_UNSKEW[D]);
+
+        // the simplex holding the point steps along the axes in decreasing order of their offsets,
+        // and rank counts how many axes an offset exceeds
+        Float4 origin[D];
+        Int4 rank[D];
+        for (int k = 0; k < D; ++k) { origin[k] = p[k] - (cell[k] - unskew); }
+        for (int j = 0; j < D; ++j)
+        {
+            for (int k = j + 1; k < D; ++k)
+            {
+                const Int4 greater = asInt(origin[j] > origin[k]);
+                rank[j] = rank[j] - greater;
+                rank[k] = rank[k] + greater + Int4(1);
+            }
+        }
+
+        Float4 value;
+        if (derivative) { std::fill(derivative, derivative + D, Float4()); }
+        for (int vertex = 0; vertex <= D; ++vertex)
+        {
+            Int4 h = seed;
+            Float4 d[D], falloff(SIMPLEX_RADIUS_SQUARED[D]);
+            for (int k = 0; k < D; ++k)
+            {
+                const Int4 step = vertex == 0 ? Int4(0) : vertex == D ? Int4(-1) : rank[k] > Int4(D - vertex - 1);
+                h = h ^ (primed[k] + (step & Int4(PRIMES[k])));
+                d[k] = origin[k] - (asFloat(step) & Float4(1.0f)) + Float4(vertex * SIMPLEX_UNSKEW[D]);
+                falloff = falloff - d[k] * d[k];
+            }
+            Float4 g[D];
+            latticeGradient<D>(finalize(h), g);
+
+            Float4 dot;
+            for (int k = 0; k < D; ++k) { dot = multiplyAdd(g[k], d[k], dot); }
+            const Float4 t = max(falloff, Float4()), t2 = t * t, t4 = t2 * t2;
+            value = multiplyAdd(t4, dot, value);
+
+            if (derivative)
+            {
+                // d/dp of t^4 (g . d) is t^4 g - 8 t^3 (g . d) d
+                const Float4 radial = Float4(-8.0f) * t2 * t * dot;
+                for (int k = 0; k < D; ++k) { derivative[k] = derivative[k] + multiplyAdd(t4, g[k], radial * d[k]); }
+            }
+        }
+
+        const Float4 scale(SIMPLEX_SCALE[D]);
+        if (derivative) { for (int k = 0; k < D; ++k) { derivative[k] = derivative[k] * scale; } }
+        return value * scale;
+    }
+
+    // distance to the nearest of one jittered feature point per cell over the 3^D neighbourhood
+    template <int D>
+    Float4 worleyLanes(const Float4* p, const Int4& seed, Float4* derivative)
+    {
+        Int4 primed[D];
+        Float4 f[D];
+        for (int k = 0; k < D; ++k)
+        {
+            const Float4 cell = floor(p[k]);
+            f[k] = p[k] - cell;
+            primed[k] = truncateToInt(cell) * Int4(PRIMES[k]);
+        }
+
+        Float4 best(3.0e38f), nearest[D];
+        for (int neighbour = 0; neighbour < power3(D); ++neighbour)
+        {
+            Int4 h = seed;
+            int offsets[D];
+            for (int k = 0, code = neighbour; k < D; ++k, code /= 3)
+            {
+                offsets[k] = code % 3 - 1;
+                h = h ^ (primed[k] + Int4(static_cast<std::int32_t>(static_cast<std::uint32_t>(offsets[k]) * static_cast<std::uint32_t>(PRIMES[k]))));
+            }
+            h = finalize(h);
+
+            Float4 delta[D], distance;
+            for (int k = 0; k < D; ++k)
+            {
+                delta[k] = Float4(static_cast<float>(offsets[k])) + jitter(h, k) - f[k];
+                distance = multiplyAdd(delta[k], delta[k], distance);
+            }
+            if (derivative)
+            {
+                const Float4 closer = distance < best;
+                for (int k = 0; k < D; ++k) { nearest[k] = select(closer, delta[k], nearest[k]); }
+            }
+            best = min(best, distance);
+        }
+
+        const Float4 f1 = sqrt(best);
+        if (derivative)
+        {
+            const Float4 scale = Float4(-1.0f) / max(f1, Float4(MIN_DISTANCE));
+            for (int k = 0; k < D; ++k) { derivative[k] = nearest[k] * scale; }
+        }
+        return f1;
+    }
+
+    template <int D>
+    Float4 noiseLanes(const NoiseType type, const Float4* p, const Int4& seed, Float4* derivative)
+    {
+        switch (type)
+        {
+        case NoiseType::Perlin: return perlinLanes<D>(p, seed, derivative);
+        case NoiseType::Worley: return worleyLanes<D>(p, seed, derivative);
+        default: return simplexLanes<D>(p, seed, derivative);
+        }
+    }
+
+    template <int D>
+    Float4 fractalLanes(const NoiseDesc& desc, const Float4* p, Float4* derivative)
+    {
+        const std::uint32_t octaves = desc.fractal == FractalType::None ? 1 : std::max(desc.octaves, 1u);
+        float frequency = desc.frequency, amplitude = 1.0f, total = 0.0f;
+        Float4 sum;
+        if (derivative) { std::fill(derivative, derivative + D, Float4()); }
+        for (std::uint32_t octave = 0; octave < octaves; ++octave)
+        {
+            Float4 q[D], g[D];
+            for (int k = 0; k < D; ++k) { q[k] = p[k] * Float4(frequency); }
+            const Int4 seed(static_cast<std::int32_t>(static_cast<std::uint32_t>(desc.seed) + octave * OCTAVE_SEED_STEP));
+            Float4 n = noiseLanes<D>(desc.type, q, seed, derivative ? g : nullptr);
+
+            if (desc.fractal == FractalType::Ridged)
+            {
+                // (1 - |n|)^2 with derivative -2 (1 - |n|) sign(n) dn
+                const Float4 ridge = Float4(1.0f) - abs(n);
+                if (derivative)
+                {
+                    const Float4 slope = Float4(-2.0f) * ridge * ((n & Float4(-0.0f)) | Float4(1.0f));
+                    for (int k = 0; k < D; ++k) { g[k] = g[k] * slope; }
+                }
+                n = ridge * ridge;
+            }
+
+            sum = multiplyAdd(n, Float4(amplitude), sum);
+            if (derivative)
+            {
+                const Float4 chain(amplitude * frequency);
+                for (int k = 0; k < D; ++k) { derivative[k] = multiplyAdd(g[k], chain, derivative[k]); }
+            }
+            total += amplitude;
+            frequency *= desc.lacunarity;
+            amplitude *= desc.gain;
+        }
+
+        const Float4 normalize(total > 0.0f ? 1.0f / total : 1.0f);
+        if (derivative) { for (int k = 0; k < D; ++k) { derivative[k] = derivative[k] * normalize; } }
+        return sum * normalize;
+    }
+
+    template <typename Vector>
+    float evaluatePoint(const NoiseType type, const Vector& p, const std::int32_t seed, Vector* gradient)
+    {
+        constexpr int D = DIMENSION<Vector>;
+        Float4 q[D], g[D];
+        for (int k = 0; k < D; ++k) { q[k] = Float4((&p.x)[k]); }
+        const Float4 value = noiseLanes<D>(type, q, Int4(seed), gradient ? g : nullptr);
+        if (gradient) { for (int k = 0; k < D; ++k) { (&gradient->x)[k] = g[k][0]; } }
+        return value[0];
+    }
+
+    template <typename Vector>
+    float samplePoint(const NoiseDesc& desc, const Vector& p, Vector* gradient)
+    {
+        constexpr int D = DIMENSION<Vector>;
+        Float4 q[D], g[D];
+        for (int k = 0; k < D; ++k) { q[k] = Float4((&p.x)[k]); }
+        const Float4 value = fractalLanes<D>(desc, q, gradient ? g : nullptr);
+        if (gradient) { for (int k = 0; k < D; ++k) { (&gradient->x)[k] = g[k][0]; } }
+        return value[0];
+    }
+
+    // writes the first count lanes of a SIMD group
+    template <typename Vector>
+    void storeLanes(const Float4& value, const Float4* g, const std::size_t count, float* out, Vector* gradients)
+    {
+        constexpr int D = DIMENSION<Vector>;
+        if (count == WIDTH) { value.store(out); }
+        else
+        {
+            float lanes[WIDTH];
+            value.store(lanes);
+            std::copy(lanes, lanes + count, out);
+        }
+        if (gradients)
+        {
+            float lanes[D][WIDTH];
+            for (int k = 0; k < D; ++k) { g[k].store(lanes[k]); }
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                for (int k = 0; k < D; ++k) { (&gradients[lane].x)[k] = lanes[k][lane]; }
+            }
+        }
+    }
+
+    // one grid row along x; q holds the row's other coordinates from index 1 on
+    template <typename Vector>
+    void fillRow(const NoiseDesc& desc, Float4* q, const float originX, const float stepX, const std::uint32_t width, float* out, Vector* gradients)
+    {
+        Float4 g[DIMENSION<Vector>];
+        const Float4 lanes(0.0f, 1.0f, 2.0f, 3.0f);
+        for (std::uint32_t x = 0; x < width; x += WIDTH)
+        {
+            q[0] = multiplyAdd(Float4(static_cast<float>(x)) + lanes, Float4(stepX), Float4(originX));
+            const Float4 value = fractalLanes<DIMENSION<Vector>>(desc, q, gradients ? g : nullptr);
+            storeLanes(value, g, std::min<std::size_t>(WIDTH, width - x), out + x, gradients ? gradients + x : nullptr);
+        }
+    }
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::perlin(const Vector& p, const std::int32_t seed)
+{
+    return evaluatePoint<Vector>(NoiseType::Perlin, p, seed, nullptr);
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::perlin(const Vector& p, Vector& gradient, const std::int32_t seed)
+{
+    return evaluatePoint(NoiseType::Perlin, p, seed, &gradient);
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::simplex(const Vector& p, const std::int32_t seed)
+{
+    return evaluatePoint<Vector>(NoiseType::Simplex, p, seed, nullptr);
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::simplex(const Vector& p, Vector& gradient, const std::int32_t seed)
+{
+    return evaluatePoint(NoiseType::Simplex, p, seed, &gradient);
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::worley(const Vector& p, const std::int32_t seed)
+{
+    return evaluatePoint<Vector>(NoiseType::Worley, p, seed, nullptr);
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::worley(const Vector& p, Vector& gradient, const std::int32_t seed)
+{
+    return evaluatePoint(NoiseType::Worley, p, seed, &gradient);
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::sample(const NoiseDesc& desc, const Vector& p)
+{
+    return samplePoint<Vector>(desc, p, nullptr);
+}
+
+template <typename Vector>
+float Kronos::CoreSystems::Noise::sample(const NoiseDesc& desc, const Vector& p, Vector& gradient)
+{
+    return samplePoint(desc, p, &gradient);
+}
+
+template <typename Vector>
+void Kronos::CoreSystems::Noise::sample(const NoiseDesc& desc, const Vector* points, const std::size_t n, float* out, Vector* gradients)
+{
+    constexpr int D = DIMENSION<Vector>;
+    Parallel::parallelFor(n, SAMPLE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            // a partial group repeats its last point
+            const std::size_t count = std::min<std::size_t>(WIDTH, end - i);
+            float lanes[D][WIDTH];
+            for (std::size_t lane = 0; lane < WIDTH; ++lane)
+            {
+                const Vector& point = points[i + std::min(lane, count - 1)];
+                for (int k = 0; k < D; ++k) { lanes[k][lane] = (&point.x)[k]; }
+            }
+            Float4 q[D], g[D];
+            for (int k = 0; k < D; ++k) { q[k] = Float4::load(lanes[k]); }
+            const Float4 value = fractalLanes<D>(desc, q, gradients ? g : nullptr);
+            storeLanes(value, g, count, out + i, gradients ? gradients + i : nullptr);
+        }
+    });
+}
+
+void Kronos::CoreSystems::Noise::fill(const NoiseDesc& desc, const Vector2& origin, const Vector2& step, const std::uint32_t width, const std::uint32_t height,
+                                      float* out, Vector2* gradients)
+{
+    Parallel::parallelFor(height, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t y = begin; y < end; ++y)
+        {
+            Float4 q[2];
+            q[1] = Float4(origin.y + static_cast<float>(y) * step.y);
+            const std::size_t row = y * width;
+            fillRow(desc, q, origin.x, step.x, width, out + row, gradients ? gradients + row : nullptr);
+        }
+    });
+}
+
+void Kronos::CoreSystems::Noise::fill(const NoiseDesc& desc, const Vector3& origin, const Vector3& step, const std::uint32_t width, const std::uint32_t height,
+                                      const std::uint32_t depth, float* out, Vector3* gradients)
+{
+    Parallel::parallelFor(static_cast<std::size_t>(height) * depth, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t r = begin; r < end; ++r)
+        {
+            Float4 q[3];
+            q[1] = Float4(origin.y + static_cast<float>(r % height) * step.y);
+            q[2] = Float4(origin.z + static_cast<float>(r / height) * step.z);
+            const std::size_t row = r * width;
+            fillRow(desc, q, origin.x, step.x, width, out + row, gradients ? gradients + row : nullptr);
+        }
+    });
+}
+
+template float Kronos::CoreSystems::Noise::perlin<Vector2>(const Vector2&, std::int32_t);
+template float Kronos::CoreSystems::Noise::perlin<Vector2>(const Vector2&, Vector2&, std::int32_t);
+template float Kronos::CoreSystems::Noise::simplex<Vector2>(const Vector2&, std::int32_t);
+template float Kronos::CoreSystems::Noise::simplex<Vector2>(const Vector2&, Vector2&, std::int32_t);
+template float Kronos::CoreSystems::Noise::worley<Vector2>(const Vector2&, std::int32_t);
+template float Kronos::CoreSystems::Noise::worley<Vector2>(const Vector2&, Vector2&, std::int32_t);
+template float Kronos::CoreSystems::Noise::sample<Vector2>(const NoiseDesc&, const Vector2&);
+template float Kronos::CoreSystems::Noise::sample<Vector2>(const NoiseDesc&, const Vector2&, Vector2&);
+template void Kronos::CoreSystems::Noise::sample<Vector2>(const NoiseDesc&, const Vector2*, std::size_t, float*, Vector2*);
+
+template float Kronos::CoreSystems::Noise::perlin<Vector3>(const Vector3&, std::int32_t);
+template float Kronos::CoreSystems::Noise::perlin<Vector3>(const Vector3&, Vector3&, std::int32_t);
+template float Kronos::CoreSystems::Noise::simplex<Vector3>(const Vector3&, std::int32_t);
+template float Kronos::CoreSystems::Noise::simplex<Vector3>(const Vector3&, Vector3&, std::int32_t);
+template float Kronos::CoreSystems::Noise::worley<Vector3>(const Vector3&, std::int32_t);
+template float Kronos::CoreSystems::Noise::worley<Vector3>(const Vector3&, Vector3&, std::int32_t);
+template float Kronos::CoreSystems::Noise::sample<Vector3>(const NoiseDesc&, const Vector3&);
+template float Kronos::CoreSystems::Noise::sample<Vector3>(const NoiseDesc&, const Vector3&, Vector3&);
+template void Kronos::CoreSystems::Noise::sample<Vector3>(const NoiseDesc&, const Vector3*, std::size_t, float*, Vector3*);
+
+template float Kronos::CoreSystems::Noise::perlin<Vector4>(const Vector4&, std::int32_t);
+template float Kronos::CoreSystems::Noise::perlin<Vector4>(const Vector4&, Vector4&, std::int32_t);
+template float Kronos::CoreSystems::Noise::simplex<Vector4>(const Vector4&, std::int32_t);
+template float Kronos::CoreSystems::Noise::simplex<Vector4>(const Vector4&, Vector4&, std::int32_t);
+template float Kronos::CoreSystems::Noise::worley<Vector4>(const Vector4&, std::int32_t);
+template float Kronos::CoreSystems::Noise::worley<Vector4>(const Vector4&, Vector4&, std::int32_t);
+template float Kronos::CoreSystems::Noise::sample<Vector4>(const NoiseDesc&, const Vector4&);
+template float Kronos::CoreSystems::Noise::sample<Vector4>(const NoiseDesc&, const Vector4&, Vector4&);
+template void Kronos::CoreSystems::Noise::sample<Vector4>(const NoiseDesc&, const Vector4*, std::size_t, float*, Vector4*);
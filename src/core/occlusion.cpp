@@ -0,0 +1,382 @@
+#include "occlusion.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    constexpr int BIN_COLUMNS = 4;
+    constexpr int BIN_ROWS = 4;
+    constexpr int BIN_COUNT = BIN_COLUMNS * BIN_ROWS;
+    constexpr std::size_t BATCH_TRIANGLES = 1024;
+    constexpr std::size_t BOX_GRAIN = 64;
+    // 1/w stays finite for geometry clipped to this distance in front of the eye
+    constexpr float NEAR_W = 1e-4f;
+    // one triangle clipped by five planes gains at most five vertices
+    constexpr int MAX_CLIPPED = 8;
+    constexpr int PLANE_COUNT = 5;
+
+    // signed distances to w >= NEAR_W and the four side planes -w <= x, y <= w
+    float planeDistance(const float* v, const int plane)
+    {
+        switch (plane)
+        {
+            case 0: return v[3] - NEAR_W;
+            case 1: return v[3] + v[0];
+            case 2: return v[3] - v[0];
+            case 3: return v[3] + v[1];
+            default: return v[3] - v[1];
+        }
+    }
+
+    // Sutherland-Hodgman against one plane; returns the new vertex count
+    int clipPolygon(const float (*in)[4], const int count, const int plane, float (*out)[4])
+    {
+        int n = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const float* a = in[i];
+            const float* b = in[(i + 1) % count];
+            const float da = planeDistance(a, plane), db = planeDistance(b, plane);
+            if (da >= 0.0f) { std::copy(a, a + 4, out[n++]); }
+            if ((da >= 0.0f) != (db >= 0.0f))
+            {
+                const float t = da / (da - db);
+                for (int k = 0; k < 4; ++k) { out[n][k] = a[k] + (b[k] - a[k]) * t; }
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    // exact for the whole numbers 0..8 the coverage masks need
+    Float4 pow2(const Float4& n) { return asFloat((truncateToInt(n) + Int4(127)) << 23); }
+
+    Float4 ceil(const Float4& a) { return -floor(-a); }
+
+    const Float4& subtileOffsets()
+    {
+        static const Float4 offsets(0.0f, 8.0f, 16.0f, 24.0f);
+        return offsets;
+    }
+}
+
+MaskedOcclusionBuffer::MaskedOcclusionBuffer(const std::uint32_t width, const std::uint32_t height)
+    : screenWidth(width), screenHeight(height),
+      tilesX(static_cast<std::int32_t>((width + TILE_WIDTH - 1) / TILE_WIDTH)), tilesY(static_cast<std::int32_t>((height + TILE_HEIGHT - 1) / TILE_HEIGHT)),
+      tiles(static_cast<std::size_t>(tilesX) * tilesY)
+{
+    clear();
+}
+
+void MaskedOcclusionBuffer::clear()
+{
+    const Tile empty {{0, 0, 0, 0}, {{0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 0.0f}}};
+    std::fill(tiles.begin(), tiles.end(), empty);
+}
+
+void MaskedOcclusionBuffer::setupTriangle(const float (&clip)[3][4], const CullMode cull, const std::size_t batch)
+{
+    float sx[3], sy[3], sz[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        const float inverseW = 1.0f / clip[i][3];
+        sx[i] = (clip[i][0] * inverseW * 0.5f + 0.5f) * static_cast<float>(screenWidth);
+        sy[i] = (0.5f - clip[i][1] * inverseW * 0.5f) * static_cast<float>(screenHeight);
+        sz[i] = inverseW;
+    }
+
+    // screen y points down, so counter-clockwise triangles in device coordinates have negative area here
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    const bool front = area < 0.0f;
+    if ((cull == CullMode::Back && !front) || (cull == CullMode::Front && front) || !(std::fabs(area) > 1e-8f)) { return; }
+    if (area < 0.0f)
+    {
+        std::swap(sx[1], sx[2]);
+        std::swap(sy[1], sy[2]);
+        std::swap(sz[1], sz[2]);
+        area = -area;
+    }
+
+    TriangleSetup t;
+    for (int i = 0; i < 3; ++i)
+    {
+        const int j = (i + 1) % 3;
+        t.edgeA[i] = sy[i] - sy[j];
+        t.edgeB[i] = sx[j] - sx[i];
+        t.edgeC[i] = -(t.edgeA[i] * sx[i] + t.edgeB[i] * sy[i]);
+    }
+    const float inverseArea = 1.0f / area;
+    t.zx = ((sz[1] - sz[0]) * (sy[2] - sy[0]) - (sz[2] - sz[0]) * (sy[1] - sy[0])) * inverseArea;
+    t.zy = ((sx[1] - sx[0]) * (sz[2] - sz[0]) - (sx[2] - sx[0]) * (sz[1] - sz[0])) * inverseArea;
+    t.z0 = sz[0] - t.zx * sx[0] - t.zy * sy[0];
+    t.zFar = std::min({sz[0], sz[1], sz[2]});
+    t.zNear = std::max({sz[0], sz[1], sz[2]});
+
+    const auto toPixel = [](const float v, const std::uint32_t size) { return std::clamp(static_cast<std::int32_t>(std::floor(v)), 0, static_cast<std::int32_t>(size) - 1); };
+    t.tileMinX = toPixel(std::min({sx[0], sx[1], sx[2]}), screenWidth) / TILE_WIDTH;
+    t.tileMaxX = toPixel(std::max({sx[0], sx[1], sx[2]}), screenWidth) / TILE_WIDTH;
+    t.tileMinY = toPixel(std::min({sy[0], sy[1], sy[2]}), screenHeight) / TILE_HEIGHT;
+    t.tileMaxY = toPixel(std::max({sy[0], sy[1], sy[2]}), screenHeight) / TILE_HEIGHT;
+
+    std::vector<TriangleSetup>& triangles = batchTriangles[batch];
+    const std::uint32_t index = static_cast<std::uint32_t>(triangles.size());
+    triangles.push_back(t);
+    const int binMinX = t.tileMinX * BIN_COLUMNS / tilesX, binMaxX = t.tileMaxX * BIN_COLUMNS / tilesX;
+    const int binMinY = t.tileMinY * BIN_ROWS / tilesY, binMaxY = t.tileMaxY * BIN_ROWS / tilesY;
+    for (int by = binMinY; by <= binMaxY; ++by)
+    {
+        for (int bx = binMinX; bx <= binMaxX; ++bx) { batchBins[batch * BIN_COUNT + by * BIN_COLUMNS + bx].push_back(index); }
+    }
+}
+
+void MaskedOcclusionBuffer::rasterize(const TriangleSetup& t, const std::int32_t minX, const std::int32_t minY, const std::int32_t maxX, const std::int32_t maxY)
+{
+    const Float4 zero(0.0f), eight(static_cast<float>(SUBTILE_WIDTH)), rowCentres(0.5f, 1.5f, 2.5f, 3.5f);
+    const Int4 none(0), all(-1);
+    float inverseA[3];
+    for (int e = 0; e < 3; ++e) { inverseA[e] = t.edgeA[e] != 0.0f ? 1.0f / t.edgeA[e] : 0.0f; }
+    const Float4 extent(std::fabs(t.zx) * 3.5f + std::fabs(t.zy) * 1.5f);
+
+    for (std::int32_t ty = minY; ty <= maxY; ++ty)
+    {
+        const float top = static_cast<float>(ty * TILE_HEIGHT);
+
+        // the triangle covers the pixel columns [first, last) of each row, one row per lane; pixel k is
+        // inside an edge when a (k + 0.5) + b y + c >= 0
+        const Float4 y = Float4(top) + rowCentres;
+        const Float4 right(static_cast<float>(screenWidth));
+        Float4 first(0.0f), last = right;
+        for (int e = 0; e < 3; ++e)
+        {
+            const Float4 s = multiplyAdd(Float4(t.edgeB[e]), y, Float4(t.edgeC[e]));
+            const Float4 crossing = -s * Float4(inverseA[e]) - Float4(0.5f);
+            if (t.edgeA[e] > 0.0f) { first = max(first, ceil(min(crossing, right))); }
+            else if (t.edgeA[e] < 0.0f) { last = min(last, floor(max(crossing, Float4(-1.0f))) + Float4(1.0f)); }
+            else { last = select(s < zero, zero, last); }
+        }
+        const Float4 rows = last > first;
+        if (moveMask(rows) == 0) { continue; }
+        const float spanMin = reduceMin(select(rows, first, Float4(INFINITY))), spanMax = reduceMax(select(rows, last, zero));
+        float rowFirst[TILE_HEIGHT], rowLast[TILE_HEIGHT];
+        first.store(rowFirst);
+        last.store(rowLast);
+
+        const std::int32_t tileMinX = std::max(minX, static_cast<std::int32_t>(spanMin) / TILE_WIDTH);
+        const std::int32_t tileMaxX = std::min(maxX, (static_cast<std::int32_t>(spanMax) - 1) / TILE_WIDTH);
+        for (std::int32_t tx = tileMinX; tx <= tileMaxX; ++tx)
+        {
+            // first pixel column of each subtile, one subtile per lane
+            const Float4 left = Float4(static_cast<float>(tx * TILE_WIDTH)) + subtileOffsets();
+
+            Tile& tile = tiles[static_cast<std::size_t>(ty) * tilesX + tx];
+            const Float4 z0 = Float4::load(tile.zMin[0]), z1 = Float4::load(tile.zMin[1]);
+
+            // farthest and nearest depth of the triangle over the subtile's pixel centres; subtiles where
+            // the triangle is entirely behind layer 0 learn nothing
+            const Float4 centre = multiplyAdd(Float4(t.zx), left + Float4(4.0f), Float4(t.zy * (top + 2.0f) + t.z0));
+            const Float4 zFar = max(centre - extent, Float4(t.zFar)), zNear = min(centre + extent, Float4(t.zNear));
+            const Float4 inFront = zNear > z0;
+            if (moveMask(inFront) == 0) { continue; }
+
+            // each row span becomes 2^end - 2^start, i.e. the bits start..end-1 of the subtile row
+            Int4 coverage = none;
+            for (int row = 0; row < TILE_HEIGHT; ++row)
+            {
+                const Float4 start = min(max(Float4(rowFirst[row]) - left, zero), eight);
+                const Float4 end = min(max(Float4(rowLast[row]) - left, zero), eight);
+                coverage = coverage | (truncateToInt(max(pow2(end) - pow2(start), zero)) << (row * SUBTILE_WIDTH));
+            }
+
+            const Int4 triangle = select(asInt(inFront), coverage, none);
+            const Float4 active = andNot(asFloat(triangle == none), asFloat(all));
+            if (moveMask(active) == 0) { continue; }
+
+            // a triangle nearer to layer 0 than to layer 1 restarts layer 1 instead of dragging it back
+            const Int4 mask = Int4::load(tile.mask);
+            const Float4 restart = asFloat(mask == none) | ((z1 - zFar) > (zFar - z0));
+            const Float4 mergedZ = select(restart, zFar, min(z1, zFar));
+            const Int4 merged = select(asInt(restart), triangle, mask | triangle);
+            const Float4 full = asFloat(merged == all);
+
+            select(active, select(full, max(z0, mergedZ), z0), z0).store(tile.zMin[0]);
+            select(active, mergedZ, z1).store(tile.zMin[1]);
+            select(asInt(active), select(asInt(full), none, merged), mask).store(tile.mask);
+        }
+    }
+}
+
+void MaskedOcclusionBuffer::renderOccluders(const OccluderMesh* meshes, const std::size_t n, const Matrix4x4& m, const CullMode cull)
+{
+    std::vector<std::size_t> firstTriangle(n + 1, 0);
+    for (std::size_t i = 0; i < n; ++i) { firstTriangle[i + 1] = firstTriangle[i] + meshes[i].triangleCount; }
+    const std::size_t batches = (firstTriangle[n] + BATCH_TRIANGLES - 1) / BATCH_TRIANGLES;
+    batchTriangles.resize(std::max(batchTriangles.size(), batches));
+    batchBins.resize(std::max(batchBins.size(), batches * BIN_COUNT));
+
+    const Float4 c0(m.m00, m.m10, m.m20, m.m30), c1(m.m01, m.m11, m.m21, m.m31), c2(m.m02, m.m12, m.m22, m.m32), c3(m.m03, m.m13, m.m23, m.m33);
+    Parallel::parallelFor(batches, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t batch = begin; batch < end; ++batch)
+        {
+            batchTriangles[batch].clear();
+            for (int bin = 0; bin < BIN_COUNT; ++bin) { batchBins[batch * BIN_COUNT + bin].clear(); }
+
+            const std::size_t first = batch * BATCH_TRIANGLES, last = std::min(first + BATCH_TRIANGLES, firstTriangle[n]);
+            std::size_t mesh = std::upper_bound(firstTriangle.begin(), firstTriangle.end(), first) - firstTriangle.begin() - 1;
+            for (std::size_t global = first; global < last; ++global)
+            {
+                while (global >= firstTriangle[mesh + 1]) { ++mesh; }
+                const OccluderMesh& source = meshes[mesh];
+                const std::uint32_t* index = source.indices + 3 * (global - firstTriangle[mesh]);
+
+                float clip[3][4];
+                int inside = 0, outside[PLANE_COUNT] = {};
+                for (int v = 0; v < 3; ++v)
+                {
+                    const Vector3& p = source.vertices[index[v]];
+                    multiplyAdd(c0, Float4(p.x), multiplyAdd(c1, Float4(p.y), multiplyAdd(c2, Float4(p.z), c3))).store(clip[v]);
+                    for (int plane = 0; plane < PLANE_COUNT; ++plane)
+                    {
+                        const bool out = planeDistance(clip[v], plane) < 0.0f;
+                        outside[plane] += out;
+                        inside += out;
+                    }
+                }
+                if (std::any_of(outside, outside + PLANE_COUNT, [](const int count) { return count == 3; })) { continue; }
+                if (inside == 0)
+                {
+                    setupTriangle(clip, cull, batch);
+                    continue;
+                }
+
+                float polygon[2][MAX_CLIPPED][4];
+                int count = 3;
+                std::copy(&clip[0][0], &clip[0][0] + 12, &polygon[0][0][0]);
+                for (int plane = 0; plane < PLANE_COUNT && count >= 3; ++plane)
+                {
+                    count = clipPolygon(polygon[plane & 1], count, plane, polygon[(plane + 1) & 1]);
+                }
+                const float (*clipped)[4] = polygon[PLANE_COUNT & 1];
+                for (int k = 1; k + 1 < count; ++k)
+                {
+                    float fan[3][4];
+                    std::copy(clipped[0], clipped[0] + 4, fan[0]);
+                    std::copy(clipped[k], clipped[k] + 4, fan[1]);
+                    std::copy(clipped[k + 1], clipped[k + 1] + 4, fan[2]);
+                    setupTriangle(fan, cull, batch);
+                }
+            }
+        }
+    });
+
+    // each bin owns a rectangle of tiles, so bins rasterize without sharing any tile
+    Parallel::parallelFor(BIN_COUNT, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t bin = begin; bin < end; ++bin)
+        {
+            const int bx = static_cast<int>(bin) % BIN_COLUMNS, by = static_cast<int>(bin) / BIN_COLUMNS;
+            const std::int32_t binMinX = (bx * tilesX + BIN_COLUMNS - 1) / BIN_COLUMNS, binMaxX = ((bx + 1) * tilesX + BIN_COLUMNS - 1) / BIN_COLUMNS - 1;
+            const std::int32_t binMinY = (by * tilesY + BIN_ROWS - 1) / BIN_ROWS, binMaxY = ((by + 1) * tilesY + BIN_ROWS - 1) / BIN_ROWS - 1;
+            for (std::size_t batch = 0; batch < batches; ++batch)
+            {
+                for (const std::uint32_t i : batchBins[batch * BIN_COUNT + bin])
+                {
+                    const TriangleSetup& t = batchTriangles[batch][i];
+                    rasterize(t, std::max(t.tileMinX, binMinX), std::max(t.tileMinY, binMinY), std::min(t.tileMaxX, binMaxX), std::min(t.tileMaxY, binMaxY));
+                }
+            }
+        }
+    });
+}
+
+bool MaskedOcclusionBuffer::testRect(const float minX, const float minY, const float maxX, const float maxY, const float zNear) const
+{
+    // clamped while still floats, as far off screen bounds do not fit an int
+    const float right = static_cast<float>(screenWidth - 1), bottom = static_cast<float>(screenHeight - 1);
+    if (!(minX <= right && maxX >= 0.0f && minY <= bottom && maxY >= 0.0f && minX <= maxX && minY <= maxY)) { return false; }
+    const std::int32_t px0 = static_cast<std::int32_t>(std::floor(std::max(minX, 0.0f)));
+    const std::int32_t py0 = static_cast<std::int32_t>(std::floor(std::max(minY, 0.0f)));
+    const std::int32_t px1 = static_cast<std::int32_t>(std::floor(std::min(maxX, right)));
+    const std::int32_t py1 = static_cast<std::int32_t>(std::floor(std::min(maxY, bottom)));
+
+    const Float4 depth(zNear), first(static_cast<float>(px0)), last(static_cast<float>(px1));
+    for (std::int32_t ty = py0 / TILE_HEIGHT; ty <= py1 / TILE_HEIGHT; ++ty)
+    {
+        for (std::int32_t tx = px0 / TILE_WIDTH; tx <= px1 / TILE_WIDTH; ++tx)
+        {
+            const Float4 subtileLeft = Float4(static_cast<float>(tx * TILE_WIDTH)) + subtileOffsets();
+            const Float4 overlaps = (subtileLeft <= last) & (subtileLeft + Float4(SUBTILE_WIDTH - 1) >= first);
+            const Tile& tile = tiles[static_cast<std::size_t>(ty) * tilesX + tx];
+            if (moveMask(overlaps & (depth > Float4::load(tile.zMin[0]))) != 0) { return true; }
+        }
+    }
+    return false;
+}
+
+bool MaskedOcclusionBuffer::isVisible(const AABB& box, const Matrix4x4& m) const
+{
+    // corners 0-3 on the min z face and 4-7 on the max z face
+    const Float4 x(box.min.x, box.max.x, box.min.x, box.max.x), y(box.min.y, box.min.y, box.max.y, box.max.y);
+    const Float4 partialX = multiplyAdd(Float4(m.m00), x, multiplyAdd(Float4(m.m01), y, Float4(m.m03)));
+    const Float4 partialY = multiplyAdd(Float4(m.m10), x, multiplyAdd(Float4(m.m11), y, Float4(m.m13)));
+    const Float4 partialZ = multiplyAdd(Float4(m.m20), x, multiplyAdd(Float4(m.m21), y, Float4(m.m23)));
+    const Float4 partialW = multiplyAdd(Float4(m.m30), x, multiplyAdd(Float4(m.m31), y, Float4(m.m33)));
+
+    Float4 minX(INFINITY), minY(INFINITY), maxX(-INFINITY), maxY(-INFINITY), nearest(0.0f);
+    int behind = 0;
+    for (const float z : {box.min.z, box.max.z})
+    {
+        const Float4 cx = multiplyAdd(Float4(m.m02), Float4(z), partialX);
+        const Float4 cy = multiplyAdd(Float4(m.m12), Float4(z), partialY);
+        const Float4 cz = multiplyAdd(Float4(m.m22), Float4(z), partialZ);
+        const Float4 cw = multiplyAdd(Float4(m.m32), Float4(z), partialW);
+        // in front of the near plane when z >= -w
+        behind += std::popcount(static_cast<unsigned>(moveMask((cz < -cw) | (cw <= Float4(NEAR_W)))));
+        const Float4 inverseW = Float4(1.0f) / max(cw, Float4(NEAR_W));
+        minX = min(minX, cx * inverseW);
+        maxX = max(maxX, cx * inverseW);
+        minY = min(minY, cy * inverseW);
+        maxY = max(maxY, cy * inverseW);
+        nearest = max(nearest, inverseW);
+    }
+    if (behind == 8) { return false; }
+    if (behind > 0) { return true; }
+
+    const float w = static_cast<float>(screenWidth), h = static_cast<float>(screenHeight);
+    return testRect((reduceMin(minX) * 0.5f + 0.5f) * w, (0.5f - reduceMax(maxY) * 0.5f) * h,
+                    (reduceMax(maxX) * 0.5f + 0.5f) * w, (0.5f - reduceMin(minY) * 0.5f) * h, reduceMax(nearest));
+}
+
+void MaskedOcclusionBuffer::testBoxes(const AABB* boxes, const std::size_t n, const Matrix4x4& viewProjection, std::uint8_t* visible) const
+{
+    Parallel::parallelFor(n, BOX_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { visible[i] = isVisible(boxes[i], viewProjection) ? 1 : 0; }
+    });
+}
+
+void MaskedOcclusionBuffer::resolveDepth(float* out) const
+{
+    for (std::uint32_t y = 0; y < screenHeight; ++y)
+    {
+        for (std::uint32_t x = 0; x < screenWidth; ++x)
+        {
+            const Tile& tile = tiles[static_cast<std::size_t>(y / TILE_HEIGHT) * tilesX + x / TILE_WIDTH];
+            const std::uint32_t lane = x % TILE_WIDTH / SUBTILE_WIDTH, bit = y % TILE_HEIGHT * SUBTILE_WIDTH + x % SUBTILE_WIDTH;
+            const bool covered = tile.mask[lane] >> bit & 1;
+            out[static_cast<std::size_t>(y) * screenWidth + x] = covered ? std::max(tile.zMin[0][lane], tile.zMin[1][lane]) : tile.zMin[0][lane];
+        }
+    }
+}
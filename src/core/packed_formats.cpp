@@ -0,0 +1,310 @@
+#include "packed_formats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+#if defined(__F16C__)
+#define KRONOS_SIMD_F16C 1
+#include <immintrin.h>
+#endif
+
+using namespace Kronos::CoreSystems::Compression;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Vector3;
+using Kronos::CoreSystems::Math::Vector4;
+
+namespace
+{
+    constexpr std::size_t PACK_GRAIN = 16384;
+    constexpr float SNORM16 = 32767.0f;
+    constexpr float SNORM10 = 511.0f;
+
+    std::uint32_t bitsOf(const float f) { std::uint32_t u; std::memcpy(&u, &f, sizeof(u)); return u; }
+    float floatOf(const std::uint32_t u) { float f; std::memcpy(&f, &u, sizeof(f)); return f; }
+
+    // round-to-nearest-even float to binary16 without tables (F. Giesen, "float->half variants")
+    Int4 floatToHalfLanes(const Float4& f)
+    {
+        const Int4 bits = asInt(f);
+        const Int4 sign = bits & Int4(static_cast<std::int32_t>(0x80000000u));
+        const Int4 u = bits ^ sign;
+
+        const Int4 special = select(u > Int4(0x7F800000), Int4(0x7E00), Int4(0x7C00));
+        const Int4 denormal = asInt(asFloat(u) + Float4(0.5f)) - Int4(0x3F000000);
+        const Int4 normal = (u + Int4(static_cast<std::int32_t>(0xC8000FFFu)) + (u >> 13 & Int4(1))) >> 13;
+
+        const Int4 result = select(u > Int4(0x477FFFFF), special, select(u > Int4(0x387FFFFF), normal, denormal));
+        return result | sign >> 16;
+    }
+
+    Float4 halfToFloatLanes(const Int4& h)
+    {
+        const Int4 shifted = (h & Int4(0x7FFF)) << 13;
+        const Int4 exponent = shifted & Int4(0x0F800000);
+        const Int4 rebased = shifted + Int4(0x38000000);
+
+        const Int4 special = rebased + Int4(0x38000000);
+        const Int4 denormal = asInt(asFloat(rebased + Int4(1 << 23)) - Float4(floatOf(0x38800000)));
+        const Int4 result = select(exponent == Int4(0x0F800000), special, select(exponent == Int4(0), denormal, rebased));
+        return asFloat(result | (h & Int4(0x8000)) << 16);
+    }
+
+    Float4 signOf(const Float4& v) { return (v & Float4(-0.0f)) | Float4(1.0f); }
+
+    void octahedralLanes(const Float4& x, const Float4& y, const Float4& z, Int4& outX, Int4& outY)
+    {
+        const Float4 inv = Float4(1.0f) / max(abs(x) + abs(y) + abs(z), Float4(1e-20f));
+        const Float4 px = x * inv, py = y * inv;
+        // the lower hemisphere is folded over the diagonals of the upper one
+        const Float4 lower = z < Float4(0.0f);
+        const Float4 ox = select(lower, (Float4(1.0f) - abs(py)) * signOf(px), px);
+        const Float4 oy = select(lower, (Float4(1.0f) - abs(px)) * signOf(py), py);
+        outX = roundToInt(clamp(ox, Float4(-1.0f), Float4(1.0f)) * Float4(SNORM16));
+        outY = roundToInt(clamp(oy, Float4(-1.0f), Float4(1.0f)) * Float4(SNORM16));
+    }
+
+    void unfoldLanes(const Int4& qx, const Int4& qy, Float4& x, Float4& y, Float4& z)
+    {
+        x = max(toFloat(qx) * Float4(1.0f / SNORM16), Float4(-1.0f));
+        y = max(toFloat(qy) * Float4(1.0f / SNORM16), Float4(-1.0f));
+        z = Float4(1.0f) - abs(x) - abs(y);
+        const Float4 t = max(-z, Float4(0.0f));
+        x = x - t * signOf(x);
+        y = y - t * signOf(y);
+        const Float4 inv = rsqrt(multiplyAdd(x, x, multiplyAdd(y, y, z * z)));
+        x = x * inv; y = y * inv; z = z * inv;
+    }
+
+    Int4 snormLanes(const Float4& v, const float scale, const std::int32_t mask)
+    {
+        return roundToInt(clamp(v, Float4(-1.0f), Float4(1.0f)) * Float4(scale)) & Int4(mask);
+    }
+
+    Float4 unsnormLanes(const Int4& bits, const std::int32_t signBit, const float scale)
+    {
+        // sign-extends a narrow two's complement field: (v ^ s) - s
+        const Int4 value = (bits ^ Int4(signBit)) - Int4(signBit);
+        return max(toFloat(value) * Float4(1.0f / scale), Float4(-1.0f));
+    }
+
+    Int4 pack1010102Lanes(const Float4& x, const Float4& y, const Float4& z, const Float4& w)
+    {
+        return snormLanes(x, SNORM10, 0x3FF) | snormLanes(y, SNORM10, 0x3FF) << 10 | snormLanes(z, SNORM10, 0x3FF) << 20 | snormLanes(w, 1.0f, 0x3) << 30;
+    }
+
+    void unpack1010102Lanes(const Int4& bits, Float4& x, Float4& y, Float4& z, Float4& w)
+    {
+        x = unsnormLanes(bits & Int4(0x3FF), 0x200, SNORM10);
+        y = unsnormLanes(bits >> 10 & Int4(0x3FF), 0x200, SNORM10);
+        z = unsnormLanes(bits >> 20 & Int4(0x3FF), 0x200, SNORM10);
+        w = unsnormLanes(bits >> 30, 0x2, 1.0f);
+    }
+
+    Float4 lane(const float v) { return Float4(v, 0.0f, 0.0f, 0.0f); }
+}
+
+std::uint16_t Kronos::CoreSystems::Compression::floatToHalf(const float f)
+{
+    const std::uint32_t u = bitsOf(f);
+    const std::uint32_t sign = u & 0x80000000u;
+    const std::uint32_t magnitude = u ^ sign;
+
+    std::uint32_t result;
+    if (magnitude >= 0x47800000u) { result = magnitude > 0x7F800000u ? 0x7E00 : 0x7C00; }
+    else if (magnitude < 0x38800000u) { result = bitsOf(floatOf(magnitude) + 0.5f) - 0x3F000000u; }
+    else { result = (magnitude + 0xC8000FFFu + (magnitude >> 13 & 1)) >> 13; }
+    return static_cast<std::uint16_t>(result | sign >> 16);
+}
+
+float Kronos::CoreSystems::Compression::halfToFloat(const std::uint16_t h)
+{
+    const std::uint32_t shifted = (h & 0x7FFFu) << 13;
+    const std::uint32_t exponent = shifted & 0x0F800000u;
+    std::uint32_t result = shifted + 0x38000000u;
+    if (exponent == 0x0F800000u) { result += 0x38000000u; }
+    else if (exponent == 0) { result = bitsOf(floatOf(result + (1u << 23)) - floatOf(0x38800000u)); }
+    return floatOf(result | (h & 0x8000u) << 16);
+}
+
+Half3 Kronos::CoreSystems::Compression::toHalf3(const Vector3& v)
+{
+    return {floatToHalf(v.x), floatToHalf(v.y), floatToHalf(v.z)};
+}
+
+Half4 Kronos::CoreSystems::Compression::toHalf4(const Vector4& v)
+{
+    return {floatToHalf(v.x), floatToHalf(v.y), floatToHalf(v.z), floatToHalf(v.w)};
+}
+
+Vector3 Kronos::CoreSystems::Compression::toVector3(const Half3& h)
+{
+    return {halfToFloat(h.x), halfToFloat(h.y), halfToFloat(h.z)};
+}
+
+Vector4 Kronos::CoreSystems::Compression::toVector4(const Half4& h)
+{
+    return {halfToFloat(h.x), halfToFloat(h.y), halfToFloat(h.z), halfToFloat(h.w)};
+}
+
+OctahedralNormal Kronos::CoreSystems::Compression::encodeOctahedral(const Vector3& n)
+{
+    Int4 x, y;
+    octahedralLanes(lane(n.x), lane(n.y), lane(n.z), x, y);
+    return {static_cast<std::int16_t>(x[0]), static_cast<std::int16_t>(y[0])};
+}
+
+Vector3 Kronos::CoreSystems::Compression::decodeOctahedral(const OctahedralNormal& p)
+{
+    Float4 x, y, z;
+    unfoldLanes(Int4(p.x), Int4(p.y), x, y, z);
+    return {x[0], y[0], z[0]};
+}
+
+PackedNormal1010102 Kronos::CoreSystems::Compression::encode1010102(const Vector3& n, const float w)
+{
+    return {static_cast<std::uint32_t>(pack1010102Lanes(lane(n.x), lane(n.y), lane(n.z), lane(w))[0])};
+}
+
+Vector4 Kronos::CoreSystems::Compression::decode1010102(const PackedNormal1010102& p)
+{
+    Float4 x, y, z, w;
+    unpack1010102Lanes(Int4(static_cast<std::int32_t>(p.bits)), x, y, z, w);
+    return {x[0], y[0], z[0], w[0]};
+}
+
+void Kronos::CoreSystems::Compression::encodeHalves(const float* in, const std::size_t n, std::uint16_t* out)
+{
+    Parallel::parallelFor(n, PACK_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+#ifdef KRONOS_SIMD_F16C
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_ph(_mm_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+#else
+            alignas(16) std::int32_t lanes[WIDTH];
+            floatToHalfLanes(Float4::load(in + i)).store(lanes);
+            for (int k = 0; k < WIDTH; ++k) { out[i + k] = static_cast<std::uint16_t>(lanes[k]); }
+#endif
+        }
+        for (; i < end; ++i) { out[i] = floatToHalf(in[i]); }
+    });
+}
+
+void Kronos::CoreSystems::Compression::decodeHalves(const std::uint16_t* in, const std::size_t n, float* out)
+{
+    Parallel::parallelFor(n, PACK_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+#ifdef KRONOS_SIMD_F16C
+            _mm_storeu_ps(out + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i))));
+#else
+            halfToFloatLanes(Int4(in[i], in[i + 1], in[i + 2], in[i + 3])).store(out + i);
+#endif
+        }
+        for (; i < end; ++i) { out[i] = halfToFloat(in[i]); }
+    });
+}
+
+void Kronos::CoreSystems::Compression::encodeHalf3(const Vector3* in, const std::size_t n, Half3* out)
+{
+    static_assert(sizeof(Vector3) == 3 * sizeof(float) && sizeof(Half3) == 3 * sizeof(std::uint16_t));
+    encodeHalves(&in->x, n * 3, &out->x);
+}
+
+void Kronos::CoreSystems::Compression::decodeHalf3(const Half3* in, const std::size_t n, Vector3* out)
+{
+    decodeHalves(&in->x, n * 3, &out->x);
+}
+
+void Kronos::CoreSystems::Compression::encodeHalf4(const Vector4* in, const std::size_t n, Half4* out)
+{
+    static_assert(sizeof(Vector4) == 4 * sizeof(float) && sizeof(Half4) == 4 * sizeof(std::uint16_t));
+    encodeHalves(&in->x, n * 4, &out->x);
+}
+
+void Kronos::CoreSystems::Compression::decodeHalf4(const Half4* in, const std::size_t n, Vector4* out)
+{
+    decodeHalves(&in->x, n * 4, &out->x);
+}
+
+void Kronos::CoreSystems::Compression::encodeOctahedral(const float* x, const float* y, const float* z, const std::size_t n, OctahedralNormal* out)
+{
+    Parallel::parallelFor(n, PACK_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            Int4 ox, oy;
+            octahedralLanes(Float4::load(x + i), Float4::load(y + i), Float4::load(z + i), ox, oy);
+            alignas(16) std::int32_t lanesX[WIDTH], lanesY[WIDTH];
+            ox.store(lanesX);
+            oy.store(lanesY);
+            for (int k = 0; k < WIDTH; ++k) { out[i + k] = {static_cast<std::int16_t>(lanesX[k]), static_cast<std::int16_t>(lanesY[k])}; }
+        }
+        for (; i < end; ++i) { out[i] = encodeOctahedral(Vector3(x[i], y[i], z[i])); }
+    });
+}
+
+void Kronos::CoreSystems::Compression::decodeOctahedral(const OctahedralNormal* in, const std::size_t n, float* x, float* y, float* z)
+{
+    Parallel::parallelFor(n, PACK_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            Float4 nx, ny, nz;
+            unfoldLanes(Int4(in[i].x, in[i + 1].x, in[i + 2].x, in[i + 3].x), Int4(in[i].y, in[i + 1].y, in[i + 2].y, in[i + 3].y), nx, ny, nz);
+            nx.store(x + i);
+            ny.store(y + i);
+            nz.store(z + i);
+        }
+        for (; i < end; ++i)
+        {
+            const Vector3 v = decodeOctahedral(in[i]);
+            x[i] = v.x; y[i] = v.y; z[i] = v.z;
+        }
+    });
+}
+
+void Kronos::CoreSystems::Compression::encode1010102(const float* x, const float* y, const float* z, const float* w, const std::size_t n, PackedNormal1010102* out)
+{
+    Parallel::parallelFor(n, PACK_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            const Float4 lanesW = w ? Float4::load(w + i) : Float4(1.0f);
+            pack1010102Lanes(Float4::load(x + i), Float4::load(y + i), Float4::load(z + i), lanesW).store(&out[i].bits);
+        }
+        for (; i < end; ++i) { out[i] = encode1010102(Vector3(x[i], y[i], z[i]), w ? w[i] : 1.0f); }
+    });
+}
+
+void Kronos::CoreSystems::Compression::decode1010102(const PackedNormal1010102* in, const std::size_t n, float* x, float* y, float* z, float* w)
+{
+    Parallel::parallelFor(n, PACK_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            Float4 nx, ny, nz, nw;
+            unpack1010102Lanes(Int4::load(&in[i].bits), nx, ny, nz, nw);
+            nx.store(x + i);
+            ny.store(y + i);
+            nz.store(z + i);
+            nw.store(w + i);
+        }
+        for (; i < end; ++i)
+        {
+            const Vector4 v = decode1010102(in[i]);
+            x[i] = v.x; y[i] = v.y; z[i] = v.z; w[i] = v.w;
+        }
+    });
+}
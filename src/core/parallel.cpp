@@ -0,0 +1,135 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    thread_local bool insideJob = false;
+
+    class ThreadPool
+    {
+    public:
+        ThreadPool()
+        {
+            const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned i = 1; i < hardware; ++i) { workers.emplace_back([this] { workerLoop(); }); }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& worker : workers) { worker.join(); }
+        }
+
+        unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+        bool tryRun(const std::size_t count, const std::size_t grain, const RangeFunction function, void* context)
+        {
+            std::unique_lock submitLock(submitMutex, std::try_to_lock);
+            if (!submitLock.owns_lock()) { return false; }
+
+            {
+                std::lock_guard lock(mutex);
+                jobFunction = function;
+                jobContext = context;
+                jobCount = count;
+                jobGrain = grain;
+                nextIndex.store(0, std::memory_order_relaxed);
+                activeWorkers = static_cast<unsigned>(workers.size());
+                ++generation;
+            }
+            wake.notify_all();
+
+            runChunks();
+
+            std::unique_lock lock(mutex);
+            done.wait(lock, [this] { return activeWorkers == 0; });
+            return true;
+        }
+
+    private:
+        void runChunks()
+        {
+            insideJob = true;
+            for (;;)
+            {
+                const std::size_t begin = nextIndex.fetch_add(jobGrain, std::memory_order_relaxed);
+                if (begin >= jobCount) { break; }
+                jobFunction(jobContext, begin, std::min(begin + jobGrain, jobCount));
+            }
+            insideJob = false;
+        }
+
+        void workerLoop()
+        {
+            std::uint64_t seen = 0;
+            for (;;)
+            {
+                {
+                    std::unique_lock lock(mutex);
+                    wake.wait(lock, [&] { return stopping || generation != seen; });
+                    if (stopping) { return; }
+                    seen = generation;
+                }
+
+                runChunks();
+
+                {
+                    std::lock_guard lock(mutex);
+                    --activeWorkers;
+                }
+                done.notify_one();
+            }
+        }
+
+        std::vector<std::thread> workers;
+        std::mutex submitMutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::uint64_t generation = 0;
+        unsigned activeWorkers = 0;
+        bool stopping = false;
+
+        RangeFunction jobFunction = nullptr;
+        void* jobContext = nullptr;
+        std::size_t jobCount = 0;
+        std::size_t jobGrain = 1;
+        std::atomic<std::size_t> nextIndex {0};
+    };
+
+    ThreadPool& pool()
+    {
+        static ThreadPool instance;
+        return instance;
+    }
+}
+
+unsigned Kronos::CoreSystems::Parallel::workerCount()
+{
+    return pool().size();
+}
+
+void Kronos::CoreSystems::Parallel::dispatch(const std::size_t count, const std::size_t grain, const RangeFunction function, void* context)
+{
+    if (count == 0) { return; }
+    const std::size_t step = std::max<std::size_t>(grain, 1);
+
+    // nested or concurrent submissions run inline on the calling thread
+    if (count <= step || insideJob || !pool().tryRun(count, step, function, context))
+    {
+        function(context, 0, count);
+    }
+}
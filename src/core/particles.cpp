@@ -0,0 +1,139 @@
+#include "particles.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Particles;
+using namespace Kronos::CoreSystems::Simd;
+
+void ParticleStreams::resize(const std::size_t n)
+{
+    for (std::vector<float>* stream : {&positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ,
+                                       &colorR, &colorG, &colorB, &colorA, &age, &lifetime})
+    {
+        stream->assign(n, 0.0f);
+    }
+}
+
+ParticleEmitter::ParticleEmitter(const std::size_t capacity, const std::uint32_t seed) : maxCount(capacity), state(seed ? seed : 1)
+{
+    particles.resize(roundUpToWidth(capacity));
+}
+
+float ParticleEmitter::nextSigned()
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return static_cast<float>(state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+std::size_t ParticleEmitter::emit(const std::size_t n, const EmissionParams& params)
+{
+    const std::size_t emitted = std::min(n, maxCount - count);
+    for (std::size_t i = count; i < count + emitted; ++i)
+    {
+        particles.positionX[i] = params.origin.x + params.extent.x * nextSigned();
+        particles.positionY[i] = params.origin.y + params.extent.y * nextSigned();
+        particles.positionZ[i] = params.origin.z + params.extent.z * nextSigned();
+        particles.velocityX[i] = params.velocity.x + params.velocitySpread * nextSigned();
+        particles.velocityY[i] = params.velocity.y + params.velocitySpread * nextSigned();
+        particles.velocityZ[i] = params.velocity.z + params.velocitySpread * nextSigned();
+        particles.colorR[i] = params.color.x;
+        particles.colorG[i] = params.color.y;
+        particles.colorB[i] = params.color.z;
+        particles.colorA[i] = params.color.w;
+        particles.age[i] = 0.0f;
+        particles.lifetime[i] = params.lifetime;
+    }
+    count += emitted;
+    return emitted;
+}
+
+void ParticleEmitter::simulate(const float dt, const ForceField& forces)
+{
+    const Float4 step(dt);
+    const Float4 drag(forces.drag);
+    const Float4 softening(forces.softening);
+    const Float4 gravityX(forces.gravity.x), gravityY(forces.gravity.y), gravityZ(forces.gravity.z);
+
+    float* px = particles.positionX.data(); float* py = particles.positionY.data(); float* pz = particles.positionZ.data();
+    float* vx = particles.velocityX.data(); float* vy = particles.velocityY.data(); float* vz = particles.velocityZ.data();
+    float* age = particles.age.data();
+
+    const std::size_t end = roundUpToWidth(count);
+    for (std::size_t i = 0; i < end; i += WIDTH)
+    {
+        const Float4 x = Float4::load(px + i), y = Float4::load(py + i), z = Float4::load(pz + i);
+        Float4 u = Float4::load(vx + i), v = Float4::load(vy + i), w = Float4::load(vz + i);
+
+        Float4 ax = gravityX - drag * u;
+        Float4 ay = gravityY - drag * v;
+        Float4 az = gravityZ - drag * w;
+
+        for (const auto& [position, strength] : forces.attractors)
+        {
+            const Float4 dx = Float4(position.x) - x, dy = Float4(position.y) - y, dz = Float4(position.z) - z;
+            const Float4 inverse = rsqrt(dot3(dx, dy, dz, dx, dy, dz) + softening);
+            const Float4 scale = Float4(strength) * inverse * inverse * inverse;
+            ax = multiplyAdd(dx, scale, ax);
+            ay = multiplyAdd(dy, scale, ay);
+            az = multiplyAdd(dz, scale, az);
+        }
+
+        // semi-implicit Euler: the new velocity drives the position update
+        u = multiplyAdd(ax, step, u);
+        v = multiplyAdd(ay, step, v);
+        w = multiplyAdd(az, step, w);
+        u.store(vx + i); v.store(vy + i); w.store(vz + i);
+        multiplyAdd(u, step, x).store(px + i);
+        multiplyAdd(v, step, y).store(py + i);
+        multiplyAdd(w, step, z).store(pz + i);
+        (Float4::load(age + i) + step).store(age + i);
+    }
+}
+
+std::size_t ParticleEmitter::compact()
+{
+    ParticleStreams& p = particles;
+    std::size_t write = 0;
+    for (std::size_t read = 0; read < count; ++read)
+    {
+        p.positionX[write] = p.positionX[read]; p.positionY[write] = p.positionY[read]; p.positionZ[write] = p.positionZ[read];
+        p.velocityX[write] = p.velocityX[read]; p.velocityY[write] = p.velocityY[read]; p.velocityZ[write] = p.velocityZ[read];
+        p.colorR[write] = p.colorR[read]; p.colorG[write] = p.colorG[read]; p.colorB[write] = p.colorB[read]; p.colorA[write] = p.colorA[read];
+        p.age[write] = p.age[read]; p.lifetime[write] = p.lifetime[read];
+        write += static_cast<std::size_t>(p.age[read] < p.lifetime[read]);
+    }
+    const std::size_t removed = count - write;
+    count = write;
+    return removed;
+}
+
+ParticleEmitter& ParticleSystem::addEmitter(const std::size_t capacity, const std::uint32_t seed)
+{
+    emitters.push_back(std::make_unique<ParticleEmitter>(capacity, seed));
+    return *emitters.back();
+}
+
+void ParticleSystem::removeEmitter(const ParticleEmitter& emitter)
+{
+    std::erase_if(emitters, [&](const std::unique_ptr<ParticleEmitter>& e) { return e.get() == &emitter; });
+}
+
+void ParticleSystem::update(const float dt, const ForceField& forces)
+{
+    Parallel::parallelFor(emitters.size(), 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { emitters[i]->update(dt, forces); }
+    });
+}
+
+std::size_t ParticleSystem::particleCount() const
+{
+    std::size_t total = 0;
+    for (const auto& e : emitters) { total += e->size(); }
+    return total;
+}
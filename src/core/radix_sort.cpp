@@ -0,0 +1,108 @@
+#include "radix_sort.hpp"
+
+#include <algorithm>
+
+using namespace Kronos::CoreSystems::Sorting;
+
+namespace
+{
+    constexpr std::size_t RADIX = 256;
+    constexpr std::size_t CHUNK = 16384;
+}
+
+template <typename Key>
+void RadixSorter::sortImpl(Key* keys, std::uint32_t* values, const std::size_t n, std::vector<Key>& keyScratch)
+{
+    if (n < 2) { return; }
+
+    keyScratch.resize(n);
+    valueScratch.resize(n);
+    const std::size_t chunks = std::clamp<std::size_t>((n + CHUNK - 1) / CHUNK, 1, Parallel::workerCount());
+    const std::size_t chunkSize = (n + chunks - 1) / chunks;
+    histograms.resize(chunks * RADIX);
+
+    Key* sourceKeys = keys;
+    Key* targetKeys = keyScratch.data();
+    std::uint32_t* sourceValues = values;
+    std::uint32_t* targetValues = valueScratch.data();
+
+    for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += 8)
+    {
+        std::fill(histograms.begin(), histograms.end(), 0u);
+        Parallel::parallelFor(chunks, 1, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t c = begin; c < end; ++c)
+            {
+                std::uint32_t* counts = histograms.data() + c * RADIX;
+                for (std::size_t i = c * chunkSize; i < std::min(n, (c + 1) * chunkSize); ++i) { ++counts[(sourceKeys[i] >> shift) & 0xFF]; }
+            }
+        });
+
+        // a digit shared by every key leaves the order untouched, so the pass is skipped
+        bool trivial = false;
+        for (std::size_t digit = 0; digit < RADIX && !trivial; ++digit)
+        {
+            std::size_t total = 0;
+            for (std::size_t c = 0; c < chunks; ++c) { total += histograms[c * RADIX + digit]; }
+            trivial = total == n;
+            if (total != 0) { break; }
+        }
+        if (trivial) { continue; }
+
+        std::uint32_t running = 0;
+        for (std::size_t digit = 0; digit < RADIX; ++digit)
+        {
+            for (std::size_t c = 0; c < chunks; ++c)
+            {
+                const std::uint32_t count = histograms[c * RADIX + digit];
+                histograms[c * RADIX + digit] = running;
+                running += count;
+            }
+        }
+
+        Parallel::parallelFor(chunks, 1, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t c = begin; c < end; ++c)
+            {
+                std::uint32_t* offsets = histograms.data() + c * RADIX;
+                for (std::size_t i = c * chunkSize; i < std::min(n, (c + 1) * chunkSize); ++i)
+                {
+                    const std::uint32_t slot = offsets[(sourceKeys[i] >> shift) & 0xFF]++;
+                    targetKeys[slot] = sourceKeys[i];
+                    targetValues[slot] = sourceValues[i];
+                }
+            }
+        });
+
+        std::swap(sourceKeys, targetKeys);
+        std::swap(sourceValues, targetValues);
+    }
+
+    if (sourceKeys != keys)
+    {
+        std::copy(sourceKeys, sourceKeys + n, keys);
+        std::copy(sourceValues, sourceValues + n, values);
+    }
+}
+
+void RadixSorter::sort(std::uint32_t* keys, std::uint32_t* values, const std::size_t n)
+{
+    sortImpl(keys, values, n, keyScratch32);
+}
+
+void RadixSorter::sort(std::uint64_t* keys, std::uint32_t* values, const std::size_t n)
+{
+    sortImpl(keys, values, n, keyScratch64);
+}
+
+void RadixSorter::sortPermutation(std::uint32_t* keys, std::uint32_t* permutation, const std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) { permutation[i] = static_cast<std::uint32_t>(i); }
+    sortImpl(keys, permutation, n, keyScratch32);
+}
+
+void RadixSorter::sortPermutation(std::uint64_t* keys, std::uint32_t* permutation, const std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) { permutation[i] = static_cast<std::uint32_t>(i); }
+    sortImpl(keys, permutation, n, keyScratch64);
+}
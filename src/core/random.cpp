@@ -0,0 +1,263 @@
+#include "random.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Random;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    // items drawn from one seeding of the lanes
+    constexpr std::size_t RANDOM_BLOCK = 4096;
+
+    constexpr std::uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ull;
+    constexpr std::uint64_t BLOCK_GAMMA = 0xd1b54a32d192ed03ull;
+    constexpr std::int32_t FLOAT_ONE_BITS = 0x3f800000;
+
+    constexpr float PI = 3.14159265358979f;
+    constexpr float HALF_PI = 1.57079632679490f;
+    constexpr float SQRT_HALF = 0.70710678118655f;
+    constexpr float LN2 = 0.69314718055995f;
+
+    std::uint64_t splitMix(std::uint64_t& x)
+    {
+        std::uint64_t z = (x += GOLDEN_GAMMA);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    struct Lanes
+    {
+        Int4 s0, s1, s2, s3;
+
+        Lanes(const std::uint64_t key, const std::uint64_t block)
+        {
+            std::uint64_t x = key ^ (block * BLOCK_GAMMA);
+            std::uint32_t words[4 * WIDTH];
+            for (int i = 0; i < 2 * WIDTH; ++i)
+            {
+                const std::uint64_t v = splitMix(x);
+                words[2 * i] = static_cast<std::uint32_t>(v);
+                words[2 * i + 1] = static_cast<std::uint32_t>(v >> 32);
+            }
+            s0 = Int4::load(words);
+            s1 = Int4::load(words + WIDTH);
+            s2 = Int4::load(words + 2 * WIDTH);
+            s3 = Int4::load(words + 3 * WIDTH);
+            // an all zero lane would never leave zero
+            s0 = s0 | (((s0 | s1 | s2 | s3) == Int4(0)) & Int4(1));
+        }
+
+        Int4 next()
+        {
+            const Int4 result = s0 + s3;
+            const Int4 t = s1 << 9;
+            s2 = s2 ^ s0;
+            s3 = s3 ^ s1;
+            s1 = s1 ^ s2;
+            s0 = s0 ^ s3;
+            s2 = s2 ^ t;
+            s3 = (s3 << 11) | (s3 >> 21);
+            return result;
+        }
+
+        // [0, 1) from the top 23 bits, the well mixed ones of xoshiro128+
+        Float4 nextFloat() { return asFloat((next() >> 9) | Int4(FLOAT_ONE_BITS)) - Float4(1.0f); }
+    };
+
+    // Taylor series of sin to x^11, within 6e-8 on [-pi/2, pi/2]
+    Float4 sinPolynomial(const Float4& x)
+    {
+        const Float4 x2 = x * x;
+        Float4 p = multiplyAdd(x2, Float4(-2.5052108e-8f), Float4(2.7557319e-6f));
+        p = multiplyAdd(x2, p, Float4(-1.9841270e-4f));
+        p = multiplyAdd(x2, p, Float4(8.3333333e-3f));
+        p = multiplyAdd(x2, p, Float4(-1.6666667e-1f));
+        return multiplyAdd(x * x2, p, x);
+    }
+
+    // sine and cosine of the angle pi (2t - 1) for t in [0, 1)
+    void sinCos(const Float4& t, Float4& s, Float4& c)
+    {
+        const Float4 angle = multiplyAdd(t, Float4(2.0f * PI), Float4(-PI));
+        const Float4 magnitude = abs(angle);
+        c = sinPolynomial(Float4(HALF_PI) - magnitude);
+        s = sinPolynomial(Float4(HALF_PI) - abs(magnitude - Float4(HALF_PI))) ^ (angle & Float4(-0.0f));
+    }
+
+    // natural log of positive normal x: x = m 2^e with m in [sqrt(1/2), sqrt(2)), and
+    // log m = 2 atanh((m - 1) / (m + 1)) by its odd series
+    Float4 logPositive(const Float4& x)
+    {
+        const Int4 bits = asInt(x);
+        Float4 m = asFloat((bits & Int4(0x007fffff)) | Int4(FLOAT_ONE_BITS));
+        Float4 e = toFloat(((bits >> 23) & Int4(0xff)) - Int4(127));
+        const Float4 high = m > Float4(2.0f * SQRT_HALF);
+        m = select(high, m * Float4(0.5f), m);
+        e = e + (high & Float4(1.0f));
+        const Float4 s = (m - Float4(1.0f)) / (m + Float4(1.0f)), s2 = s * s;
+        Float4 p = multiplyAdd(s2, Float4(2.0f / 9.0f), Float4(2.0f / 7.0f));
+        p = multiplyAdd(s2, p, Float4(2.0f / 5.0f));
+        p = multiplyAdd(s2, p, Float4(2.0f / 3.0f));
+        p = multiplyAdd(s2, p, Float4(2.0f));
+        return multiplyAdd(e, Float4(LN2), s * p);
+    }
+
+    void storeFloats(const Float4& v, const std::size_t count, float* out)
+    {
+        if (count == WIDTH) { v.store(out); return; }
+        float lanes[WIDTH];
+        v.store(lanes);
+        std::copy(lanes, lanes + count, out);
+    }
+
+    void storeVector3s(Float4 x, Float4 y, Float4 z, const std::size_t count, Vector3* out)
+    {
+        static_assert(sizeof(Vector3) == 3 * sizeof(float));
+        Float4 w;
+        transpose(x, y, z, w);
+        const Float4 rows[WIDTH] = {x, y, z, w};
+        // each full store spills one float into the next vector, which is written after it
+        std::size_t lane = 0;
+        for (; lane + 1 < count; ++lane) { rows[lane].store(&out[lane].x); }
+        float last[WIDTH];
+        rows[lane].store(last);
+        out[lane] = Vector3(last[0], last[1], last[2]);
+    }
+
+    // fills n items in groups of WIDTH, each block of RANDOM_BLOCK items from its own lanes
+    template <typename Group>
+    void generate(const std::uint64_t key, const std::size_t n, Group&& group)
+    {
+        const std::size_t blocks = (n + RANDOM_BLOCK - 1) / RANDOM_BLOCK;
+        Parallel::parallelFor(blocks, 1, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t block = begin; block < end; ++block)
+            {
+                Lanes lanes(key, block);
+                const std::size_t last = std::min((block + 1) * RANDOM_BLOCK, n);
+                for (std::size_t i = block * RANDOM_BLOCK; i < last; i += WIDTH) { group(lanes, i, std::min<std::size_t>(WIDTH, last - i)); }
+            }
+        });
+    }
+
+    // uniform direction from z uniform in [-1, 1] and an azimuth uniform in [-pi, pi)
+    void unitDirection(Lanes& lanes, Float4& x, Float4& y, Float4& z)
+    {
+        z = multiplyAdd(lanes.nextFloat(), Float4(2.0f), Float4(-1.0f));
+        const Float4 r = sqrt(max(Float4(1.0f) - z * z, Float4()));
+        Float4 s, c;
+        sinCos(lanes.nextFloat(), s, c);
+        x = r * c;
+        y = r * s;
+    }
+}
+
+RandomGenerator::RandomGenerator(const std::uint64_t seed, const std::uint64_t stream)
+{
+    std::uint64_t x = seed;
+    key = splitMix(x) ^ stream;
+    key = splitMix(key);
+}
+
+std::uint64_t RandomGenerator::nextKey()
+{
+    std::uint64_t x = key + calls++ * BLOCK_GAMMA;
+    return splitMix(x);
+}
+
+RandomGenerator RandomGenerator::split()
+{
+    RandomGenerator child;
+    child.key = nextKey();
+    return child;
+}
+
+void RandomGenerator::uniform(float* out, const std::size_t n, const float low, const float high)
+{
+    const Float4 base(low), range(high - low);
+    generate(nextKey(), n, [&](Lanes& lanes, const std::size_t i, const std::size_t count)
+    {
+        storeFloats(multiplyAdd(lanes.nextFloat(), range, base), count, out + i);
+    });
+}
+
+void RandomGenerator::inBox(Vector3* out, const std::size_t n, const Vector3& min, const Vector3& max)
+{
+    const Float4 minX(min.x), minY(min.y), minZ(min.z);
+    const Float4 extentX(max.x - min.x), extentY(max.y - min.y), extentZ(max.z - min.z);
+    generate(nextKey(), n, [&](Lanes& lanes, const std::size_t i, const std::size_t count)
+    {
+        const Float4 x = multiplyAdd(lanes.nextFloat(), extentX, minX);
+        const Float4 y = multiplyAdd(lanes.nextFloat(), extentY, minY);
+        const Float4 z = multiplyAdd(lanes.nextFloat(), extentZ, minZ);
+        storeVector3s(x, y, z, count, out + i);
+    });
+}
+
+void RandomGenerator::onUnitSphere(Vector3* out, const std::size_t n)
+{
+    generate(nextKey(), n, [&](Lanes& lanes, const std::size_t i, const std::size_t count)
+    {
+        Float4 x, y, z;
+        unitDirection(lanes, x, y, z);
+        storeVector3s(x, y, z, count, out + i);
+    });
+}
+
+void RandomGenerator::inUnitBall(Vector3* out, const std::size_t n)
+{
+    generate(nextKey(), n, [&](Lanes& lanes, const std::size_t i, const std::size_t count)
+    {
+        Float4 x, y, z;
+        unitDirection(lanes, x, y, z);
+        // the largest of three uniforms is distributed as the cube root of one, as the radius must be
+        const Float4 r = max(lanes.nextFloat(), max(lanes.nextFloat(), lanes.nextFloat()));
+        storeVector3s(x * r, y * r, z * r, count, out + i);
+    });
+}
+
+void RandomGenerator::unitQuaternions(Quaternion* out, const std::size_t n)
+{
+    static_assert(sizeof(Quaternion) == 4 * sizeof(float));
+    generate(nextKey(), n, [&](Lanes& lanes, const std::size_t i, const std::size_t count)
+    {
+        // Shoemake: two circles with radii sqrt(1 - u) and sqrt(u)
+        const Float4 u = lanes.nextFloat();
+        const Float4 r1 = sqrt(Float4(1.0f) - u), r2 = sqrt(u);
+        Float4 s1, c1, s2, c2;
+        sinCos(lanes.nextFloat(), s1, c1);
+        sinCos(lanes.nextFloat(), s2, c2);
+        Float4 x = r1 * s1, y = r1 * c1, z = r2 * s2, w = r2 * c2;
+        transpose(x, y, z, w);
+        const Float4 rows[WIDTH] = {x, y, z, w};
+        for (std::size_t lane = 0; lane < count; ++lane) { rows[lane].store(&out[i + lane].x); }
+    });
+}
+
+void RandomGenerator::gaussian(float* out, const std::size_t n, const float mean, const float deviation)
+{
+    const Float4 centre(mean), scale(deviation);
+    // Box-Muller yields two samples per pair of uniforms, so groups cover two SIMD widths
+    const std::size_t pairs = (n + 1) / 2;
+    generate(nextKey(), pairs, [&](Lanes& lanes, const std::size_t i, const std::size_t count)
+    {
+        const Float4 u = Float4(1.0f) - lanes.nextFloat();
+        const Float4 r = sqrt(Float4(-2.0f) * logPositive(u)) * scale;
+        Float4 s, c;
+        sinCos(lanes.nextFloat(), s, c);
+        // cosine samples of the valid lanes, then their sine samples
+        float samples[2 * WIDTH];
+        multiplyAdd(r, c, centre).store(samples);
+        multiplyAdd(r, s, centre).store(samples + count);
+        const std::size_t first = 2 * i;
+        std::copy(samples, samples + std::min(n - first, 2 * count), out + first);
+    });
+}
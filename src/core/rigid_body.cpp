@@ -0,0 +1,531 @@
+#include "rigid_body.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Physics;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Matrix3x3;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    constexpr std::size_t BODY_GRAIN = 1024;
+    constexpr std::size_t GROUP_GRAIN = 32;
+    constexpr std::uint32_t PADDING = std::numeric_limits<std::uint32_t>::max();
+
+    // per contact row data, one stream each; rows are the normal and the two tangents
+    constexpr int ROW_FIELDS = 17;
+    constexpr int DIRECTION = 0;
+    constexpr int ANGULAR_A = 3;
+    constexpr int ANGULAR_B = 6;
+    constexpr int INERTIA_A = 9;
+    constexpr int INERTIA_B = 12;
+    constexpr int MASS = 15;
+    constexpr int IMPULSE = 16;
+    constexpr int ANCHOR_A = 3 * ROW_FIELDS;
+    constexpr int ANCHOR_B = ANCHOR_A + 3;
+    constexpr int INVERSE_MASS_A = ANCHOR_B + 3;
+    constexpr int INVERSE_MASS_B = INVERSE_MASS_A + 1;
+    constexpr int SEPARATION = INVERSE_MASS_B + 1;
+    constexpr int RESTITUTION = SEPARATION + 1;
+    constexpr int FRICTION = RESTITUTION + 1;
+    constexpr int FIELD_COUNT = FRICTION + 1;
+
+    struct Lanes3
+    {
+        Float4 x, y, z;
+    };
+
+    Lanes3 operator+(const Lanes3& a, const Lanes3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    Lanes3 operator-(const Lanes3& a, const Lanes3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    Lanes3 operator*(const Lanes3& a, const Float4& s) { return {a.x * s, a.y * s, a.z * s}; }
+    Float4 dot(const Lanes3& a, const Lanes3& b) { return dot3(a.x, a.y, a.z, b.x, b.y, b.z); }
+    Lanes3 cross(const Lanes3& a, const Lanes3& b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+
+    struct BodyLanes
+    {
+        Lanes3 linear, angular;
+    };
+
+    Lanes3 gather(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z, const std::uint32_t (&i)[WIDTH])
+    {
+        return {Float4(x[i[0]], x[i[1]], x[i[2]], x[i[3]]), Float4(y[i[0]], y[i[1]], y[i[2]], y[i[3]]), Float4(z[i[0]], z[i[1]], z[i[2]], z[i[3]])};
+    }
+
+    BodyLanes gatherBodies(const RigidBodyStreams& s, const std::uint32_t (&i)[WIDTH])
+    {
+        return {gather(s.linearVelocityX, s.linearVelocityY, s.linearVelocityZ, i), gather(s.angularVelocityX, s.angularVelocityY, s.angularVelocityZ, i)};
+    }
+
+    // static bodies are shared between colours, so only dynamic lanes are written back
+    void scatterBodies(RigidBodyStreams& s, const std::uint32_t (&i)[WIDTH], const std::size_t lanes, const Float4& inverseMass, const BodyLanes& b)
+    {
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            const int lane = static_cast<int>(k);
+            if (!(inverseMass[lane] > 0.0f)) { continue; }
+            s.linearVelocityX[i[k]] = b.linear.x[lane];
+            s.linearVelocityY[i[k]] = b.linear.y[lane];
+            s.linearVelocityZ[i[k]] = b.linear.z[lane];
+            s.angularVelocityX[i[k]] = b.angular.x[lane];
+            s.angularVelocityY[i[k]] = b.angular.y[lane];
+            s.angularVelocityZ[i[k]] = b.angular.z[lane];
+        }
+    }
+
+    // contact data is stored as one block of FIELD_COUNT lane vectors per SIMD group
+    std::size_t fieldOffset(const std::size_t slot, const int field) { return ((slot / WIDTH) * FIELD_COUNT + field) * WIDTH + slot % WIDTH; }
+
+    Lanes3 load3(const float* p) { return {Float4::load(p), Float4::load(p + WIDTH), Float4::load(p + 2 * WIDTH)}; }
+
+    struct RowLanes
+    {
+        Lanes3 direction, angularA, angularB, inertiaA, inertiaB;
+        Float4 mass;
+    };
+
+    RowLanes loadRow(const float* row)
+    {
+        return {load3(row + DIRECTION * WIDTH), load3(row + ANGULAR_A * WIDTH), load3(row + ANGULAR_B * WIDTH),
+                load3(row + INERTIA_A * WIDTH), load3(row + INERTIA_B * WIDTH), Float4::load(row + MASS * WIDTH)};
+    }
+
+    void applyImpulse(BodyLanes& a, BodyLanes& b, const RowLanes& r, const Float4& inverseMassA, const Float4& inverseMassB, const Float4& impulse)
+    {
+        a.linear = a.linear - r.direction * (inverseMassA * impulse);
+        a.angular = a.angular - r.inertiaA * impulse;
+        b.linear = b.linear + r.direction * (inverseMassB * impulse);
+        b.angular = b.angular + r.inertiaB * impulse;
+    }
+
+    // one projected Gauss-Seidel update of a row towards the target relative velocity
+    void solveRow(BodyLanes& a, BodyLanes& b, const RowLanes& r, const Float4& inverseMassA, const Float4& inverseMassB,
+                  const Float4& target, const Float4& lower, const Float4& upper, Float4& accumulated)
+    {
+        const Float4 velocity = dot(r.direction, b.linear - a.linear) + dot(r.angularB, b.angular) - dot(r.angularA, a.angular);
+        const Float4 next = clamp(accumulated + r.mass * (target - velocity), lower, upper);
+        const Float4 impulse = next - accumulated;
+        accumulated = next;
+        applyImpulse(a, b, r, inverseMassA, inverseMassB, impulse);
+    }
+
+    void laneIndices(const std::uint32_t* index, const std::size_t lanes, std::uint32_t (&out)[WIDTH])
+    {
+        for (std::size_t k = 0; k < WIDTH; ++k) { out[k] = index[k < lanes ? k : 0]; }
+    }
+
+    void storeLanes(float* p, const std::size_t lanes, const Float4& v)
+    {
+        if (lanes == WIDTH) { v.store(p); return; }
+        for (std::size_t k = 0; k < lanes; ++k) { p[k] = v[static_cast<int>(k)]; }
+    }
+
+    Vector3 multiply(const Matrix3x3& m, const Vector3& v) { return m * v; }
+
+    // R I R^T for a unit quaternion
+    Matrix3x3 rotateInertia(const Quaternion& q, const Matrix3x3& local)
+    {
+        const float x = q.x, y = q.y, z = q.z, w = q.w;
+        const Matrix3x3 r {1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - z * w), 2.0f * (x * z + y * w),
+                           2.0f * (x * y + z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - x * w),
+                           2.0f * (x * z - y * w), 2.0f * (y * z + x * w), 1.0f - 2.0f * (x * x + y * y)};
+        const Matrix3x3 rt {r.m00, r.m10, r.m20, r.m01, r.m11, r.m21, r.m02, r.m12, r.m22};
+        return r * local * rt;
+    }
+
+    // orthonormal basis of Duff et al. 2017; depends only on the normal so tangent impulses stay warm-startable
+    void tangentBasis(const Vector3& n, Vector3& t1, Vector3& t2)
+    {
+        const float sign = std::copysign(1.0f, n.z);
+        const float a = -1.0f / (sign + n.z);
+        const float b = n.x * n.y * a;
+        t1 = {1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x};
+        t2 = {b, sign + n.y * n.y * a, -n.y};
+    }
+}
+
+Matrix3x3 Kronos::CoreSystems::Physics::boxInverseInertia(const float mass, const Vector3& halfExtents)
+{
+    if (!(mass > 0.0f)) { return Matrix3x3::ZERO; }
+    const float x2 = halfExtents.x * halfExtents.x, y2 = halfExtents.y * halfExtents.y, z2 = halfExtents.z * halfExtents.z;
+    const float k = 3.0f / mass;
+    return {k / (y2 + z2), 0.0f, 0.0f, 0.0f, k / (x2 + z2), 0.0f, 0.0f, 0.0f, k / (x2 + y2)};
+}
+
+Matrix3x3 Kronos::CoreSystems::Physics::sphereInverseInertia(const float mass, const float radius)
+{
+    if (!(mass > 0.0f)) { return Matrix3x3::ZERO; }
+    const float k = 2.5f / (mass * radius * radius);
+    return {k, 0.0f, 0.0f, 0.0f, k, 0.0f, 0.0f, 0.0f, k};
+}
+
+void RigidBodyStreams::resize(const std::size_t n)
+{
+    for (std::vector<float>* stream : {&positionX, &positionY, &positionZ, &orientationX, &orientationY, &orientationZ,
+                                       &linearVelocityX, &linearVelocityY, &linearVelocityZ,
+                                       &angularVelocityX, &angularVelocityY, &angularVelocityZ, &inverseMass})
+    {
+        stream->resize(n, 0.0f);
+    }
+    orientationW.resize(n, 1.0f);
+}
+
+std::uint32_t RigidBodySet::add(const RigidBodyDesc& desc)
+{
+    if (count == bodies.inverseMass.size())
+    {
+        const std::size_t capacity = roundUpToWidth(count + 1);
+        bodies.resize(capacity);
+        localInertia.resize(capacity, Matrix3x3::ZERO);
+        worldInertia.resize(capacity, Matrix3x3::ZERO);
+    }
+
+    const std::size_t i = count++;
+    const bool dynamic = desc.inverseMass > 0.0f;
+    bodies.inverseMass[i] = dynamic ? desc.inverseMass : 0.0f;
+    localInertia[i] = dynamic ? desc.inverseInertia : Matrix3x3::ZERO;
+    setTransform(i, desc.position, desc.orientation);
+    setVelocity(i, desc.linearVelocity, desc.angularVelocity);
+    return static_cast<std::uint32_t>(i);
+}
+
+void RigidBodySet::clear()
+{
+    count = 0;
+    bodies.resize(0);
+    localInertia.clear();
+    worldInertia.clear();
+}
+
+void RigidBodySet::setTransform(const std::size_t i, const Vector3& position, const Quaternion& orientation)
+{
+    const Quaternion q = orientation * (1.0f / orientation.magnitude());
+    bodies.positionX[i] = position.x;
+    bodies.positionY[i] = position.y;
+    bodies.positionZ[i] = position.z;
+    bodies.orientationX[i] = q.x;
+    bodies.orientationY[i] = q.y;
+    bodies.orientationZ[i] = q.z;
+    bodies.orientationW[i] = q.w;
+    worldInertia[i] = rotateInertia(q, localInertia[i]);
+}
+
+void RigidBodySet::setVelocity(const std::size_t i, const Vector3& linear, const Vector3& angular)
+{
+    bodies.linearVelocityX[i] = linear.x;
+    bodies.linearVelocityY[i] = linear.y;
+    bodies.linearVelocityZ[i] = linear.z;
+    bodies.angularVelocityX[i] = angular.x;
+    bodies.angularVelocityY[i] = angular.y;
+    bodies.angularVelocityZ[i] = angular.z;
+}
+
+void RigidBodySet::integrateVelocities(const float h, const Vector3& gravity, const float linearDamping, const float angularDamping)
+{
+    RigidBodyStreams& s = bodies;
+    Parallel::parallelFor(s.inverseMass.size(), BODY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        const Float4 gx(gravity.x * h), gy(gravity.y * h), gz(gravity.z * h);
+        const Float4 linear(std::max(1.0f - linearDamping * h, 0.0f)), angular(std::max(1.0f - angularDamping * h, 0.0f));
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            const Float4 dynamic = Float4::load(s.inverseMass.data() + i) > Float4(0.0f);
+            const Float4 one(1.0f);
+            const Float4 ls = select(dynamic, linear, one), as = select(dynamic, angular, one);
+            ((Float4::load(s.linearVelocityX.data() + i) + (dynamic & gx)) * ls).store(s.linearVelocityX.data() + i);
+            ((Float4::load(s.linearVelocityY.data() + i) + (dynamic & gy)) * ls).store(s.linearVelocityY.data() + i);
+            ((Float4::load(s.linearVelocityZ.data() + i) + (dynamic & gz)) * ls).store(s.linearVelocityZ.data() + i);
+            (Float4::load(s.angularVelocityX.data() + i) * as).store(s.angularVelocityX.data() + i);
+            (Float4::load(s.angularVelocityY.data() + i) * as).store(s.angularVelocityY.data() + i);
+            (Float4::load(s.angularVelocityZ.data() + i) * as).store(s.angularVelocityZ.data() + i);
+        }
+    });
+}
+
+void RigidBodySet::integratePositions(const float h)
+{
+    RigidBodyStreams& s = bodies;
+    Parallel::parallelFor(s.inverseMass.size(), BODY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        const Float4 step(h), halfStep(0.5f * h);
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            multiplyAdd(Float4::load(s.linearVelocityX.data() + i), step, Float4::load(s.positionX.data() + i)).store(s.positionX.data() + i);
+            multiplyAdd(Float4::load(s.linearVelocityY.data() + i), step, Float4::load(s.positionY.data() + i)).store(s.positionY.data() + i);
+            multiplyAdd(Float4::load(s.linearVelocityZ.data() + i), step, Float4::load(s.positionZ.data() + i)).store(s.positionZ.data() + i);
+
+            // dq = (w, 0) * q: vector part q.w w + w x q.xyz, scalar part -w . q.xyz
+            const Float4 wx = Float4::load(s.angularVelocityX.data() + i) * halfStep;
+            const Float4 wy = Float4::load(s.angularVelocityY.data() + i) * halfStep;
+            const Float4 wz = Float4::load(s.angularVelocityZ.data() + i) * halfStep;
+            const Float4 qx = Float4::load(s.orientationX.data() + i), qy = Float4::load(s.orientationY.data() + i);
+            const Float4 qz = Float4::load(s.orientationZ.data() + i), qw = Float4::load(s.orientationW.data() + i);
+            const Float4 x = qx + qw * wx + (wy * qz - wz * qy);
+            const Float4 y = qy + qw * wy + (wz * qx - wx * qz);
+            const Float4 z = qz + qw * wz + (wx * qy - wy * qx);
+            const Float4 w = qw - dot3(wx, wy, wz, qx, qy, qz);
+            const Float4 inv = rsqrt(x * x + y * y + z * z + w * w);
+            (x * inv).store(s.orientationX.data() + i);
+            (y * inv).store(s.orientationY.data() + i);
+            (z * inv).store(s.orientationZ.data() + i);
+            (w * inv).store(s.orientationW.data() + i);
+        }
+    });
+    updateWorldInertia();
+}
+
+void RigidBodySet::updateWorldInertia()
+{
+    Parallel::parallelFor(count, BODY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { if (bodies.inverseMass[i] > 0.0f) { worldInertia[i] = rotateInertia(orientation(i), localInertia[i]); } }
+    });
+}
+
+template <typename Kernel>
+void ContactSolver::forEachGroup(Kernel&& kernel)
+{
+    const std::size_t colors = colorCount();
+    for (std::size_t c = 0; c < colors; ++c)
+    {
+        const std::size_t first = colorOffsets[c], n = colorCounts[c];
+        if (serialTail && c + 1 == colors)
+        {
+            for (std::size_t i = 0; i < n; ++i) { kernel(first + i * WIDTH, 1); }
+            continue;
+        }
+        Parallel::parallelFor((n + WIDTH - 1) / WIDTH, GROUP_GRAIN, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t g = begin; g < end; ++g) { kernel(first + g * WIDTH, std::min<std::size_t>(WIDTH, n - g * WIDTH)); }
+        });
+    }
+}
+
+void ContactSolver::prepare(const RigidBodySet& bodies, const ContactPoint* contacts, const std::size_t n, const ContactSolverParams& params)
+{
+    // greedy colouring over dynamic bodies; colour MAX_COLORS collects contacts solved serially, one per group
+    const std::vector<float>& inverseMass = bodies.streams().inverseMass;
+    std::vector<std::uint64_t> used(inverseMass.size(), 0);
+    std::vector<int> assigned(n);
+    std::vector<std::size_t> counts(MAX_COLORS + 1, 0);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const std::uint32_t a = contacts[i].bodyA, b = contacts[i].bodyB;
+        const bool dynamicA = inverseMass[a] > 0.0f, dynamicB = inverseMass[b] > 0.0f;
+        const std::uint64_t taken = (dynamicA ? used[a] : 0) | (dynamicB ? used[b] : 0);
+        int color = 0;
+        while (color < MAX_COLORS && (taken >> color & 1)) { ++color; }
+        assigned[i] = color;
+        ++counts[color];
+        if (color == MAX_COLORS) { continue; }
+        if (dynamicA) { used[a] |= std::uint64_t(1) << color; }
+        if (dynamicB) { used[b] |= std::uint64_t(1) << color; }
+    }
+
+    colorOffsets.assign(1, 0);
+    colorCounts.clear();
+    std::vector<std::size_t> slot(MAX_COLORS + 1, 0);
+    for (int c = 0; c <= MAX_COLORS; ++c)
+    {
+        if (counts[c] == 0) { continue; }
+        slot[c] = colorOffsets.back();
+        colorCounts.push_back(counts[c]);
+        colorOffsets.push_back(colorOffsets.back() + (c == MAX_COLORS ? counts[c] * WIDTH : roundUpToWidth(counts[c])));
+    }
+    serialTail = counts[MAX_COLORS] > 0;
+
+    slotCount = colorOffsets.back();
+    bodyA.assign(slotCount, 0);
+    bodyB.assign(slotCount, 0);
+    source.assign(slotCount, PADDING);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const std::size_t k = slot[assigned[i]];
+        slot[assigned[i]] += assigned[i] == MAX_COLORS ? WIDTH : 1;
+        source[k] = static_cast<std::uint32_t>(i);
+        bodyA[k] = contacts[i].bodyA;
+        bodyB[k] = contacts[i].bodyB;
+    }
+    rows.assign(FIELD_COUNT * slotCount, 0.0f);
+
+    Parallel::parallelFor(slotCount, BODY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t k = begin; k < end; ++k)
+        {
+            if (source[k] == PADDING) { continue; }
+            float* data = rows.data() + fieldOffset(k, 0);
+            const ContactPoint& contact = contacts[source[k]];
+            const std::uint32_t a = contact.bodyA, b = contact.bodyB;
+            const float wa = bodies.inverseMass(a), wb = bodies.inverseMass(b);
+            const Matrix3x3 ia = wa > 0.0f ? bodies.worldInverseInertia(a) : Matrix3x3::ZERO;
+            const Matrix3x3 ib = wb > 0.0f ? bodies.worldInverseInertia(b) : Matrix3x3::ZERO;
+            const Vector3 ra = contact.point - bodies.position(a), rb = contact.point - bodies.position(b);
+
+            Vector3 directions[3] = {contact.normal};
+            tangentBasis(contact.normal, directions[1], directions[2]);
+            const float impulses[3] = {contact.normalImpulse, contact.tangentImpulse[0], contact.tangentImpulse[1]};
+            for (int r = 0; r < 3; ++r)
+            {
+                float* row = data + r * ROW_FIELDS * WIDTH;
+                const Vector3 angularA = ra.cross(directions[r]), angularB = rb.cross(directions[r]);
+                const Vector3 inertiaA = multiply(ia, angularA), inertiaB = multiply(ib, angularB);
+                const float effective = wa + wb + angularA.dot(inertiaA) + angularB.dot(inertiaB);
+                const Vector3* vectors[5] = {&directions[r], &angularA, &angularB, &inertiaA, &inertiaB};
+                for (int v = 0; v < 5; ++v)
+                {
+                    row[(3 * v) * WIDTH] = vectors[v]->x;
+                    row[(3 * v + 1) * WIDTH] = vectors[v]->y;
+                    row[(3 * v + 2) * WIDTH] = vectors[v]->z;
+                }
+                row[MASS * WIDTH] = effective > 0.0f ? 1.0f / effective : 0.0f;
+                row[IMPULSE * WIDTH] = params.warmStart ? impulses[r] : 0.0f;
+            }
+
+            const Vector3 velocity = bodies.linearVelocity(b) + bodies.angularVelocity(b).cross(rb) - bodies.linearVelocity(a) - bodies.angularVelocity(a).cross(ra);
+            const float approach = velocity.dot(contact.normal);
+            const float fields[] = {ra.x, ra.y, ra.z, rb.x, rb.y, rb.z, wa, wb, contact.separation,
+                                    approach < -params.restitutionThreshold ? -contact.restitution * approach : 0.0f, contact.friction};
+            for (int f = 0; f < FIELD_COUNT - ANCHOR_A; ++f) { data[(ANCHOR_A + f) * WIDTH] = fields[f]; }
+        }
+    });
+
+    deltaX.assign(inverseMass.size(), 0.0f);
+    deltaY.assign(inverseMass.size(), 0.0f);
+    deltaZ.assign(inverseMass.size(), 0.0f);
+    rotationX.assign(inverseMass.size(), 0.0f);
+    rotationY.assign(inverseMass.size(), 0.0f);
+    rotationZ.assign(inverseMass.size(), 0.0f);
+}
+
+void ContactSolver::warmStart(RigidBodySet& bodies, const bool apply)
+{
+    RigidBodyStreams& s = bodies.streams();
+    forEachGroup([&](const std::size_t first, const std::size_t lanes)
+    {
+        float* base = rows.data() + fieldOffset(first, 0);
+        if (!apply)
+        {
+            for (int r = 0; r < 3; ++r) { storeLanes(base + (r * ROW_FIELDS + IMPULSE) * WIDTH, lanes, Float4(0.0f)); }
+            return;
+        }
+
+        std::uint32_t ia[WIDTH], ib[WIDTH];
+        laneIndices(bodyA.data() + first, lanes, ia);
+        laneIndices(bodyB.data() + first, lanes, ib);
+        BodyLanes a = gatherBodies(s, ia), b = gatherBodies(s, ib);
+        const Float4 wa = Float4::load(base + INVERSE_MASS_A * WIDTH), wb = Float4::load(base + INVERSE_MASS_B * WIDTH);
+        for (int r = 0; r < 3; ++r)
+        {
+            const float* row = base + r * ROW_FIELDS * WIDTH;
+            applyImpulse(a, b, loadRow(row), wa, wb, Float4::load(row + IMPULSE * WIDTH));
+        }
+        scatterBodies(s, ia, lanes, wa, a);
+        scatterBodies(s, ib, lanes, wb, b);
+    });
+}
+
+void ContactSolver::solve(RigidBodySet& bodies, const float h, const bool useBias, const ContactSolverParams& params)
+{
+    RigidBodyStreams& s = bodies.streams();
+    const Float4 inverseStep(1.0f / h);
+    const Float4 baumgarte(useBias ? params.baumgarte / h : 0.0f), maxBias(params.maxBiasVelocity), slop(params.slop);
+    const Float4 infinity(std::numeric_limits<float>::infinity()), zero(0.0f);
+
+    forEachGroup([&](const std::size_t first, const std::size_t lanes)
+    {
+        float* base = rows.data() + fieldOffset(first, 0);
+        std::uint32_t ia[WIDTH], ib[WIDTH];
+        laneIndices(bodyA.data() + first, lanes, ia);
+        laneIndices(bodyB.data() + first, lanes, ib);
+        BodyLanes a = gatherBodies(s, ia), b = gatherBodies(s, ib);
+        const Float4 wa = Float4::load(base + INVERSE_MASS_A * WIDTH), wb = Float4::load(base + INVERSE_MASS_B * WIDTH);
+
+        // friction first so the normal row, solved last, is the most accurate
+        Float4 normalImpulse = Float4::load(base + IMPULSE * WIDTH);
+        const Float4 limit = Float4::load(base + FRICTION * WIDTH) * normalImpulse;
+        for (int r = 1; r < 3; ++r)
+        {
+            float* row = base + r * ROW_FIELDS * WIDTH;
+            Float4 impulse = Float4::load(row + IMPULSE * WIDTH);
+            solveRow(a, b, loadRow(row), wa, wb, zero, -limit, limit, impulse);
+            storeLanes(row + IMPULSE * WIDTH, lanes, impulse);
+        }
+
+        // separation tracked through the substep displacement of the anchors, with lever arms held fixed
+        const Lanes3 ra = load3(base + ANCHOR_A * WIDTH), rb = load3(base + ANCHOR_B * WIDTH);
+        const Lanes3 moveA = gather(deltaX, deltaY, deltaZ, ia) + cross(gather(rotationX, rotationY, rotationZ, ia), ra);
+        const Lanes3 moveB = gather(deltaX, deltaY, deltaZ, ib) + cross(gather(rotationX, rotationY, rotationZ, ib), rb);
+        const RowLanes normal = loadRow(base);
+        const Float4 separation = Float4::load(base + SEPARATION * WIDTH) + dot(normal.direction, moveB - moveA);
+
+        const Float4 bias = min(baumgarte * max(-separation - slop, zero), maxBias);
+        const Float4 target = select(separation > zero, -separation * inverseStep, max(bias, Float4::load(base + RESTITUTION * WIDTH)));
+        solveRow(a, b, normal, wa, wb, target, zero, infinity, normalImpulse);
+        storeLanes(base + IMPULSE * WIDTH, lanes, normalImpulse);
+
+        scatterBodies(s, ia, lanes, wa, a);
+        scatterBodies(s, ib, lanes, wb, b);
+    });
+}
+
+void ContactSolver::accumulateDeltas(const RigidBodySet& bodies, const float h)
+{
+    const RigidBodyStreams& s = bodies.streams();
+    Parallel::parallelFor(deltaX.size(), BODY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        const Float4 step(h);
+        const std::pair<const std::vector<float>*, std::vector<float>*> streams[] = {
+            {&s.linearVelocityX, &deltaX}, {&s.linearVelocityY, &deltaY}, {&s.linearVelocityZ, &deltaZ},
+            {&s.angularVelocityX, &rotationX}, {&s.angularVelocityY, &rotationY}, {&s.angularVelocityZ, &rotationZ}};
+        for (const auto& [velocity, delta] : streams)
+        {
+            for (std::size_t i = begin; i < end; i += WIDTH)
+            {
+                multiplyAdd(Float4::load(velocity->data() + i), step, Float4::load(delta->data() + i)).store(delta->data() + i);
+            }
+        }
+    });
+}
+
+void ContactSolver::storeImpulses(ContactPoint* contacts) const
+{
+    Parallel::parallelFor(slotCount, BODY_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t k = begin; k < end; ++k)
+        {
+            if (source[k] == PADDING) { continue; }
+            ContactPoint& contact = contacts[source[k]];
+            contact.normalImpulse = rows[fieldOffset(k, IMPULSE)];
+            contact.tangentImpulse[0] = rows[fieldOffset(k, ROW_FIELDS + IMPULSE)];
+            contact.tangentImpulse[1] = rows[fieldOffset(k, 2 * ROW_FIELDS + IMPULSE)];
+        }
+    });
+}
+
+void ContactSolver::step(RigidBodySet& bodies, ContactPoint* contacts, const std::size_t n, const float dt, const ContactSolverParams& params)
+{
+    if (!(dt > 0.0f)) { return; }
+
+    const int substeps = std::max(params.substeps, 1);
+    const float h = dt / static_cast<float>(substeps);
+    prepare(bodies, contacts, n, params);
+
+    for (int s = 0; s < substeps; ++s)
+    {
+        bodies.integrateVelocities(h, params.gravity, params.linearDamping, params.angularDamping);
+        warmStart(bodies, params.warmStart);
+        for (int i = 0; i < std::max(params.iterations, 1); ++i) { solve(bodies, h, true, params); }
+        bodies.integratePositions(h);
+        accumulateDeltas(bodies, h);
+        for (int i = 0; i < params.relaxIterations; ++i) { solve(bodies, h, false, params); }
+    }
+
+    storeImpulses(contacts);
+}
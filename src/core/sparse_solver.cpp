@@ -0,0 +1,427 @@
+#include "sparse_solver.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::LinearAlgebra;
+using namespace Kronos::CoreSystems::Simd;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+using Kronos::CoreSystems::Math::Matrix3x3;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr std::size_t ROW_GRAIN = 256;
+    constexpr std::size_t STREAM_GRAIN = 4096;
+
+    template <typename Entry, typename Value>
+    void compress(const int rows, std::vector<Entry>& entries, std::vector<int>& offsets, std::vector<int>& indices, std::vector<Value>& values)
+    {
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.row != b.row ? a.row < b.row : a.column < b.column; });
+
+        offsets.assign(static_cast<std::size_t>(rows) + 1, 0);
+        indices.clear();
+        values.clear();
+        int lastRow = -1, lastColumn = -1;
+        for (const Entry& e : entries)
+        {
+            if (e.row == lastRow && e.column == lastColumn) { values.back() += e.value; continue; }
+            indices.push_back(e.column);
+            values.push_back(e.value);
+            ++offsets[e.row + 1];
+            lastRow = e.row;
+            lastColumn = e.column;
+        }
+        for (int r = 0; r < rows; ++r) { offsets[r + 1] += offsets[r]; }
+    }
+
+    int findIndex(const std::vector<int>& offsets, const std::vector<int>& indices, const int row, const int column)
+    {
+        const auto begin = indices.begin() + offsets[row], end = indices.begin() + offsets[row + 1];
+        const auto it = std::lower_bound(begin, end, column);
+        return it != end && *it == column ? static_cast<int>(it - indices.begin()) : -1;
+    }
+
+    float* component(Vector3Streams& s, const int c) { return c == 0 ? s.x.data() : c == 1 ? s.y.data() : s.z.data(); }
+    const float* component(const Vector3Streams& s, const int c) { return c == 0 ? s.x.data() : c == 1 ? s.y.data() : s.z.data(); }
+
+    Vector3 loadVector(const Vector3Streams& s, const std::size_t i) { return {s.x[i], s.y[i], s.z[i]}; }
+    void storeVector(Vector3Streams& s, const std::size_t i, const Vector3& v) { s.x[i] = v.x; s.y[i] = v.y; s.z[i] = v.z; }
+
+    Vector3 multiplyTransposed(const Matrix3x3& a, const Vector3& v)
+    {
+        return {a.m00 * v.x + a.m10 * v.y + a.m20 * v.z,
+                a.m01 * v.x + a.m11 * v.y + a.m21 * v.z,
+                a.m02 * v.x + a.m12 * v.y + a.m22 * v.z};
+    }
+
+    // a * b^T
+    Matrix3x3 multiplyByTranspose(const Matrix3x3& a, const Matrix3x3& b)
+    {
+        return {a.m00 * b.m00 + a.m01 * b.m01 + a.m02 * b.m02, a.m00 * b.m10 + a.m01 * b.m11 + a.m02 * b.m12, a.m00 * b.m20 + a.m01 * b.m21 + a.m02 * b.m22,
+                a.m10 * b.m00 + a.m11 * b.m01 + a.m12 * b.m02, a.m10 * b.m10 + a.m11 * b.m11 + a.m12 * b.m12, a.m10 * b.m20 + a.m11 * b.m21 + a.m12 * b.m22,
+                a.m20 * b.m00 + a.m21 * b.m01 + a.m22 * b.m02, a.m20 * b.m10 + a.m21 * b.m11 + a.m22 * b.m12, a.m20 * b.m20 + a.m21 * b.m21 + a.m22 * b.m22};
+    }
+
+    // a - b * c^T
+    Matrix3x3 subtractOuter(const Matrix3x3& a, const Matrix3x3& b, const Matrix3x3& c)
+    {
+        return a + multiplyByTranspose(b, c) * -1.0f;
+    }
+
+    // inverse of the lower Cholesky factor of the symmetric block d, reading its lower triangle
+    bool invertCholeskyFactor(const Matrix3x3& d, Matrix3x3& inverse)
+    {
+        const float s00 = d.m00;
+        if (!(s00 > 0.0f)) { return false; }
+        const float l00 = std::sqrt(s00);
+        const float l10 = d.m10 / l00, l20 = d.m20 / l00;
+        const float s11 = d.m11 - l10 * l10;
+        if (!(s11 > 0.0f)) { return false; }
+        const float l11 = std::sqrt(s11);
+        const float l21 = (d.m21 - l20 * l10) / l11;
+        const float s22 = d.m22 - l20 * l20 - l21 * l21;
+        if (!(s22 > 0.0f)) { return false; }
+        const float l22 = std::sqrt(s22);
+
+        const float i00 = 1.0f / l00, i11 = 1.0f / l11, i22 = 1.0f / l22;
+        const float i10 = -l10 * i00 * i11;
+        const float i21 = -l21 * i11 * i22;
+        const float i20 = -(l20 * i00 + l21 * i10) * i22;
+        inverse = {i00, 0.0f, 0.0f, i10, i11, 0.0f, i20, i21, i22};
+        return true;
+    }
+
+    template <typename Kernel>
+    double reduce(const std::size_t n, std::vector<double>& partials, Kernel&& kernel)
+    {
+        partials.assign((n + STREAM_GRAIN - 1) / STREAM_GRAIN, 0.0);
+        Parallel::parallelFor(n, STREAM_GRAIN, [&](const std::size_t begin, const std::size_t end)
+        {
+            // fixed chunks whatever range the call receives, so an inline run sums the same partials
+            for (std::size_t c = begin; c < end; c += STREAM_GRAIN) { partials[c / STREAM_GRAIN] = kernel(c, std::min(c + STREAM_GRAIN, end)); }
+        });
+
+        double total = 0.0;
+        for (const double p : partials) { total += p; }
+        return total;
+    }
+
+    float horizontalSum(const Float4& v) { return (v[0] + v[1]) + (v[2] + v[3]); }
+
+    double dotStreams(const Vector3Streams& a, const Vector3Streams& b, std::vector<double>& partials)
+    {
+        return reduce(a.size(), partials, [&](const std::size_t begin, const std::size_t end)
+        {
+            double sum = 0.0;
+            for (int c = 0; c < 3; ++c)
+            {
+                const float* pa = component(a, c);
+                const float* pb = component(b, c);
+                Float4 acc;
+                std::size_t i = begin;
+                for (; i + WIDTH <= end; i += WIDTH) { acc = multiplyAdd(Float4::load(pa + i), Float4::load(pb + i), acc); }
+                float tail = horizontalSum(acc);
+                for (; i < end; ++i) { tail += pa[i] * pb[i]; }
+                sum += tail;
+            }
+            return sum;
+        });
+    }
+
+    // x += alpha p, r -= alpha q, returning |r|^2
+    double advance(Vector3Streams& x, Vector3Streams& r, const Vector3Streams& p, const Vector3Streams& q, const float alpha, std::vector<double>& partials)
+    {
+        return reduce(x.size(), partials, [&](const std::size_t begin, const std::size_t end)
+        {
+            const Float4 a(alpha);
+            double sum = 0.0;
+            for (int c = 0; c < 3; ++c)
+            {
+                float* px = component(x, c);
+                float* pr = component(r, c);
+                const float* pp = component(p, c);
+                const float* pq = component(q, c);
+                Float4 acc;
+                std::size_t i = begin;
+                for (; i + WIDTH <= end; i += WIDTH)
+                {
+                    multiplyAdd(a, Float4::load(pp + i), Float4::load(px + i)).store(px + i);
+                    const Float4 ri = Float4::load(pr + i) - a * Float4::load(pq + i);
+                    ri.store(pr + i);
+                    acc = multiplyAdd(ri, ri, acc);
+                }
+                float tail = horizontalSum(acc);
+                for (; i < end; ++i)
+                {
+                    px[i] += alpha * pp[i];
+                    pr[i] -= alpha * pq[i];
+                    tail += pr[i] * pr[i];
+                }
+                sum += tail;
+            }
+            return sum;
+        });
+    }
+
+    // p = z + beta p
+    void updateDirection(Vector3Streams& p, const Vector3Streams& z, const float beta)
+    {
+        Parallel::parallelFor(p.size(), STREAM_GRAIN, [&](const std::size_t begin, const std::size_t end)
+        {
+            const Float4 b(beta);
+            for (int c = 0; c < 3; ++c)
+            {
+                float* pp = component(p, c);
+                const float* pz = component(z, c);
+                std::size_t i = begin;
+                for (; i + WIDTH <= end; i += WIDTH) { multiplyAdd(b, Float4::load(pp + i), Float4::load(pz + i)).store(pp + i); }
+                for (; i < end; ++i) { pp[i] = pz[i] + beta * pp[i]; }
+            }
+        });
+    }
+
+    // r = b - r
+    void subtractFrom(const Vector3Streams& b, Vector3Streams& r)
+    {
+        Parallel::parallelFor(r.size(), STREAM_GRAIN, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                float* pr = component(r, c);
+                const float* pb = component(b, c);
+                for (std::size_t i = begin; i < end; ++i) { pr[i] = pb[i] - pr[i]; }
+            }
+        });
+    }
+
+    void ensureSize(Vector3Streams& s, const std::size_t n)
+    {
+        if (s.size() != n) { s.resize(n); }
+    }
+}
+
+void Vector3Streams::resize(const std::size_t n)
+{
+    for (std::vector<float>* stream : {&x, &y, &z}) { stream->assign(n, 0.0f); }
+}
+
+SparseMatrix::SparseMatrix(const int rows, const int columns, std::vector<Triplet> entries) : rows(rows), columns(columns)
+{
+    compress(rows, entries, offsets, indices, values);
+}
+
+float* SparseMatrix::find(const int row, const int column)
+{
+    const int index = findIndex(offsets, indices, row, column);
+    return index >= 0 ? &values[index] : nullptr;
+}
+
+void SparseMatrix::multiply(const float* x, float* y) const
+{
+    Parallel::parallelFor(static_cast<std::size_t>(rows), ROW_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t r = begin; r < end; ++r)
+        {
+            float sum = 0.0f;
+            for (int k = offsets[r]; k < offsets[r + 1]; ++k) { sum += values[k] * x[indices[k]]; }
+            y[r] = sum;
+        }
+    });
+}
+
+BlockSparseMatrix::BlockSparseMatrix(const int blockRows, const int blockColumns, std::vector<BlockTriplet> entries) : rows(blockRows), columns(blockColumns)
+{
+    compress(rows, entries, offsets, indices, blocks);
+    diagonals.resize(static_cast<std::size_t>(rows));
+    for (int r = 0; r < rows; ++r) { diagonals[r] = findIndex(offsets, indices, r, r); }
+}
+
+Matrix3x3* BlockSparseMatrix::find(const int row, const int column)
+{
+    const int index = findIndex(offsets, indices, row, column);
+    return index >= 0 ? &blocks[index] : nullptr;
+}
+
+void BlockSparseMatrix::setZero()
+{
+    std::fill(blocks.begin(), blocks.end(), Matrix3x3::ZERO);
+}
+
+void BlockSparseMatrix::multiply(const Vector3Streams& x, Vector3Streams& y) const
+{
+    ensureSize(y, static_cast<std::size_t>(rows));
+    Parallel::parallelFor(static_cast<std::size_t>(rows), ROW_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        const float* px = x.x.data();
+        const float* py = x.y.data();
+        const float* pz = x.z.data();
+        for (std::size_t r = begin; r < end; ++r)
+        {
+            float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+            for (int k = offsets[r]; k < offsets[r + 1]; ++k)
+            {
+                const Matrix3x3& m = blocks[k];
+                const int c = indices[k];
+                const float vx = px[c], vy = py[c], vz = pz[c];
+                sx += m.m00 * vx + m.m01 * vy + m.m02 * vz;
+                sy += m.m10 * vx + m.m11 * vy + m.m12 * vz;
+                sz += m.m20 * vx + m.m21 * vy + m.m22 * vz;
+            }
+            y.x[r] = sx;
+            y.y[r] = sy;
+            y.z[r] = sz;
+        }
+    });
+}
+
+void ConjugateGradientSolver::buildJacobi(const BlockSparseMatrix& a)
+{
+    inverseDiagonal.resize(static_cast<std::size_t>(a.blockRowCount()));
+    Parallel::parallelFor(inverseDiagonal.size(), ROW_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t r = begin; r < end; ++r)
+        {
+            const int d = a.diagonalIndex(static_cast<int>(r));
+            const bool invertible = d >= 0 && a.blockValues()[d].determinant() != 0.0f;
+            inverseDiagonal[r] = invertible ? a.blockValues()[d].inverse() : Matrix3x3::IDENTITY;
+        }
+    });
+}
+
+bool ConjugateGradientSolver::buildIncompleteCholesky(const BlockSparseMatrix& a)
+{
+    // IC(0): L keeps the lower block pattern of A; the last block of each row holds the inverse of
+    // the diagonal factor so both triangular solves only multiply
+    const int n = a.blockRowCount();
+    const std::vector<int>& offsets = a.rowOffsets();
+    const std::vector<int>& indices = a.columnIndices();
+    lowerOffsets.assign(static_cast<std::size_t>(n) + 1, 0);
+    lowerIndices.clear();
+    lowerBlocks.clear();
+    for (int r = 0; r < n; ++r)
+    {
+        for (int k = offsets[r]; k < offsets[r + 1] && indices[k] <= r; ++k)
+        {
+            lowerIndices.push_back(indices[k]);
+            lowerBlocks.push_back(a.blockValues()[k]);
+        }
+        lowerOffsets[r + 1] = static_cast<int>(lowerIndices.size());
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        const int begin = lowerOffsets[i], last = lowerOffsets[i + 1] - 1;
+        if (last < begin || lowerIndices[last] != i) { return false; }
+
+        for (int k = begin; k < last; ++k)
+        {
+            const int j = lowerIndices[k];
+            Matrix3x3 s = lowerBlocks[k];
+            int p = begin, q = lowerOffsets[j];
+            const int qLast = lowerOffsets[j + 1] - 1;
+            while (p < k && q < qLast)
+            {
+                if (lowerIndices[p] < lowerIndices[q]) { ++p; }
+                else if (lowerIndices[q] < lowerIndices[p]) { ++q; }
+                else { s = subtractOuter(s, lowerBlocks[p++], lowerBlocks[q++]); }
+            }
+            // L_ij = S L_jj^-T
+            lowerBlocks[k] = multiplyByTranspose(s, lowerBlocks[qLast]);
+        }
+
+        Matrix3x3 d = lowerBlocks[last];
+        for (int k = begin; k < last; ++k) { d = subtractOuter(d, lowerBlocks[k], lowerBlocks[k]); }
+        if (!invertCholeskyFactor(d, lowerBlocks[last])) { return false; }
+    }
+    return true;
+}
+
+void ConjugateGradientSolver::applyPreconditioner(const Preconditioner kind, const Vector3Streams& r, Vector3Streams& z) const
+{
+    const std::size_t n = r.size();
+    if (kind == Preconditioner::None)
+    {
+        z = r;
+        return;
+    }
+
+    if (kind == Preconditioner::Jacobi)
+    {
+        Parallel::parallelFor(n, ROW_GRAIN, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i) { storeVector(z, i, inverseDiagonal[i] * loadVector(r, i)); }
+        });
+        return;
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const int last = lowerOffsets[i + 1] - 1;
+        Vector3 v = loadVector(r, i);
+        for (int k = lowerOffsets[i]; k < last; ++k) { v -= lowerBlocks[k] * loadVector(z, static_cast<std::size_t>(lowerIndices[k])); }
+        storeVector(z, i, lowerBlocks[last] * v);
+    }
+    for (std::size_t i = n; i-- > 0;)
+    {
+        const int last = lowerOffsets[i + 1] - 1;
+        const Vector3 v = multiplyTransposed(lowerBlocks[last], loadVector(z, i));
+        storeVector(z, i, v);
+        for (int k = lowerOffsets[i]; k < last; ++k)
+        {
+            const std::size_t j = static_cast<std::size_t>(lowerIndices[k]);
+            storeVector(z, j, loadVector(z, j) - multiplyTransposed(lowerBlocks[k], v));
+        }
+    }
+}
+
+ConjugateGradientResult ConjugateGradientSolver::solve(const BlockSparseMatrix& a, const Vector3Streams& b, Vector3Streams& x, const ConjugateGradientParams& params)
+{
+    const std::size_t n = static_cast<std::size_t>(a.blockRowCount());
+    ensureSize(x, n);
+    for (Vector3Streams* s : {&residual, &preconditioned, &direction, &product}) { ensureSize(*s, n); }
+
+    ConjugateGradientResult result;
+    const double bb = dotStreams(b, b, partialSums);
+    if (bb == 0.0)
+    {
+        x.resize(n);
+        result.converged = true;
+        return result;
+    }
+
+    Preconditioner kind = params.preconditioner;
+    if (kind == Preconditioner::IncompleteCholesky && !buildIncompleteCholesky(a)) { kind = Preconditioner::Jacobi; }
+    if (kind == Preconditioner::Jacobi) { buildJacobi(a); }
+
+    const double threshold = static_cast<double>(params.tolerance) * params.tolerance * bb;
+    a.multiply(x, residual);
+    subtractFrom(b, residual);
+    double rr = dotStreams(residual, residual, partialSums);
+
+    applyPreconditioner(kind, residual, direction);
+    double rz = dotStreams(residual, direction, partialSums);
+
+    while (rr > threshold && result.iterations < params.maxIterations)
+    {
+        a.multiply(direction, product);
+        const double pq = dotStreams(direction, product, partialSums);
+        if (!(pq > 0.0)) { break; }
+
+        rr = advance(x, residual, direction, product, static_cast<float>(rz / pq), partialSums);
+        ++result.iterations;
+        if (rr <= threshold) { break; }
+
+        applyPreconditioner(kind, residual, preconditioned);
+        const double rzNext = dotStreams(residual, preconditioned, partialSums);
+        updateDirection(direction, preconditioned, static_cast<float>(rzNext / rz));
+        rz = rzNext;
+    }
+
+    result.residual = static_cast<float>(std::sqrt(rr / bb));
+    result.converged = rr <= threshold;
+    return result;
+}
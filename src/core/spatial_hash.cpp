@@ -0,0 +1,343 @@
+#include "spatial_hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Spatial;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr std::int32_t PRIME_X = 73856093;
+    constexpr std::int32_t PRIME_Y = 19349663;
+    constexpr std::int32_t PRIME_Z = 83492791;
+    constexpr float FAR_AWAY = std::numeric_limits<float>::infinity();
+    constexpr float PARKED = std::numeric_limits<float>::quiet_NaN();
+    // cell coordinates are clamped here so far away or non-finite positions convert safely; cells beyond
+    // share the border cell
+    constexpr float CELL_LIMIT = 1073741824.0f;
+
+    std::int32_t cellCoordinate(const float scaled)
+    {
+        return static_cast<std::int32_t>(std::floor(std::fmin(std::fmax(scaled, -CELL_LIMIT), CELL_LIMIT)));
+    }
+
+    Int4 cellCoordinates(const Float4& scaled)
+    {
+        return truncateToInt(floor(clamp(scaled, Float4(-CELL_LIMIT), Float4(CELL_LIMIT))));
+    }
+
+    std::size_t nextPowerOfTwo(const std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n) { p <<= 1; }
+        return p;
+    }
+
+    thread_local std::vector<std::uint32_t> visitedBuckets;
+    thread_local std::vector<Neighbor> nearestCandidates;
+}
+
+SpatialHashGrid::SpatialHashGrid(const float cellSize, const std::size_t tableSize) : size(cellSize), inverseSize(1.0f / cellSize), fixedTableSize(tableSize) {}
+
+std::uint32_t SpatialHashGrid::bucketOf(const std::int32_t x, const std::int32_t y, const std::int32_t z) const
+{
+    const std::uint32_t h = static_cast<std::uint32_t>(x) * PRIME_X ^ static_cast<std::uint32_t>(y) * PRIME_Y ^ static_cast<std::uint32_t>(z) * PRIME_Z;
+    return h & mask;
+}
+
+std::uint32_t SpatialHashGrid::bucketOf(const Vector3& p) const
+{
+    return bucketOf(cellCoordinate(p.x * inverseSize), cellCoordinate(p.y * inverseSize), cellCoordinate(p.z * inverseSize));
+}
+
+void SpatialHashGrid::computeBuckets(const Vector3* points, std::uint32_t* out) const
+{
+    // caller hands in a block of exactly WIDTH points
+    const Float4 inverse(inverseSize);
+    const Float4 x(points[0].x, points[1].x, points[2].x, points[3].x);
+    const Float4 y(points[0].y, points[1].y, points[2].y, points[3].y);
+    const Float4 z(points[0].z, points[1].z, points[2].z, points[3].z);
+    const Int4 hx = cellCoordinates(x * inverse) * Int4(PRIME_X);
+    const Int4 hy = cellCoordinates(y * inverse) * Int4(PRIME_Y);
+    const Int4 hz = cellCoordinates(z * inverse) * Int4(PRIME_Z);
+    ((hx ^ hy ^ hz) & Int4(static_cast<std::int32_t>(mask))).store(out);
+}
+
+void SpatialHashGrid::build(const Vector3* points, const std::size_t n)
+{
+    count = n;
+    const std::size_t tableSize = nextPowerOfTwo(fixedTableSize ? fixedTableSize : std::max<std::size_t>(64, n * 2));
+    mask = static_cast<std::uint32_t>(tableSize - 1);
+
+    pointBucket.resize(n);
+    pointSlot.resize(n);
+    entries.resize(n);
+    sortedX.assign(n + WIDTH, PARKED);
+    sortedY.assign(n + WIDTH, PARKED);
+    sortedZ.assign(n + WIDTH, PARKED);
+    cellStart.assign(tableSize + 1, 0);
+    overflow.clear();
+
+    Parallel::parallelFor(n, 4096, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH) { computeBuckets(points + i, pointBucket.data() + i); }
+        for (; i < end; ++i) { pointBucket[i] = bucketOf(points[i]); }
+    });
+
+    // parallel counting sort: one histogram per chunk keeps the scatter stable and lock-free
+    const std::size_t chunks = std::clamp<std::size_t>((n + 16383) / 16384, 1, Parallel::workerCount());
+    const std::size_t chunkSize = (n + chunks - 1) / chunks;
+    histogram.assign(chunks * tableSize, 0);
+
+    Parallel::parallelFor(chunks, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t c = begin; c < end; ++c)
+        {
+            std::uint32_t* counts = histogram.data() + c * tableSize;
+            for (std::size_t i = c * chunkSize; i < std::min(n, (c + 1) * chunkSize); ++i) { ++counts[pointBucket[i]]; }
+        }
+    });
+
+    const std::size_t ranges = chunks;
+    const std::size_t rangeSize = (tableSize + ranges - 1) / ranges;
+    std::vector<std::uint32_t> rangeOffset(ranges + 1, 0);
+    Parallel::parallelFor(ranges, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t r = begin; r < end; ++r)
+        {
+            std::uint32_t total = 0;
+            for (std::size_t b = r * rangeSize; b < std::min(tableSize, (r + 1) * rangeSize); ++b)
+            {
+                for (std::size_t c = 0; c < chunks; ++c) { total += histogram[c * tableSize + b]; }
+            }
+            rangeOffset[r + 1] = total;
+        }
+    });
+    for (std::size_t r = 0; r < ranges; ++r) { rangeOffset[r + 1] += rangeOffset[r]; }
+
+    Parallel::parallelFor(ranges, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t r = begin; r < end; ++r)
+        {
+            std::uint32_t running = rangeOffset[r];
+            for (std::size_t b = r * rangeSize; b < std::min(tableSize, (r + 1) * rangeSize); ++b)
+            {
+                cellStart[b] = running;
+                for (std::size_t c = 0; c < chunks; ++c)
+                {
+                    const std::uint32_t t = histogram[c * tableSize + b];
+                    histogram[c * tableSize + b] = running;
+                    running += t;
+                }
+            }
+        }
+    });
+    cellStart[tableSize] = static_cast<std::uint32_t>(n);
+
+    Parallel::parallelFor(chunks, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t c = begin; c < end; ++c)
+        {
+            std::uint32_t* offsets = histogram.data() + c * tableSize;
+            for (std::size_t i = c * chunkSize; i < std::min(n, (c + 1) * chunkSize); ++i)
+            {
+                const std::uint32_t slot = offsets[pointBucket[i]]++;
+                entries[slot] = static_cast<std::uint32_t>(i);
+                pointSlot[i] = slot;
+                sortedX[slot] = points[i].x;
+                sortedY[slot] = points[i].y;
+                sortedZ[slot] = points[i].z;
+            }
+        }
+    });
+}
+
+bool SpatialHashGrid::update(const Vector3* points, const std::size_t n)
+{
+    if (n != count || cellStart.empty()) { build(points, n); return true; }
+
+    scratchBuckets.resize(n);
+    Parallel::parallelFor(n, 4096, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH) { computeBuckets(points + i, scratchBuckets.data() + i); }
+        for (; i < end; ++i) { scratchBuckets[i] = bucketOf(points[i]); }
+
+        // points that left their bucket are parked as NaN in the packed arrays and served from the overflow list
+        for (i = begin; i < end; ++i)
+        {
+            const std::uint32_t slot = pointSlot[i];
+            const bool stays = scratchBuckets[i] == pointBucket[i];
+            sortedX[slot] = stays ? points[i].x : PARKED;
+            sortedY[slot] = stays ? points[i].y : PARKED;
+            sortedZ[slot] = stays ? points[i].z : PARKED;
+        }
+    });
+
+    overflow.clear();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (scratchBuckets[i] != pointBucket[i])
+        {
+            overflow.push_back({scratchBuckets[i], static_cast<std::uint32_t>(i), points[i].x, points[i].y, points[i].z});
+        }
+    }
+
+    if (static_cast<float>(overflow.size()) > rebuildFraction * static_cast<float>(n)) { build(points, n); return true; }
+
+    std::sort(overflow.begin(), overflow.end(), [](const MovedPoint& a, const MovedPoint& b) { return a.bucket < b.bucket; });
+    return false;
+}
+
+template <typename Visitor>
+void SpatialHashGrid::visitCells(const Vector3& center, const float radius, Visitor&& visitor) const
+{
+    if (count == 0) { return; }
+
+    const float span = 2.0f * radius * inverseSize + 2.0f;
+    if (!(span * span * span < static_cast<float>(mask)))
+    {
+        for (std::uint32_t b = 0; b <= mask; ++b) { visitor(b); }
+        return;
+    }
+
+    const std::int32_t x0 = cellCoordinate((center.x - radius) * inverseSize);
+    const std::int32_t y0 = cellCoordinate((center.y - radius) * inverseSize);
+    const std::int32_t z0 = cellCoordinate((center.z - radius) * inverseSize);
+    const std::int32_t x1 = cellCoordinate((center.x + radius) * inverseSize);
+    const std::int32_t y1 = cellCoordinate((center.y + radius) * inverseSize);
+    const std::int32_t z1 = cellCoordinate((center.z + radius) * inverseSize);
+
+    std::vector<std::uint32_t>& buckets = visitedBuckets;
+    buckets.clear();
+    for (std::int32_t z = z0; z <= z1; ++z)
+        for (std::int32_t y = y0; y <= y1; ++y)
+            for (std::int32_t x = x0; x <= x1; ++x)
+                buckets.push_back(bucketOf(x, y, z));
+
+    // distinct cells may collide in the table, each bucket must only be scanned once
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    for (const std::uint32_t b : buckets) { visitor(b); }
+}
+
+template <typename Visitor>
+void SpatialHashGrid::visitInRadius(const Vector3& center, const float radius, Visitor&& visitor) const
+{
+    const float r2 = radius * radius;
+    const Float4 cx(center.x), cy(center.y), cz(center.z), limit(r2);
+    const Int4 lanes(0, 1, 2, 3);
+
+    visitCells(center, radius, [&](const std::uint32_t b)
+    {
+        const std::uint32_t end = cellStart[b + 1];
+        for (std::uint32_t j = cellStart[b]; j < end; j += WIDTH)
+        {
+            const Float4 dx = Float4::load(sortedX.data() + j) - cx;
+            const Float4 dy = Float4::load(sortedY.data() + j) - cy;
+            const Float4 dz = Float4::load(sortedZ.data() + j) - cz;
+            const Float4 d2 = dot3(dx, dy, dz, dx, dy, dz);
+            const Float4 valid = asMask(lanes < Int4(static_cast<std::int32_t>(end - j)));
+            int hits = moveMask((d2 <= limit) & valid);
+            while (hits)
+            {
+                const int lane = std::countr_zero(static_cast<unsigned>(hits));
+                visitor(entries[j + lane], d2[lane]);
+                hits &= hits - 1;
+            }
+        }
+
+        const auto moved = std::equal_range(overflow.begin(), overflow.end(), MovedPoint{b, 0, 0.0f, 0.0f, 0.0f},
+                                            [](const MovedPoint& a, const MovedPoint& c) { return a.bucket < c.bucket; });
+        for (auto it = moved.first; it != moved.second; ++it)
+        {
+            const float d2 = Vector3(it->x - center.x, it->y - center.y, it->z - center.z).squaredMagnitude();
+            if (d2 <= r2) { visitor(it->index, d2); }
+        }
+    });
+}
+
+void SpatialHashGrid::queryRadius(const Vector3& center, const float radius, std::vector<std::uint32_t>& out) const
+{
+    out.clear();
+    visitInRadius(center, radius, [&](const std::uint32_t index, float) { out.push_back(index); });
+}
+
+void SpatialHashGrid::queryNearest(const Vector3& center, const std::size_t k, const float maxRadius, std::vector<Neighbor>& out) const
+{
+    out.clear();
+    if (k == 0 || count == 0) { return; }
+
+    float radius = std::min(size, maxRadius);
+    for (;;)
+    {
+        out.clear();
+        visitInRadius(center, radius, [&](const std::uint32_t index, const float d2) { out.push_back({index, d2}); });
+
+        // once k points lie inside the searched sphere the k nearest are among them
+        if (out.size() >= k || out.size() == count || radius >= maxRadius)
+        {
+            const std::size_t kept = std::min(k, out.size());
+            std::partial_sort(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(kept), out.end(),
+                              [](const Neighbor& a, const Neighbor& b) { return a.squaredDistance < b.squaredDistance; });
+            out.resize(kept);
+            return;
+        }
+        radius = std::min(radius * 2.0f, maxRadius);
+    }
+}
+
+void SpatialHashGrid::queryRadiusBatch(const Vector3* centers, const std::size_t n, const float radius,
+                                       std::vector<std::uint32_t>& offsets, std::vector<std::uint32_t>& indices) const
+{
+    constexpr std::size_t BLOCK = 256;
+    const std::size_t blocks = (n + BLOCK - 1) / BLOCK;
+    std::vector<std::vector<std::uint32_t>> blockIndices(blocks);
+    offsets.assign(n + 1, 0);
+
+    Parallel::parallelFor(blocks, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::vector<std::uint32_t> found;
+        for (std::size_t block = begin; block < end; ++block)
+        {
+            for (std::size_t q = block * BLOCK; q < std::min(n, (block + 1) * BLOCK); ++q)
+            {
+                queryRadius(centers[q], radius, found);
+                blockIndices[block].insert(blockIndices[block].end(), found.begin(), found.end());
+                offsets[q + 1] = static_cast<std::uint32_t>(found.size());
+            }
+        }
+    });
+
+    for (std::size_t q = 0; q < n; ++q) { offsets[q + 1] += offsets[q]; }
+    indices.resize(offsets[n]);
+    for (std::size_t block = 0; block < blocks; ++block)
+    {
+        std::copy(blockIndices[block].begin(), blockIndices[block].end(), indices.begin() + offsets[block * BLOCK]);
+    }
+}
+
+void SpatialHashGrid::queryNearestBatch(const Vector3* centers, const std::size_t n, const std::size_t k, const float maxRadius,
+                                        std::uint32_t* outIndices, float* outSquaredDistances) const
+{
+    Parallel::parallelFor(n, 64, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t q = begin; q < end; ++q)
+        {
+            queryNearest(centers[q], k, maxRadius, nearestCandidates);
+            for (std::size_t i = 0; i < k; ++i)
+            {
+                const bool hit = i < nearestCandidates.size();
+                outIndices[q * k + i] = hit ? nearestCandidates[i].index : std::numeric_limits<std::uint32_t>::max();
+                outSquaredDistances[q * k + i] = hit ? nearestCandidates[i].squaredDistance : FAR_AWAY;
+            }
+        }
+    });
+}
@@ -0,0 +1,318 @@
+#include "spline.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Curves;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Vector2;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr std::size_t EVALUATE_GRAIN = 4096;
+    constexpr std::size_t MAP_BLOCK = 64;
+    constexpr int MAX_FLATTEN_DEPTH = 16;
+
+    // 5-point Gauss-Legendre on [-1, 1]
+    constexpr float GAUSS_NODES[5] = {0.0f, -0.5384693101f, 0.5384693101f, -0.9061798459f, 0.9061798459f};
+    constexpr float GAUSS_WEIGHTS[5] = {0.5688888889f, 0.4786286705f, 0.4786286705f, 0.2369268851f, 0.2369268851f};
+
+    template <typename Vector>
+    Vector fromComponents(const float* c);
+
+    template <>
+    Vector2 fromComponents<Vector2>(const float* c) { return {c[0], c[1]}; }
+
+    template <>
+    Vector3 fromComponents<Vector3>(const float* c) { return {c[0], c[1], c[2]}; }
+
+    template <typename Vector>
+    float distance(const Vector& a, const Vector& b) { return (a - b).magnitude(); }
+}
+
+template <typename Vector>
+Spline<Vector> Spline<Vector>::bezier(const std::vector<Vector>& controlPoints)
+{
+    Spline spline;
+    for (std::size_t i = 0; i + 3 < controlPoints.size(); i += 3)
+    {
+        const Vector& b0 = controlPoints[i];
+        const Vector& b3 = controlPoints[i + 3];
+        spline.appendSegment(b0, b3, (controlPoints[i + 1] - b0) * 3.0f, (b3 - controlPoints[i + 2]) * 3.0f);
+    }
+    if (spline.segments == 0 && !controlPoints.empty()) { spline.appendSegment(controlPoints[0], controlPoints[0], Vector(), Vector()); }
+    return spline;
+}
+
+template <typename Vector>
+Spline<Vector> Spline<Vector>::catmullRom(const std::vector<Vector>& points, const float alpha)
+{
+    Spline spline;
+    const std::size_t n = points.size();
+    if (n < 2)
+    {
+        if (n == 1) { spline.appendSegment(points[0], points[0], Vector(), Vector()); }
+        return spline;
+    }
+
+    // phantom end points mirror their neighbours so the curve reaches the first and last point
+    const auto point = [&](const std::ptrdiff_t i) -> Vector
+    {
+        if (i < 0) { return points[0] * 2.0f - points[1]; }
+        if (i >= static_cast<std::ptrdiff_t>(n)) { return points[n - 1] * 2.0f - points[n - 2]; }
+        return points[i];
+    };
+    const auto knot = [&](const Vector& a, const Vector& b) { return std::max(std::pow(distance(a, b), alpha), 1e-6f); };
+
+    for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+        const std::ptrdiff_t k = static_cast<std::ptrdiff_t>(i);
+        const Vector p0 = point(k - 1), p1 = point(k), p2 = point(k + 1), p3 = point(k + 2);
+        const float t01 = knot(p0, p1), t12 = knot(p1, p2), t23 = knot(p2, p3);
+
+        // Barry-Goldman tangents of the non-uniform curve, rescaled to the unit segment
+        const Vector m1 = ((p1 - p0) * (1.0f / t01) - (p2 - p0) * (1.0f / (t01 + t12)) + (p2 - p1) * (1.0f / t12)) * t12;
+        const Vector m2 = ((p2 - p1) * (1.0f / t12) - (p3 - p1) * (1.0f / (t12 + t23)) + (p3 - p2) * (1.0f / t23)) * t12;
+        spline.appendSegment(p1, p2, m1, m2);
+    }
+    return spline;
+}
+
+template <typename Vector>
+Spline<Vector> Spline<Vector>::hermite(const std::vector<Vector>& points, const std::vector<Vector>& tangents)
+{
+    Spline spline;
+    const std::size_t n = std::min(points.size(), tangents.size());
+    for (std::size_t i = 0; i + 1 < n; ++i) { spline.appendSegment(points[i], points[i + 1], tangents[i], tangents[i + 1]); }
+    if (spline.segments == 0 && n == 1) { spline.appendSegment(points[0], points[0], Vector(), Vector()); }
+    return spline;
+}
+
+template <typename Vector>
+void Spline<Vector>::appendSegment(const Vector& p0, const Vector& p1, const Vector& m0, const Vector& m1)
+{
+    for (int d = 0; d < DIMENSION; ++d)
+    {
+        coefficients.push_back(2.0f * p0[d] - 2.0f * p1[d] + m0[d] + m1[d]);
+        coefficients.push_back(-3.0f * p0[d] + 3.0f * p1[d] - 2.0f * m0[d] - m1[d]);
+        coefficients.push_back(m0[d]);
+        coefficients.push_back(p0[d]);
+    }
+    ++segments;
+    arcLengths.clear();
+}
+
+template <typename Vector>
+Vector Spline<Vector>::evaluate(const float u) const
+{
+    if (segments == 0) { return Vector(); }
+    const float s = std::min(std::floor(std::max(u, 0.0f)), static_cast<float>(segments - 1));
+    const float t = std::clamp(u - s, 0.0f, 1.0f);
+    const float* c = coefficients.data() + static_cast<std::size_t>(s) * STRIDE;
+
+    float out[DIMENSION];
+    for (int d = 0; d < DIMENSION; ++d, c += 4) { out[d] = ((c[0] * t + c[1]) * t + c[2]) * t + c[3]; }
+    return fromComponents<Vector>(out);
+}
+
+template <typename Vector>
+Vector Spline<Vector>::tangent(const float u) const
+{
+    if (segments == 0) { return Vector(); }
+    const float s = std::min(std::floor(std::max(u, 0.0f)), static_cast<float>(segments - 1));
+    const float t = std::clamp(u - s, 0.0f, 1.0f);
+    const float* c = coefficients.data() + static_cast<std::size_t>(s) * STRIDE;
+
+    float out[DIMENSION];
+    for (int d = 0; d < DIMENSION; ++d, c += 4) { out[d] = (3.0f * c[0] * t + 2.0f * c[1]) * t + c[2]; }
+    return fromComponents<Vector>(out);
+}
+
+template <typename Vector>
+void Spline<Vector>::evaluateRange(const float* u, const std::size_t n, Vector* positions, Vector* tangents) const
+{
+    const Float4 zero(0.0f), one(1.0f), last(static_cast<float>(segments - 1));
+    std::size_t i = 0;
+    for (; i + WIDTH <= n; i += WIDTH)
+    {
+        const Float4 uu = Float4::load(u + i);
+        const Float4 s = min(floor(max(uu, zero)), last);
+        const Float4 t = clamp(uu - s, zero, one);
+        alignas(16) std::int32_t lanes[WIDTH];
+        truncateToInt(s).store(lanes);
+
+        alignas(16) float position[DIMENSION][WIDTH];
+        alignas(16) float slope[DIMENSION][WIDTH];
+        for (int d = 0; d < DIMENSION; ++d)
+        {
+            // one (a, b, c, d) load per lane, transposed into per-coefficient registers
+            Float4 a = Float4::load(coefficients.data() + lanes[0] * STRIDE + d * 4);
+            Float4 b = Float4::load(coefficients.data() + lanes[1] * STRIDE + d * 4);
+            Float4 c = Float4::load(coefficients.data() + lanes[2] * STRIDE + d * 4);
+            Float4 e = Float4::load(coefficients.data() + lanes[3] * STRIDE + d * 4);
+            transpose(a, b, c, e);
+            multiplyAdd(multiplyAdd(multiplyAdd(a, t, b), t, c), t, e).store(position[d]);
+            multiplyAdd(multiplyAdd(a * Float4(3.0f), t, b * Float4(2.0f)), t, c).store(slope[d]);
+        }
+
+        for (int k = 0; k < WIDTH; ++k)
+        {
+            float component[DIMENSION];
+            if (positions)
+            {
+                for (int d = 0; d < DIMENSION; ++d) { component[d] = position[d][k]; }
+                positions[i + k] = fromComponents<Vector>(component);
+            }
+            if (tangents)
+            {
+                for (int d = 0; d < DIMENSION; ++d) { component[d] = slope[d][k]; }
+                tangents[i + k] = fromComponents<Vector>(component);
+            }
+        }
+    }
+    for (; i < n; ++i)
+    {
+        if (positions) { positions[i] = evaluate(u[i]); }
+        if (tangents) { tangents[i] = tangent(u[i]); }
+    }
+}
+
+template <typename Vector>
+void Spline<Vector>::evaluate(const float* u, const std::size_t n, Vector* positions, Vector* tangents) const
+{
+    if (segments == 0) { return; }
+    Parallel::parallelFor(n, EVALUATE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        evaluateRange(u + begin, end - begin, positions ? positions + begin : nullptr, tangents ? tangents + begin : nullptr);
+    });
+}
+
+template <typename Vector>
+float Spline<Vector>::speed(const std::size_t segment, const float t) const
+{
+    const float* c = coefficients.data() + segment * STRIDE;
+    float squared = 0.0f;
+    for (int d = 0; d < DIMENSION; ++d, c += 4)
+    {
+        const float v = (3.0f * c[0] * t + 2.0f * c[1]) * t + c[2];
+        squared += v * v;
+    }
+    return std::sqrt(squared);
+}
+
+template <typename Vector>
+float Spline<Vector>::segmentLength(const std::size_t segment, const float t0, const float t1) const
+{
+    const float half = 0.5f * (t1 - t0);
+    const float mid = 0.5f * (t0 + t1);
+    float sum = 0.0f;
+    for (int k = 0; k < 5; ++k) { sum += GAUSS_WEIGHTS[k] * speed(segment, mid + half * GAUSS_NODES[k]); }
+    return sum * half;
+}
+
+template <typename Vector>
+void Spline<Vector>::buildArcLengthTable(const std::size_t subdivisions)
+{
+    arcSubdivisions = std::max<std::size_t>(subdivisions, 1);
+    arcLengths.assign(segments * arcSubdivisions + 1, 0.0f);
+
+    const float step = 1.0f / static_cast<float>(arcSubdivisions);
+    for (std::size_t s = 0; s < segments; ++s)
+    {
+        for (std::size_t k = 0; k < arcSubdivisions; ++k)
+        {
+            const std::size_t j = s * arcSubdivisions + k;
+            arcLengths[j + 1] = arcLengths[j] + segmentLength(s, static_cast<float>(k) * step, static_cast<float>(k + 1) * step);
+        }
+    }
+}
+
+template <typename Vector>
+float Spline<Vector>::parameterAtDistance(const float distance) const
+{
+    if (arcLengths.size() < 2) { return 0.0f; }
+
+    const float target = std::clamp(distance, 0.0f, arcLengths.back());
+    const std::size_t j = std::min<std::size_t>(std::upper_bound(arcLengths.begin(), arcLengths.end(), target) - arcLengths.begin(), arcLengths.size() - 1) - 1;
+    const std::size_t segment = j / arcSubdivisions;
+    const float step = 1.0f / static_cast<float>(arcSubdivisions);
+    const float t0 = static_cast<float>(j % arcSubdivisions) * step;
+
+    // linear guess inside the table interval, then Newton on the exact arc length
+    const float span = arcLengths[j + 1] - arcLengths[j];
+    float t = t0 + (span > 0.0f ? (target - arcLengths[j]) / span : 0.0f) * step;
+    for (int iteration = 0; iteration < 4; ++iteration)
+    {
+        const float v = speed(segment, t);
+        if (v <= 1e-12f) { break; }
+        t = std::clamp(t - (arcLengths[j] + segmentLength(segment, t0, t) - target) / v, t0, t0 + step);
+    }
+    return static_cast<float>(segment) + t;
+}
+
+template <typename Vector>
+void Spline<Vector>::evaluateAtDistances(const float* distances, const std::size_t n, Vector* positions, Vector* tangents) const
+{
+    if (segments == 0) { return; }
+    Parallel::parallelFor(n, EVALUATE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        float u[MAP_BLOCK];
+        for (std::size_t block = begin; block < end; block += MAP_BLOCK)
+        {
+            const std::size_t count = std::min(MAP_BLOCK, end - block);
+            for (std::size_t i = 0; i < count; ++i) { u[i] = parameterAtDistance(distances[block + i]); }
+            evaluateRange(u, count, positions ? positions + block : nullptr, tangents ? tangents + block : nullptr);
+        }
+    });
+}
+
+template <typename Vector>
+void Spline<Vector>::flatten(const float tolerance, std::vector<Vector>& points) const
+{
+    if (segments == 0) { return; }
+
+    struct Interval
+    {
+        float t0, t1;
+        int depth;
+    };
+    Interval stack[MAX_FLATTEN_DEPTH + 1];
+
+    points.push_back(evaluate(0.0f));
+    for (std::size_t s = 0; s < segments; ++s)
+    {
+        const float base = static_cast<float>(s);
+        int top = 0;
+        stack[top++] = {0.0f, 1.0f, 0};
+        while (top > 0)
+        {
+            // depth-first with the left half on top keeps the output in curve order
+            const Interval interval = stack[--top];
+            const Vector a = evaluate(base + interval.t0);
+            const Vector b = evaluate(base + interval.t1);
+            const float h = interval.t1 - interval.t0;
+
+            float deviation = 0.0f;
+            for (const float f : {0.25f, 0.5f, 0.75f})
+            {
+                deviation = std::max(deviation, distance(evaluate(base + interval.t0 + f * h), a + (b - a) * f));
+            }
+
+            if (deviation <= tolerance || interval.depth >= MAX_FLATTEN_DEPTH)
+            {
+                points.push_back(b);
+                continue;
+            }
+            const float mid = interval.t0 + 0.5f * h;
+            stack[top++] = {mid, interval.t1, interval.depth + 1};
+            stack[top++] = {interval.t0, mid, interval.depth + 1};
+        }
+    }
+}
+
+template class Kronos::CoreSystems::Curves::Spline<Vector2>;
+template class Kronos::CoreSystems::Curves::Spline<Vector3>;
@@ -0,0 +1,256 @@
+#include "transform.hpp"
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Math;
+using namespace Kronos::CoreSystems::Simd;
+
+namespace
+{
+    constexpr std::size_t TRANSFORM_GRAIN = 2048;
+    constexpr int POLAR_ITERATIONS = 12;
+    constexpr float POLAR_TOLERANCE = 1e-6f;
+
+    // rows[r][c] holds element (r, c) of four matrices, one per lane
+    using MatrixLanes = Float4[4][4];
+
+    struct TransformLanes
+    {
+        Float4 tx, ty, tz;
+        Float4 qx, qy, qz, qw;
+        Float4 sx, sy, sz;
+    };
+
+    void loadMatrices(const Matrix4x4* m, MatrixLanes& rows)
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+            rows[r][0] = Float4::load(&m[0].m00 + r * 4);
+            rows[r][1] = Float4::load(&m[1].m00 + r * 4);
+            rows[r][2] = Float4::load(&m[2].m00 + r * 4);
+            rows[r][3] = Float4::load(&m[3].m00 + r * 4);
+            transpose(rows[r][0], rows[r][1], rows[r][2], rows[r][3]);
+        }
+    }
+
+    void storeMatrices(MatrixLanes& rows, Matrix4x4* m)
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+            transpose(rows[r][0], rows[r][1], rows[r][2], rows[r][3]);
+            for (int k = 0; k < WIDTH; ++k) { rows[r][k].store(&m[k].m00 + r * 4); }
+        }
+    }
+
+    void broadcastMatrix(const Matrix4x4& m, MatrixLanes& rows)
+    {
+        const float* e = &m.m00;
+        for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { rows[r][c] = Float4(e[r * 4 + c]); } }
+    }
+
+    TransformLanes loadTransforms(const TransformTRS* t)
+    {
+        TransformLanes lanes;
+        lanes.tx = Float4(t[0].translation.x, t[1].translation.x, t[2].translation.x, t[3].translation.x);
+        lanes.ty = Float4(t[0].translation.y, t[1].translation.y, t[2].translation.y, t[3].translation.y);
+        lanes.tz = Float4(t[0].translation.z, t[1].translation.z, t[2].translation.z, t[3].translation.z);
+        lanes.qx = Float4::load(&t[0].rotation.x);
+        lanes.qy = Float4::load(&t[1].rotation.x);
+        lanes.qz = Float4::load(&t[2].rotation.x);
+        lanes.qw = Float4::load(&t[3].rotation.x);
+        transpose(lanes.qx, lanes.qy, lanes.qz, lanes.qw);
+        lanes.sx = Float4(t[0].scale.x, t[1].scale.x, t[2].scale.x, t[3].scale.x);
+        lanes.sy = Float4(t[0].scale.y, t[1].scale.y, t[2].scale.y, t[3].scale.y);
+        lanes.sz = Float4(t[0].scale.z, t[1].scale.z, t[2].scale.z, t[3].scale.z);
+        return lanes;
+    }
+
+    TransformTRS transformAt(const TransformLanes& lanes, const int k)
+    {
+        TransformTRS t;
+        t.translation = {lanes.tx[k], lanes.ty[k], lanes.tz[k]};
+        t.rotation = {lanes.qx[k], lanes.qy[k], lanes.qz[k], lanes.qw[k]};
+        t.scale = {lanes.sx[k], lanes.sy[k], lanes.sz[k]};
+        return t;
+    }
+
+    void composeLanes(const TransformLanes& t, MatrixLanes& rows)
+    {
+        // 2 / |q|^2 tolerates quaternions that have drifted off unit length
+        const Float4 s = Float4(2.0f) / multiplyAdd(t.qx, t.qx, multiplyAdd(t.qy, t.qy, multiplyAdd(t.qz, t.qz, t.qw * t.qw)));
+        const Float4 xs = t.qx * s, ys = t.qy * s, zs = t.qz * s;
+        const Float4 xx = t.qx * xs, yy = t.qy * ys, zz = t.qz * zs;
+        const Float4 xy = t.qx * ys, xz = t.qx * zs, yz = t.qy * zs;
+        const Float4 wx = t.qw * xs, wy = t.qw * ys, wz = t.qw * zs;
+        const Float4 one(1.0f), zero(0.0f);
+
+        rows[0][0] = (one - yy - zz) * t.sx; rows[0][1] = (xy - wz) * t.sy;       rows[0][2] = (xz + wy) * t.sz;       rows[0][3] = t.tx;
+        rows[1][0] = (xy + wz) * t.sx;       rows[1][1] = (one - xx - zz) * t.sy; rows[1][2] = (yz - wx) * t.sz;       rows[1][3] = t.ty;
+        rows[2][0] = (xz - wy) * t.sx;       rows[2][1] = (yz + wx) * t.sy;       rows[2][2] = (one - xx - yy) * t.sz; rows[2][3] = t.tz;
+        rows[3][0] = zero;                   rows[3][1] = zero;                   rows[3][2] = zero;                   rows[3][3] = one;
+    }
+
+    Float4 determinant3(const Float4 (&m)[3][3])
+    {
+        return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+               m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+               m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    }
+
+    void rotationToQuaternion(const Float4 (&r)[3][3], TransformLanes& t)
+    {
+        // Shepperd: build from whichever of w, x, y, z has the largest radicand so no division is ill-conditioned
+        const Float4 trace = r[0][0] + r[1][1] + r[2][2];
+        const Float4 one(1.0f), quarter(0.25f), zero(0.0f);
+
+        const Float4 sw = sqrt(max(one + trace, zero)) * Float4(2.0f);
+        const Float4 sx = sqrt(max(one + r[0][0] - r[1][1] - r[2][2], zero)) * Float4(2.0f);
+        const Float4 sy = sqrt(max(one - r[0][0] + r[1][1] - r[2][2], zero)) * Float4(2.0f);
+        const Float4 sz = sqrt(max(one - r[0][0] - r[1][1] + r[2][2], zero)) * Float4(2.0f);
+
+        const Float4 useW = (trace >= r[0][0]) & (trace >= r[1][1]) & (trace >= r[2][2]);
+        const Float4 useX = andNot(useW, (r[0][0] >= r[1][1]) & (r[0][0] >= r[2][2]));
+        const Float4 useY = andNot(useW | useX, r[1][1] >= r[2][2]);
+
+        const Float4 s = select(useW, sw, select(useX, sx, select(useY, sy, sz)));
+        const Float4 inv = one / max(s, Float4(1e-30f));
+        const Float4 dx = r[2][1] - r[1][2], dy = r[0][2] - r[2][0], dz = r[1][0] - r[0][1];
+        const Float4 sxy = r[0][1] + r[1][0], sxz = r[0][2] + r[2][0], syz = r[1][2] + r[2][1];
+
+        Float4 qw = select(useW, s * quarter, select(useX, dx * inv, select(useY, dy * inv, dz * inv)));
+        Float4 qx = select(useW, dx * inv, select(useX, s * quarter, select(useY, sxy * inv, sxz * inv)));
+        Float4 qy = select(useW, dy * inv, select(useX, sxy * inv, select(useY, s * quarter, syz * inv)));
+        Float4 qz = select(useW, dz * inv, select(useX, sxz * inv, select(useY, syz * inv, s * quarter)));
+
+        // w >= 0 keeps the output canonical for replication
+        const Float4 flip = qw & Float4(-0.0f);
+        const Float4 norm = rsqrt(multiplyAdd(qx, qx, multiplyAdd(qy, qy, multiplyAdd(qz, qz, qw * qw)))) ^ flip;
+        t.qx = qx * norm; t.qy = qy * norm; t.qz = qz * norm; t.qw = qw * norm;
+    }
+
+    void polarRotation(const Float4 (&m)[3][3], Float4 (&r)[3][3])
+    {
+        // scaled Newton iteration X <- (g X + X^-T / g) / 2 (Higham), converging to the orthogonal polar factor
+        for (int i = 0; i < 3; ++i) { for (int j = 0; j < 3; ++j) { r[i][j] = m[i][j]; } }
+
+        for (int iteration = 0; iteration < POLAR_ITERATIONS; ++iteration)
+        {
+            Float4 cofactor[3][3];
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    const int i1 = (i + 1) % 3, i2 = (i + 2) % 3, j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+                    cofactor[i][j] = r[i1][j1] * r[i2][j2] - r[i1][j2] * r[i2][j1];
+                }
+            }
+            const Float4 det = r[0][0] * cofactor[0][0] + r[0][1] * cofactor[0][1] + r[0][2] * cofactor[0][2];
+            const Float4 invDet = Float4(1.0f) / select(abs(det) > Float4(1e-30f), det, Float4(1e-30f));
+
+            Float4 normX(0.0f), normC(0.0f);
+            for (int i = 0; i < 3; ++i) { for (int j = 0; j < 3; ++j) { normX = multiplyAdd(r[i][j], r[i][j], normX); normC = multiplyAdd(cofactor[i][j], cofactor[i][j], normC); } }
+            const Float4 gamma = sqrt(sqrt(normC * invDet * invDet / max(normX, Float4(1e-30f))));
+            const Float4 a = gamma * Float4(0.5f);
+            const Float4 b = invDet * Float4(0.5f) / gamma;
+
+            Float4 change(0.0f);
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    const Float4 next = multiplyAdd(r[i][j], a, cofactor[i][j] * b);
+                    change = max(change, abs(next - r[i][j]));
+                    r[i][j] = next;
+                }
+            }
+            if (!any(change > Float4(POLAR_TOLERANCE))) { break; }
+        }
+    }
+
+    TransformLanes decomposeLanes(const MatrixLanes& rows, const DecomposeMode mode)
+    {
+        TransformLanes t;
+        t.tx = rows[0][3]; t.ty = rows[1][3]; t.tz = rows[2][3];
+
+        Float4 m[3][3];
+        for (int i = 0; i < 3; ++i) { for (int j = 0; j < 3; ++j) { m[i][j] = rows[i][j]; } }
+
+        // a mirrored basis is folded into a negative x scale so the remaining factor is a proper rotation
+        const Float4 mirror = determinant3(m) & Float4(-0.0f);
+        for (int i = 0; i < 3; ++i) { m[i][0] = m[i][0] ^ mirror; }
+
+        Float4 r[3][3];
+        if (mode == DecomposeMode::Polar)
+        {
+            polarRotation(m, r);
+            // diagonal of the symmetric stretch R^T M
+            Float4* scales[3] = {&t.sx, &t.sy, &t.sz};
+            for (int j = 0; j < 3; ++j) { *scales[j] = multiplyAdd(r[0][j], m[0][j], multiplyAdd(r[1][j], m[1][j], r[2][j] * m[2][j])); }
+        }
+        else
+        {
+            Float4* scales[3] = {&t.sx, &t.sy, &t.sz};
+            for (int j = 0; j < 3; ++j)
+            {
+                *scales[j] = sqrt(multiplyAdd(m[0][j], m[0][j], multiplyAdd(m[1][j], m[1][j], m[2][j] * m[2][j])));
+                const Float4 inv = Float4(1.0f) / max(*scales[j], Float4(1e-30f));
+                for (int i = 0; i < 3; ++i) { r[i][j] = m[i][j] * inv; }
+            }
+        }
+        t.sx = t.sx ^ mirror;
+
+        rotationToQuaternion(r, t);
+        return t;
+    }
+}
+
+Matrix4x4 Kronos::CoreSystems::Math::compose(const TransformTRS& transform)
+{
+    const TransformTRS lanes[WIDTH] = {transform, transform, transform, transform};
+    MatrixLanes rows;
+    composeLanes(loadTransforms(lanes), rows);
+
+    Matrix4x4 m;
+    float* e = &m.m00;
+    for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { e[r * 4 + c] = rows[r][c][0]; } }
+    return m;
+}
+
+TransformTRS Kronos::CoreSystems::Math::decompose(const Matrix4x4& m, const DecomposeMode mode)
+{
+    MatrixLanes rows;
+    broadcastMatrix(m, rows);
+    return transformAt(decomposeLanes(rows, mode), 0);
+}
+
+void Kronos::CoreSystems::Math::compose(const TransformTRS* transforms, const std::size_t n, Matrix4x4* out)
+{
+    Parallel::parallelFor(n, TRANSFORM_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            MatrixLanes rows;
+            composeLanes(loadTransforms(transforms + i), rows);
+            storeMatrices(rows, out + i);
+        }
+        for (; i < end; ++i) { out[i] = compose(transforms[i]); }
+    });
+}
+
+void Kronos::CoreSystems::Math::decompose(const Matrix4x4* matrices, const std::size_t n, TransformTRS* out, const DecomposeMode mode)
+{
+    Parallel::parallelFor(n, TRANSFORM_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            MatrixLanes rows;
+            loadMatrices(matrices + i, rows);
+            const TransformLanes t = decomposeLanes(rows, mode);
+            for (int k = 0; k < WIDTH; ++k) { out[i + k] = transformAt(t, k); }
+        }
+        for (; i < end; ++i) { out[i] = decompose(matrices[i], mode); }
+    });
+}
@@ -0,0 +1,398 @@
+#include "xpbd.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+using namespace Kronos::CoreSystems::Physics;
+using namespace Kronos::CoreSystems::Simd;
+using Kronos::CoreSystems::Math::Vector3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    constexpr std::size_t GROUP_GRAIN = 64;
+    constexpr std::size_t PARTICLE_GRAIN = 1024;
+    constexpr float LENGTH_EPSILON = 1e-9f;
+
+    struct Lanes3
+    {
+        Float4 x, y, z;
+    };
+
+    Lanes3 operator+(const Lanes3& a, const Lanes3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    Lanes3 operator-(const Lanes3& a, const Lanes3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    Lanes3 operator*(const Lanes3& a, const Float4& s) { return {a.x * s, a.y * s, a.z * s}; }
+
+    std::array<std::uint32_t, 3> particlesOf(const DistanceConstraint& d) { return {d.a, d.b, d.b}; }
+    std::array<std::uint32_t, 3> particlesOf(const BendingConstraint& b) { return {b.a, b.b, b.c}; }
+    float restOf(const DistanceConstraint& d) { return d.restLength; }
+    float restOf(const BendingConstraint& b) { return b.restDistance; }
+
+    // greedy colouring; MAX_COLORS marks a constraint that found no free colour
+    template <typename Constraint>
+    std::vector<int> assignColors(const std::vector<Constraint>& constraints, const std::size_t particleCount)
+    {
+        std::vector<std::uint64_t> used(particleCount, 0);
+        std::vector<int> colors(constraints.size());
+        for (std::size_t i = 0; i < constraints.size(); ++i)
+        {
+            const std::array<std::uint32_t, 3> p = particlesOf(constraints[i]);
+            const std::uint64_t taken = used[p[0]] | used[p[1]] | used[p[2]];
+            int color = 0;
+            while (color < XpbdSolver::MAX_COLORS && (taken >> color & 1)) { ++color; }
+            colors[i] = color;
+            if (color == XpbdSolver::MAX_COLORS) { continue; }
+            for (const std::uint32_t particle : p) { used[particle] |= std::uint64_t(1) << color; }
+        }
+        return colors;
+    }
+
+    // lanes past count repeat the last constraint so a partial group stays finite; only count lanes are written back
+    void laneIndices(const std::uint32_t* index, const std::size_t count, std::uint32_t (&out)[WIDTH])
+    {
+        for (std::size_t k = 0; k < WIDTH; ++k) { out[k] = index[k < count ? k : count - 1]; }
+    }
+
+    Lanes3 gatherPositions(const ParticleState& s, const std::uint32_t (&i)[WIDTH])
+    {
+        return {Float4(s.positionX[i[0]], s.positionX[i[1]], s.positionX[i[2]], s.positionX[i[3]]),
+                Float4(s.positionY[i[0]], s.positionY[i[1]], s.positionY[i[2]], s.positionY[i[3]]),
+                Float4(s.positionZ[i[0]], s.positionZ[i[1]], s.positionZ[i[2]], s.positionZ[i[3]])};
+    }
+
+    Float4 gatherMasses(const ParticleState& s, const std::uint32_t (&i)[WIDTH])
+    {
+        return Float4(s.inverseMass[i[0]], s.inverseMass[i[1]], s.inverseMass[i[2]], s.inverseMass[i[3]]);
+    }
+
+    void scatterPositions(ParticleState& s, const std::uint32_t (&i)[WIDTH], const std::size_t count, const Lanes3& p)
+    {
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            const int lane = static_cast<int>(k);
+            s.positionX[i[k]] = p.x[lane];
+            s.positionY[i[k]] = p.y[lane];
+            s.positionZ[i[k]] = p.z[lane];
+        }
+    }
+
+    // XPBD multiplier update: dlambda = (-C - alpha lambda) / (sum w |grad|^2 + alpha), zero where undefined
+    Float4 multiplierStep(const Float4& constraint, const Float4& weight, const Float4& alpha, const Float4& lambda, const Float4& valid)
+    {
+        const Float4 denominator = weight + alpha;
+        const Float4 ok = valid & (denominator > Float4(0.0f));
+        return select(ok, (-constraint - alpha * lambda) / select(ok, denominator, Float4(1.0f)), Float4(0.0f));
+    }
+
+    void solveDistanceLanes(Lanes3& pa, Lanes3& pb, const Float4& wa, const Float4& wb, const Float4& rest, const Float4& alpha, Float4& lambda)
+    {
+        const Lanes3 d = pb - pa;
+        const Float4 length = sqrt(dot3(d.x, d.y, d.z, d.x, d.y, d.z));
+        const Float4 valid = length > Float4(LENGTH_EPSILON);
+        const Lanes3 n = d * (Float4(1.0f) / select(valid, length, Float4(1.0f)));
+
+        const Float4 dl = multiplierStep(length - rest, wa + wb, alpha, lambda, valid);
+        lambda = lambda + dl;
+        pa = pa - n * (wa * dl);
+        pb = pb + n * (wb * dl);
+    }
+
+    void solveBendingLanes(Lanes3& pa, Lanes3& pb, Lanes3& pc, const Float4& wa, const Float4& wb, const Float4& wc, const Float4& rest, const Float4& alpha, Float4& lambda)
+    {
+        const Float4 third(1.0f / 3.0f);
+        const Lanes3 d = pb - (pa + pb + pc) * third;
+        const Float4 length = sqrt(dot3(d.x, d.y, d.z, d.x, d.y, d.z));
+        const Float4 valid = length > Float4(LENGTH_EPSILON);
+        const Lanes3 n = d * (Float4(1.0f) / select(valid, length, Float4(1.0f)));
+
+        // gradients are 2/3 n for the middle particle and -1/3 n for the ends
+        const Float4 weight = (Float4(4.0f) * wb + wa + wc) * Float4(1.0f / 9.0f);
+        const Float4 dl = multiplierStep(length - rest, weight, alpha, lambda, valid);
+        lambda = lambda + dl;
+        const Lanes3 step = n * (dl * third);
+        pa = pa - step * wa;
+        pb = pb + step * (Float4(2.0f) * wb);
+        pc = pc - step * wc;
+    }
+
+    void pushOut(Float4& x, Float4& y, Float4& z, const Float4& dx, const Float4& dy, const Float4& dz, const Float4& radius, const Float4& movable)
+    {
+        const Float4 length = sqrt(dot3(dx, dy, dz, dx, dy, dz));
+        const Float4 hit = movable & (length < radius) & (length > Float4(LENGTH_EPSILON));
+        const Float4 scale = select(hit, (radius - length) / select(hit, length, Float4(1.0f)), Float4(0.0f));
+        x = multiplyAdd(dx, scale, x);
+        y = multiplyAdd(dy, scale, y);
+        z = multiplyAdd(dz, scale, z);
+    }
+}
+
+void ParticleState::resize(const std::size_t n)
+{
+    for (std::vector<float>* stream : {&positionX, &positionY, &positionZ, &previousX, &previousY, &previousZ,
+                                       &velocityX, &velocityY, &velocityZ, &inverseMass})
+    {
+        stream->assign(n, 0.0f);
+    }
+}
+
+ClothConstraints Kronos::CoreSystems::Physics::makeRope(const std::vector<Vector3>& positions, const float stretchCompliance, const float bendCompliance)
+{
+    ClothConstraints result;
+    const std::uint32_t n = static_cast<std::uint32_t>(positions.size());
+    for (std::uint32_t i = 0; i + 1 < n; ++i) { result.distances.push_back({i, i + 1, (positions[i + 1] - positions[i]).magnitude(), stretchCompliance}); }
+    for (std::uint32_t i = 0; i + 2 < n; ++i)
+    {
+        const Vector3 centroid = (positions[i] + positions[i + 1] + positions[i + 2]) * (1.0f / 3.0f);
+        result.bends.push_back({i, i + 1, i + 2, (positions[i + 1] - centroid).magnitude(), bendCompliance});
+    }
+    return result;
+}
+
+ClothConstraints Kronos::CoreSystems::Physics::makeClothGrid(const std::vector<Vector3>& positions, const int columns, const int rows,
+                                                             const float stretchCompliance, const float shearCompliance, const float bendCompliance)
+{
+    ClothConstraints result;
+    const auto index = [columns](const int r, const int c) { return static_cast<std::uint32_t>(r * columns + c); };
+    const auto distance = [&](const std::uint32_t a, const std::uint32_t b, const float compliance)
+    {
+        result.distances.push_back({a, b, (positions[b] - positions[a]).magnitude(), compliance});
+    };
+    const auto bend = [&](const std::uint32_t a, const std::uint32_t b, const std::uint32_t c)
+    {
+        const Vector3 centroid = (positions[a] + positions[b] + positions[c]) * (1.0f / 3.0f);
+        result.bends.push_back({a, b, c, (positions[b] - centroid).magnitude(), bendCompliance});
+    };
+
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int c = 0; c < columns; ++c)
+        {
+            if (c + 1 < columns) { distance(index(r, c), index(r, c + 1), stretchCompliance); }
+            if (r + 1 < rows) { distance(index(r, c), index(r + 1, c), stretchCompliance); }
+            if (c + 1 < columns && r + 1 < rows)
+            {
+                distance(index(r, c), index(r + 1, c + 1), shearCompliance);
+                distance(index(r, c + 1), index(r + 1, c), shearCompliance);
+            }
+            if (c + 2 < columns) { bend(index(r, c), index(r, c + 1), index(r, c + 2)); }
+            if (r + 2 < rows) { bend(index(r, c), index(r + 1, c), index(r + 2, c)); }
+        }
+    }
+    return result;
+}
+
+XpbdSolver::XpbdSolver(const std::vector<Vector3>& positions, const std::vector<float>& inverseMasses, const ClothConstraints& constraints) : count(positions.size())
+{
+    // padding particles have zero inverse mass so whole SIMD groups can be integrated
+    particles.resize(roundUpToWidth(count));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        setPosition(i, positions[i]);
+        particles.inverseMass[i] = inverseMasses[i];
+    }
+
+    const auto distribute = [&](const auto& source, std::vector<ConstraintColor>& colors)
+    {
+        const std::vector<int> assigned = assignColors(source, particles.inverseMass.size());
+        const int colorCount = assigned.empty() ? 0 : *std::max_element(assigned.begin(), assigned.end()) + 1;
+        colors.assign(static_cast<std::size_t>(colorCount), {});
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            ConstraintColor& color = colors[assigned[i]];
+            const std::array<std::uint32_t, 3> p = particlesOf(source[i]);
+            color.a.push_back(p[0]);
+            color.b.push_back(p[1]);
+            color.c.push_back(p[2]);
+            color.rest.push_back(restOf(source[i]));
+            color.compliance.push_back(source[i].compliance);
+        }
+        if (colorCount > MAX_COLORS) { colors.back().serial = true; }
+        colors.erase(std::remove_if(colors.begin(), colors.end(), [](const ConstraintColor& c) { return c.size() == 0; }), colors.end());
+        for (ConstraintColor& color : colors) { color.lambda.assign(color.size(), 0.0f); }
+    };
+    distribute(constraints.distances, distanceColors);
+    distribute(constraints.bends, bendingColors);
+}
+
+void XpbdSolver::setPosition(const std::size_t i, const Vector3& p)
+{
+    particles.positionX[i] = particles.previousX[i] = p.x;
+    particles.positionY[i] = particles.previousY[i] = p.y;
+    particles.positionZ[i] = particles.previousZ[i] = p.z;
+}
+
+void XpbdSolver::step(const float dt, const XpbdParams& params, const ColliderSet* colliders)
+{
+    if (!(dt > 0.0f)) { return; }
+
+    // small steps: one or few iterations per substep with multipliers reset every substep
+    const int substeps = std::max(params.substeps, 1);
+    const float h = dt / static_cast<float>(substeps);
+    for (int s = 0; s < substeps; ++s)
+    {
+        integrate(h, params);
+        for (std::vector<ConstraintColor>* colors : {&distanceColors, &bendingColors})
+        {
+            for (ConstraintColor& color : *colors) { std::fill(color.lambda.begin(), color.lambda.end(), 0.0f); }
+        }
+        for (int iteration = 0; iteration < std::max(params.iterations, 1); ++iteration)
+        {
+            solveColors(distanceColors, false, h);
+            solveColors(bendingColors, true, h);
+            if (colliders) { collide(*colliders, params.particleRadius); }
+        }
+        updateVelocities(h, params.damping);
+    }
+}
+
+void XpbdSolver::integrate(const float h, const XpbdParams& params)
+{
+    ParticleState& s = particles;
+    Parallel::parallelFor(s.inverseMass.size(), PARTICLE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        const Float4 step(h);
+        const Float4 gx(params.gravity.x * h), gy(params.gravity.y * h), gz(params.gravity.z * h);
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            const Float4 movable = Float4::load(s.inverseMass.data() + i) > Float4(0.0f);
+            const Float4 vx = select(movable, Float4::load(s.velocityX.data() + i) + gx, Float4(0.0f));
+            const Float4 vy = select(movable, Float4::load(s.velocityY.data() + i) + gy, Float4(0.0f));
+            const Float4 vz = select(movable, Float4::load(s.velocityZ.data() + i) + gz, Float4(0.0f));
+            vx.store(s.velocityX.data() + i);
+            vy.store(s.velocityY.data() + i);
+            vz.store(s.velocityZ.data() + i);
+
+            const Float4 x = Float4::load(s.positionX.data() + i), y = Float4::load(s.positionY.data() + i), z = Float4::load(s.positionZ.data() + i);
+            x.store(s.previousX.data() + i);
+            y.store(s.previousY.data() + i);
+            z.store(s.previousZ.data() + i);
+            multiplyAdd(vx, step, x).store(s.positionX.data() + i);
+            multiplyAdd(vy, step, y).store(s.positionY.data() + i);
+            multiplyAdd(vz, step, z).store(s.positionZ.data() + i);
+        }
+    });
+}
+
+void XpbdSolver::solveColors(std::vector<ConstraintColor>& colors, const bool bending, const float h)
+{
+    const Float4 inverseStep2(1.0f / (h * h));
+    const auto loadLanes = [](const float* p, const std::size_t lanes)
+    {
+        if (lanes == WIDTH) { return Float4::load(p); }
+        float t[WIDTH];
+        for (std::size_t k = 0; k < WIDTH; ++k) { t[k] = p[k < lanes ? k : lanes - 1]; }
+        return Float4::load(t);
+    };
+
+    for (ConstraintColor& color : colors)
+    {
+        const auto solveGroup = [&](const std::size_t first, const std::size_t lanes)
+        {
+            std::uint32_t ia[WIDTH], ib[WIDTH], ic[WIDTH];
+            laneIndices(color.a.data() + first, lanes, ia);
+            laneIndices(color.b.data() + first, lanes, ib);
+            Lanes3 pa = gatherPositions(particles, ia), pb = gatherPositions(particles, ib);
+            const Float4 wa = gatherMasses(particles, ia), wb = gatherMasses(particles, ib);
+            const Float4 rest = loadLanes(color.rest.data() + first, lanes);
+            const Float4 alpha = loadLanes(color.compliance.data() + first, lanes) * inverseStep2;
+            Float4 lambda = loadLanes(color.lambda.data() + first, lanes);
+
+            if (bending)
+            {
+                laneIndices(color.c.data() + first, lanes, ic);
+                Lanes3 pc = gatherPositions(particles, ic);
+                solveBendingLanes(pa, pb, pc, wa, wb, gatherMasses(particles, ic), rest, alpha, lambda);
+                scatterPositions(particles, ic, lanes, pc);
+            }
+            else
+            {
+                solveDistanceLanes(pa, pb, wa, wb, rest, alpha, lambda);
+            }
+            scatterPositions(particles, ia, lanes, pa);
+            scatterPositions(particles, ib, lanes, pb);
+            for (std::size_t k = 0; k < lanes; ++k) { color.lambda[first + k] = lambda[static_cast<int>(k)]; }
+        };
+
+        if (color.serial)
+        {
+            for (std::size_t i = 0; i < color.size(); ++i) { solveGroup(i, 1); }
+            continue;
+        }
+
+        const std::size_t groups = (color.size() + WIDTH - 1) / WIDTH;
+        Parallel::parallelFor(groups, GROUP_GRAIN, [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t g = begin; g < end; ++g)
+            {
+                const std::size_t first = g * WIDTH;
+                solveGroup(first, std::min<std::size_t>(WIDTH, color.size() - first));
+            }
+        });
+    }
+}
+
+void XpbdSolver::collide(const ColliderSet& colliders, const float radius)
+{
+    ParticleState& s = particles;
+    Parallel::parallelFor(s.inverseMass.size(), PARTICLE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            const Float4 movable = Float4::load(s.inverseMass.data() + i) > Float4(0.0f);
+            Float4 x = Float4::load(s.positionX.data() + i), y = Float4::load(s.positionY.data() + i), z = Float4::load(s.positionZ.data() + i);
+
+            for (const SphereCollider& sphere : colliders.spheres)
+            {
+                pushOut(x, y, z, x - Float4(sphere.center.x), y - Float4(sphere.center.y), z - Float4(sphere.center.z), Float4(sphere.radius + radius), movable);
+            }
+            for (const CapsuleCollider& capsule : colliders.capsules)
+            {
+                const Vector3 axis = capsule.b - capsule.a;
+                const float length2 = axis.dot(axis);
+                const Float4 ax(axis.x), ay(axis.y), az(axis.z);
+                const Float4 rx = x - Float4(capsule.a.x), ry = y - Float4(capsule.a.y), rz = z - Float4(capsule.a.z);
+                const Float4 t = length2 > 0.0f ? clamp(dot3(rx, ry, rz, ax, ay, az) * Float4(1.0f / length2), Float4(0.0f), Float4(1.0f)) : Float4(0.0f);
+                pushOut(x, y, z, rx - ax * t, ry - ay * t, rz - az * t, Float4(capsule.radius + radius), movable);
+            }
+            for (const PlaneCollider& plane : colliders.planes)
+            {
+                const Float4 nx(plane.normal.x), ny(plane.normal.y), nz(plane.normal.z);
+                const Float4 separation = dot3(nx, ny, nz, x, y, z) - Float4(plane.distance + radius);
+                const Float4 push = select(movable & (separation < Float4(0.0f)), -separation, Float4(0.0f));
+                x = multiplyAdd(nx, push, x);
+                y = multiplyAdd(ny, push, y);
+                z = multiplyAdd(nz, push, z);
+            }
+
+            x.store(s.positionX.data() + i);
+            y.store(s.positionY.data() + i);
+            z.store(s.positionZ.data() + i);
+        }
+    });
+}
+
+void XpbdSolver::updateVelocities(const float h, const float damping)
+{
+    ParticleState& s = particles;
+    Parallel::parallelFor(s.inverseMass.size(), PARTICLE_GRAIN, [&](const std::size_t begin, const std::size_t end)
+    {
+        const Float4 scale(std::max(1.0f - damping * h, 0.0f) / h);
+        for (std::size_t i = begin; i < end; i += WIDTH)
+        {
+            ((Float4::load(s.positionX.data() + i) - Float4::load(s.previousX.data() + i)) * scale).store(s.velocityX.data() + i);
+            ((Float4::load(s.positionY.data() + i) - Float4::load(s.previousY.data() + i)) * scale).store(s.velocityY.data() + i);
+            ((Float4::load(s.positionZ.data() + i) - Float4::load(s.previousZ.data() + i)) * scale).store(s.velocityZ.data() + i);
+        }
+    });
+}
+
+void Kronos::CoreSystems::Physics::simulateBatch(const SimulationJob* jobs, const std::size_t n, const XpbdParams& params)
+{
+    Parallel::parallelFor(n, 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) { jobs[i].solver->step(jobs[i].dt, params, jobs[i].colliders); }
+    });
+}
@@ -0,0 +1,71 @@
+#include <cmath>
+#include <vector>
+
+#include "animation.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Animation;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // translation x(t) = t^2 keyed every 0.1 s, linear in between
+    float keyedSquare(const float t)
+    {
+        const float clamped = std::fmin(std::fmax(t, 0.0f), 2.0f);
+        const float a = std::floor(clamped * 10.0f) / 10.0f, b = std::fmin(a + 0.1f, 2.0f);
+        return b > a ? a * a + (clamped - a) / (b - a) * (b * b - a * a) : a * a;
+    }
+}
+
+int main()
+{
+    std::vector<JointTrack> tracks(5);
+    for (int k = 0; k <= 20; ++k)
+    {
+        const float t = static_cast<float>(k) * 0.1f;
+        tracks[0].translation.push_back({t, Vector3(t * t, 1.0f, 0.0f)});
+    }
+    // a quarter turn about z over one second
+    tracks[1].rotation.push_back({0.0f, Quaternion(0.0f, 0.0f, 0.0f, 1.0f)});
+    tracks[1].rotation.push_back({1.0f, Quaternion(0.0f, 0.0f, 0.70710678f, 0.70710678f)});
+    tracks[2].scale.push_back({0.5f, Vector3(2.0f, 2.0f, 2.0f)});
+    tracks[4].translation.push_back({0.0f, Vector3(3.0f, 0.0f, 0.0f)});
+
+    const AnimationClip clip(tracks);
+    KRONOS_CHECK(clip.jointCount() == 5);
+    KRONOS_CHECK_NEAR(clip.duration(), 2.0f, 1e-6f);
+
+    // the cursor gives the same answers forwards, backwards and after jumps
+    SamplingCursor cursor;
+    PoseStreams pose;
+    const float times[] = {0.0f, 0.05f, 0.37f, 0.99f, 1.55f, 2.0f, 3.0f, 1.2f, 0.21f, -1.0f, 1.85f};
+    for (const float t : times)
+    {
+        clip.sample(t, cursor, pose);
+        KRONOS_CHECK_NEAR(pose.translationX[0], keyedSquare(t), 1e-4f);
+        KRONOS_CHECK_NEAR(pose.translationY[0], 1.0f, 1e-6f);
+    }
+
+    // rotations are normalized lerps along the short arc; halfway is exactly the bisecting rotation
+    clip.sample(0.5f, cursor, pose);
+    KRONOS_CHECK_NEAR(pose.rotationZ[1], std::sin(3.14159265f / 8.0f), 2e-3f);
+    KRONOS_CHECK_NEAR(pose.rotationW[1], std::cos(3.14159265f / 8.0f), 2e-3f);
+
+    // single keys hold, and empty channels give the identity transform
+    KRONOS_CHECK_NEAR(pose.scaleX[2], 2.0f, 1e-6f);
+    KRONOS_CHECK_NEAR(pose.translationX[4], 3.0f, 1e-6f);
+    KRONOS_CHECK(pose.translationX[3] == 0.0f && pose.scaleY[3] == 1.0f);
+    KRONOS_CHECK_NEAR(pose.rotationW[3], 1.0f, 2e-3f);
+
+    // batched jobs sample their own cursor and pose
+    SamplingCursor cursors[8];
+    PoseStreams poses[8];
+    SampleJob jobs[8];
+    for (int i = 0; i < 8; ++i) { jobs[i] = {&clip, 0.25f * static_cast<float>(i), &cursors[i], &poses[i]}; }
+    sampleBatch(jobs, 8);
+    for (int i = 0; i < 8; ++i) { KRONOS_CHECK_NEAR(poses[i].translationX[0], keyedSquare(0.25f * static_cast<float>(i)), 1e-4f); }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "broadphase.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Collision;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    using PairSet = std::set<std::pair<std::uint32_t, std::uint32_t>>;
+
+    PairSet brutePairs(const std::vector<AABB>& boxes, const std::vector<bool>& alive)
+    {
+        PairSet pairs;
+        for (std::uint32_t i = 0; i < boxes.size(); ++i)
+            for (std::uint32_t j = i + 1; j < boxes.size(); ++j)
+                if (alive[i] && alive[j] && boxes[i].overlaps(boxes[j])) { pairs.insert({i, j}); }
+        return pairs;
+    }
+
+    PairSet currentPairs(const SweepAndPrune& sap)
+    {
+        PairSet pairs;
+        for (const std::uint64_t key : sap.pairs()) { const OverlapPair p = SweepAndPrune::decodePair(key); pairs.insert({p.a, p.b}); }
+        return pairs;
+    }
+
+    AABB cube(const Vector3& center, const float half) { return {center - Vector3(half, half, half), center + Vector3(half, half, half)}; }
+}
+
+int main()
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coordinate(-30.0f, 30.0f), step(-0.5f, 0.5f), half(0.5f, 2.0f);
+
+    SweepAndPrune sap;
+    std::vector<AABB> boxes;
+    std::vector<bool> alive;
+    for (int i = 0; i < 1000; ++i)
+    {
+        boxes.push_back(cube(Vector3(coordinate(rng), coordinate(rng), coordinate(rng)), half(rng)));
+        alive.push_back(true);
+        KRONOS_CHECK(sap.add(boxes.back()) == static_cast<std::uint32_t>(i));
+    }
+
+    // the added and removed events replay the change in the pair set every frame
+    PairSet tracked;
+    std::vector<OverlapPair> added, removed;
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        for (std::uint32_t i = 0; i < boxes.size(); ++i)
+        {
+            if (!alive[i]) { continue; }
+            const Vector3 d(step(rng), step(rng), step(rng));
+            boxes[i] = {boxes[i].min + d, boxes[i].max + d};
+            sap.move(i, boxes[i]);
+        }
+        if (frame == 5) { for (std::uint32_t i = 0; i < boxes.size(); i += 3) { sap.remove(i); alive[i] = false; } }
+
+        sap.update(added, removed);
+        for (const OverlapPair& p : removed) { KRONOS_CHECK(tracked.erase({std::min(p.a, p.b), std::max(p.a, p.b)}) == 1); }
+        for (const OverlapPair& p : added) { KRONOS_CHECK(tracked.insert({std::min(p.a, p.b), std::max(p.a, p.b)}).second); }
+        const PairSet expected = brutePairs(boxes, alive);
+        KRONOS_CHECK(currentPairs(sap) == expected);
+        KRONOS_CHECK(tracked == expected);
+    }
+
+    // the automatic axis follows the spread of the live proxies only
+    SweepAndPrune axes;
+    std::vector<std::uint32_t> spreadX;
+    for (int i = 0; i < 100; ++i) { spreadX.push_back(axes.add(cube(Vector3(static_cast<float>(i) * 10.0f, 0.0f, 0.0f), 0.5f))); }
+    for (int i = 0; i < 100; ++i) { axes.add(cube(Vector3(0.0f, 0.0f, static_cast<float>(i) * 0.1f), 0.5f)); }
+    axes.update(added, removed);
+    KRONOS_CHECK(axes.sweepAxis() == 0);
+    for (const std::uint32_t proxy : spreadX) { axes.remove(proxy); }
+    axes.update(added, removed);
+    KRONOS_CHECK(axes.sweepAxis() == 2);
+
+    // freed ids are recycled once their removals were reported
+    const std::uint32_t reused = axes.add(cube(Vector3::ZERO, 1.0f));
+    KRONOS_CHECK(reused < 100);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
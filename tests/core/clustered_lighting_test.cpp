@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "clustered_lighting.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // 16:9 perspective with a 90 degree vertical field of view
+    Matrix4x4 perspective(const float near, const float far)
+    {
+        return {9.0f / 16.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, 1.0f, 0.0f, 0.0f,
+                0.0f, 0.0f, -(far + near) / (far - near), -2.0f * far * near / (far - near),
+                0.0f, 0.0f, -1.0f, 0.0f};
+    }
+
+    float squaredDistance(const AABB& box, const Vector3& p)
+    {
+        const float dx = std::fmax(std::fmax(box.min.x - p.x, p.x - box.max.x), 0.0f);
+        const float dy = std::fmax(std::fmax(box.min.y - p.y, p.y - box.max.y), 0.0f);
+        const float dz = std::fmax(std::fmax(box.min.z - p.z, p.z - box.max.z), 0.0f);
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    bool lists(const ClusteredLightGrid& grid, const std::size_t cluster, const std::uint32_t light)
+    {
+        const ClusterLightRange& range = grid.lightRange(cluster);
+        const std::uint32_t* first = grid.lightIndices().data() + range.offset;
+        return std::binary_search(first, first + range.count, light);
+    }
+}
+
+int main()
+{
+    const Matrix4x4 projection = perspective(0.5f, 200.0f);
+    ClusteredLightGrid grid(projection);
+    KRONOS_CHECK(grid.clusterCount() == 16u * 9u * 24u);
+    KRONOS_CHECK_NEAR(grid.nearZ(), 0.5f, 1e-3f);
+    KRONOS_CHECK_NEAR(grid.farZ(), 200.0f, 0.1f);
+
+    // slices grow exponentially and cover the depth range in order
+    KRONOS_CHECK(grid.sliceOf(0.1f) == 0 && grid.sliceOf(1000.0f) == grid.slices() - 1);
+    std::uint32_t previous = 0;
+    for (float depth = 0.5f; depth < 200.0f; depth *= 1.1f)
+    {
+        const std::uint32_t slice = grid.sliceOf(depth);
+        KRONOS_CHECK(slice >= previous);
+        const AABB bounds = grid.clusterBounds(grid.clusterIndex(0, 0, slice));
+        KRONOS_CHECK(-bounds.max.z <= depth * 1.0001f && -bounds.min.z >= depth * 0.9999f);
+        previous = slice;
+    }
+
+    const LightBounds point = boundPointLight(Vector3(1.0f, 2.0f, -3.0f), 4.0f);
+    KRONOS_CHECK(point.radius == 4.0f && point.centre.z == -3.0f);
+    // both cone shapes enclose the apex and the rim of the cap
+    for (const float angle : {0.3f, 1.2f})
+    {
+        const LightBounds spot = boundSpotLight(Vector3::ZERO, Vector3(0.0f, 0.0f, -2.0f), 10.0f, angle);
+        const Vector3 rim(10.0f * std::sin(angle), 0.0f, -10.0f * std::cos(angle));
+        KRONOS_CHECK(spot.centre.magnitude() <= spot.radius + 1e-4f);
+        KRONOS_CHECK((rim - spot.centre).magnitude() <= spot.radius + 1e-4f);
+    }
+
+    // lights scattered through the frustum, with the identity view
+    std::vector<LightBounds> lights;
+    for (int i = 0; i < 200; ++i)
+    {
+        const float t = static_cast<float>(i);
+        const float depth = 1.0f + std::fmod(t * 7.31f, 150.0f);
+        lights.push_back(boundPointLight(Vector3(std::sin(t) * depth, std::cos(t * 1.7f) * depth * 0.8f, -depth), 0.5f + std::fmod(t * 0.37f, 6.0f)));
+    }
+    grid.assign(lights.data(), lights.size(), Matrix4x4::IDENTITY);
+
+    std::size_t total = 0;
+    for (std::size_t cluster = 0; cluster < grid.clusterCount(); ++cluster)
+    {
+        const ClusterLightRange& range = grid.lightRange(cluster);
+        const std::uint32_t* first = grid.lightIndices().data() + range.offset;
+        KRONOS_CHECK(std::is_sorted(first, first + range.count));
+        total += range.count;
+
+        // boxes over-cover their froxels, so listing implies the sphere reaches the box but not the reverse
+        const AABB bounds = grid.clusterBounds(cluster);
+        for (std::uint32_t k = 0; k < range.count; ++k)
+        {
+            const LightBounds& light = lights[first[k]];
+            KRONOS_CHECK(squaredDistance(bounds, light.centre) <= light.radius * light.radius * 1.001f);
+        }
+    }
+    KRONOS_CHECK(total == grid.lightIndices().size() && total > lights.size());
+
+    // every froxel holding a point of a light's sphere lists it
+    for (std::uint32_t light = 0; light < lights.size(); ++light)
+    {
+        for (const Vector3& direction : {Vector3::ZERO, Vector3(0.9f, 0.0f, 0.0f), Vector3(0.0f, -0.9f, 0.0f), Vector3(0.0f, 0.0f, 0.9f)})
+        {
+            const Vector3 p = lights[light].centre + direction * lights[light].radius;
+            const float depth = -p.z;
+            const float ndcX = projection.m00 * p.x / depth, ndcY = projection.m11 * p.y / depth;
+            if (depth < grid.nearZ() || depth > grid.farZ() || std::fabs(ndcX) >= 1.0f || std::fabs(ndcY) >= 1.0f) { continue; }
+            const auto tileX = static_cast<std::uint32_t>((ndcX + 1.0f) * 0.5f * static_cast<float>(grid.tilesX()));
+            const auto tileY = static_cast<std::uint32_t>((1.0f - ndcY) * 0.5f * static_cast<float>(grid.tilesY()));
+            KRONOS_CHECK(lists(grid, grid.clusterIndex(tileX, tileY, grid.sliceOf(depth)), light));
+        }
+    }
+
+    // moving the camera moves the lights the other way in view space
+    Matrix4x4 view = Matrix4x4::IDENTITY;
+    view.m03 = -1000.0f;
+    grid.assign(lights.data(), lights.size(), view);
+    KRONOS_CHECK(grid.lightIndices().empty());
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
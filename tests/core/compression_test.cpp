@@ -0,0 +1,78 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "compression.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Compression;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // from the relative rotation, as acos loses all precision near zero
+    float angleBetween(const Quaternion& a, const Quaternion& b)
+    {
+        const Quaternion d = a * b.conjugate();
+        return 2.0f * std::atan2(std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z), std::fabs(d.w));
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(4);
+    std::normal_distribution<float> gaussian;
+    std::vector<Quaternion> rotations(4099);
+    for (Quaternion& q : rotations)
+    {
+        q = Quaternion(gaussian(rng), gaussian(rng), gaussian(rng), gaussian(rng));
+        q.normalize();
+    }
+    rotations[0] = Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+    rotations[1] = Quaternion(0.0f, 0.0f, 0.0f, -1.0f);
+
+    // single and batched round trips stay inside the quantization bound
+    std::vector<PackedQuaternion48> packed48(rotations.size());
+    std::vector<PackedQuaternion32> packed32(rotations.size());
+    packQuaternions(rotations.data(), rotations.size(), packed48.data());
+    packQuaternions(rotations.data(), rotations.size(), packed32.data());
+    std::vector<float> x(rotations.size()), y(rotations.size()), z(rotations.size()), w(rotations.size());
+    unpackQuaternions(packed48.data(), rotations.size(), x.data(), y.data(), z.data(), w.data());
+    for (std::size_t i = 0; i < rotations.size(); ++i)
+    {
+        const Quaternion single = unpackQuaternion(packQuaternion48(rotations[i]));
+        KRONOS_CHECK(angleBetween(single, rotations[i]) <= rotationErrorBound48() + 1e-4f);
+        KRONOS_CHECK(angleBetween(unpackQuaternion(packQuaternion32(rotations[i])), rotations[i]) <= rotationErrorBound32() + 1e-4f);
+        KRONOS_CHECK_NEAR(x[i], single.x, 1e-5f);
+        KRONOS_CHECK_NEAR(w[i], single.w, 1e-5f);
+    }
+    const ErrorStats error48 = measureError(rotations.data(), rotations.size(), packed48.data());
+    const ErrorStats error32 = measureError(rotations.data(), rotations.size(), packed32.data());
+    KRONOS_CHECK(error48.maximum <= rotationErrorBound48() + 1e-4f && error48.mean <= error48.maximum);
+    KRONOS_CHECK(error32.maximum <= rotationErrorBound32() + 1e-4f && error48.maximum < error32.maximum);
+
+    // vectors are quantized over the range, values outside it are clamped
+    const AABB range(Vector3(-10.0f, 0.0f, -1.0f), Vector3(10.0f, 5.0f, 1.0f));
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Vector3> vectors(1027);
+    for (Vector3& v : vectors) { v = range.min + Vector3(20.0f * unit(rng), 5.0f * unit(rng), 2.0f * unit(rng)); }
+    std::vector<PackedVector3> packedVectors(vectors.size());
+    packVectors(vectors.data(), vectors.size(), range, packedVectors.data());
+    const Vector3 bound = vectorErrorBound(range);
+    std::vector<float> vx(vectors.size()), vy(vectors.size()), vz(vectors.size());
+    unpackVectors(packedVectors.data(), vectors.size(), range, vx.data(), vy.data(), vz.data());
+    for (std::size_t i = 0; i < vectors.size(); ++i)
+    {
+        KRONOS_CHECK(std::fabs(vx[i] - vectors[i].x) <= bound.x + 1e-5f);
+        KRONOS_CHECK(std::fabs(vy[i] - vectors[i].y) <= bound.y + 1e-5f);
+        KRONOS_CHECK(std::fabs(vz[i] - vectors[i].z) <= bound.z + 1e-5f);
+    }
+    KRONOS_CHECK(measureError(vectors.data(), vectors.size(), packedVectors.data(), range).maximum <= bound.magnitude() + 1e-5f);
+    const Vector3 clamped = unpackVector3(packVector3(Vector3(50.0f, -3.0f, 0.0f), range), range);
+    KRONOS_CHECK_NEAR(clamped.x, 10.0f, 1e-5f);
+    KRONOS_CHECK_NEAR(clamped.y, 0.0f, 1e-5f);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "dense_solver.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::LinearAlgebra;
+
+namespace
+{
+    // symmetric positive definite: B B^T plus a diagonal shift
+    template <int N>
+    MatrixN<N> spd(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> entry(-1.0f, 1.0f);
+        MatrixN<N> b, a;
+        for (int r = 0; r < N; ++r) { for (int c = 0; c < N; ++c) { b(r, c) = entry(rng); } }
+        for (int r = 0; r < N; ++r)
+        {
+            for (int c = 0; c < N; ++c)
+            {
+                for (int k = 0; k < N; ++k) { a(r, c) += b(r, k) * b(c, k); }
+            }
+            a(r, r) += static_cast<float>(N);
+        }
+        return a;
+    }
+
+    template <int N>
+    float residual(const MatrixN<N>& a, const VectorN<N>& x, const VectorN<N>& b)
+    {
+        float worst = 0.0f;
+        for (int r = 0; r < N; ++r)
+        {
+            float s = -b[r];
+            for (int c = 0; c < N; ++c) { s += a(r, c) * x[c]; }
+            worst = std::fmax(worst, std::fabs(s));
+        }
+        return worst;
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> entry(-1.0f, 1.0f);
+
+    // every factorization solves an SPD system, and the batch matches
+    constexpr int N = 6;
+    std::vector<MatrixN<N>> systems;
+    std::vector<VectorN<N>> rhs(37), solutions(37);
+    for (int i = 0; i < 37; ++i)
+    {
+        systems.push_back(spd<N>(rng));
+        for (int r = 0; r < N; ++r) { rhs[i][r] = entry(rng); }
+    }
+    for (const Factorization kind : {Factorization::LU, Factorization::Cholesky, Factorization::LDLT})
+    {
+        bool solved[37];
+        solveBatch(kind, systems.data(), rhs.data(), systems.size(), solutions.data(), solved);
+        for (std::size_t i = 0; i < systems.size(); ++i)
+        {
+            VectorN<N> x = rhs[i];
+            KRONOS_CHECK(solve(kind, systems[i], x));
+            KRONOS_CHECK(residual(systems[i], x, rhs[i]) < 1e-4f);
+            KRONOS_CHECK(solved[i]);
+            KRONOS_CHECK(residual(systems[i], solutions[i], rhs[i]) < 1e-4f);
+        }
+    }
+
+    // LU pivots through a zero leading entry, Cholesky rejects indefinite matrices, singular LU fails
+    MatrixN<2> swap;
+    swap(0, 1) = 1.0f;
+    swap(1, 0) = 1.0f;
+    VectorN<2> b;
+    b[0] = 3.0f;
+    b[1] = 4.0f;
+    KRONOS_CHECK(solve(Factorization::LU, swap, b));
+    KRONOS_CHECK(b[0] == 4.0f && b[1] == 3.0f);
+    VectorN<2> c = b;
+    KRONOS_CHECK(!solve(Factorization::Cholesky, swap, c));
+    KRONOS_CHECK(solve(Factorization::LDLT, MatrixN<2>::identity(), c));
+    KRONOS_CHECK(!solve(Factorization::LU, MatrixN<2>(), c));
+
+    // the dynamic front end and Gauss-Seidel on a diagonally dominant system
+    DenseMatrix a(20);
+    std::vector<float> x(20), y(20, 0.0f);
+    for (int r = 0; r < 20; ++r)
+    {
+        for (int col = 0; col < 20; ++col) { a(r, col) = r == col ? 25.0f : entry(rng); }
+        x[r] = entry(rng);
+    }
+    const std::vector<float> rhsDynamic = x;
+    KRONOS_CHECK(solve(Factorization::LU, a, x.data()));
+    KRONOS_CHECK(gaussSeidel(a, rhsDynamic.data(), y.data(), 100, 1e-7f) < 100);
+    for (int r = 0; r < 20; ++r)
+    {
+        float s = -rhsDynamic[r];
+        for (int col = 0; col < 20; ++col) { s += a(r, col) * x[col]; }
+        KRONOS_CHECK(std::fabs(s) < 1e-4f);
+        KRONOS_CHECK_NEAR(y[r], x[r], 1e-5f);
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#include <random>
+#include <vector>
+
+#include "depth_sort.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+
+int main()
+{
+    // sortable keys keep the float order, negative values and zeros included
+    const float values[] = {-1e30f, -3.5f, -1.0f, -0.0f, 0.0f, 1e-30f, 2.0f, 1e30f};
+    for (int i = 0; i < 8; ++i)
+    {
+        KRONOS_CHECK(sortableToFloat(floatToSortable(values[i])) == values[i]);
+        if (i > 0) { KRONOS_CHECK(floatToSortable(values[i - 1]) <= floatToSortable(values[i])); }
+    }
+
+    // view depth is the third row: a camera at z = 10 looking down -z, so depth = z - 10
+    const Matrix4x4 view(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, -10.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+    std::vector<Vector3> centers(5003);
+    std::vector<float> x, y, z;
+    for (Vector3& c : centers)
+    {
+        c = Vector3(coordinate(rng), coordinate(rng), coordinate(rng));
+        x.push_back(c.x);
+        y.push_back(c.y);
+        z.push_back(c.z);
+    }
+
+    DepthSorter sorter;
+    std::vector<std::uint32_t> ascending(centers.size()), descending(centers.size()), streams(centers.size());
+    sorter.sort(view, centers.data(), centers.size(), DepthOrder::Ascending, ascending.data());
+    sorter.sort(view, centers.data(), centers.size(), DepthOrder::Descending, descending.data());
+    sorter.sort(view, x.data(), y.data(), z.data(), centers.size(), DepthOrder::Ascending, streams.data());
+    for (std::size_t i = 1; i < centers.size(); ++i)
+    {
+        KRONOS_CHECK(centers[ascending[i - 1]].z <= centers[ascending[i]].z);
+        KRONOS_CHECK(centers[descending[i - 1]].z >= centers[descending[i]].z);
+    }
+    KRONOS_CHECK(streams == ascending);
+    KRONOS_CHECK_NEAR(sortableToFloat(sorter.sortedKeys().front()), centers[ascending.front()].z - 10.0f, 1e-4f);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
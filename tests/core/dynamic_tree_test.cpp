@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "dynamic_tree.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Spatial;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Geometry::Ray;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    AABB cube(const Vector3& center, const float half) { return {center - Vector3(half, half, half), center + Vector3(half, half, half)}; }
+}
+
+int main()
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f), step(-0.3f, 0.3f);
+
+    DynamicAABBTree tree;
+    std::vector<Vector3> centers;
+    std::vector<std::int32_t> proxies;
+    for (std::uint32_t i = 0; i < 2000; ++i)
+    {
+        centers.push_back(Vector3(coordinate(rng), coordinate(rng), coordinate(rng)));
+        proxies.push_back(tree.createProxy(cube(centers.back(), 1.0f), i));
+    }
+    KRONOS_CHECK(tree.proxyCount() == 2000);
+    KRONOS_CHECK(tree.height() < 32);
+    KRONOS_CHECK(tree.userData(proxies[42]) == 42);
+
+    // moves within the fat bounds are absorbed, larger ones reinsert
+    KRONOS_CHECK(!tree.moveProxy(proxies[0], cube(centers[0] + Vector3(0.05f, 0.0f, 0.0f), 1.0f)));
+    KRONOS_CHECK(tree.moveProxy(proxies[0], cube(centers[0] + Vector3(5.0f, 0.0f, 0.0f), 1.0f), Vector3(5.0f, 0.0f, 0.0f)));
+    centers[0] += Vector3(5.0f, 0.0f, 0.0f);
+    KRONOS_CHECK(tree.fatBounds(proxies[0]).max.x > tree.bounds(proxies[0]).max.x + 5.0f);
+
+    // refits keep the tree tight: it stays close to a freshly built one after many small moves
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        for (std::size_t i = 0; i < centers.size(); ++i)
+        {
+            centers[i] += Vector3(step(rng), step(rng), step(rng));
+            tree.refitProxy(proxies[i], cube(centers[i], 1.0f));
+        }
+    }
+    DynamicAABBTree fresh;
+    for (const Vector3& c : centers) { fresh.createProxy(cube(c, 1.0f)); }
+    KRONOS_CHECK(tree.areaRatio() < 1.5f * fresh.areaRatio());
+
+    // a refit that shrinks shrinks the fat bounds too
+    tree.refitProxy(proxies[1], cube(centers[1], 10.0f));
+    tree.refitProxy(proxies[1], cube(centers[1], 1.0f));
+    KRONOS_CHECK(tree.fatBounds(proxies[1]).max.x < centers[1].x + 2.0f);
+
+    // every overlapping proxy is found
+    std::vector<AABB> queries;
+    for (int q = 0; q < 100; ++q) { queries.push_back(cube(Vector3(coordinate(rng), coordinate(rng), coordinate(rng)), 4.0f)); }
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::int32_t> found;
+    tree.queryBatch(queries.data(), queries.size(), offsets, found);
+    for (std::size_t q = 0; q < queries.size(); ++q)
+    {
+        for (std::size_t i = 0; i < centers.size(); ++i)
+        {
+            if (!cube(centers[i], 1.0f).overlaps(queries[q])) { continue; }
+            KRONOS_CHECK(std::find(found.begin() + offsets[q], found.begin() + offsets[q + 1], proxies[i]) != found.begin() + offsets[q + 1]);
+        }
+    }
+
+    // batched rays hit the closest tight bounds, not the margin around them
+    DynamicAABBTree small(0.5f);
+    const std::int32_t near = small.createProxy(AABB(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 1.0f, 1.0f)));
+    small.createProxy(AABB(Vector3(3.0f, 0.0f, 0.0f), Vector3(4.0f, 1.0f, 1.0f)));
+    const Ray rays[3] = {Ray(Vector3(-5.0f, 0.5f, 0.5f), Vector3(1.0f, 0.0f, 0.0f), 100.0f),
+                         Ray(Vector3(-5.0f, 1.2f, 0.5f), Vector3(1.0f, 0.0f, 0.0f), 100.0f),
+                         Ray(Vector3(-5.0f, 0.5f, 0.5f), Vector3(-1.0f, 0.0f, 0.0f), 100.0f)};
+    std::int32_t hits[3];
+    float distances[3];
+    small.raycastBatch(rays, 3, hits, distances);
+    KRONOS_CHECK(hits[0] == near);
+    KRONOS_CHECK_NEAR(distances[0], 5.0f, 1e-4f);
+    KRONOS_CHECK(hits[1] == DynamicAABBTree::NULL_NODE);
+    KRONOS_CHECK(hits[2] == DynamicAABBTree::NULL_NODE && distances[2] == std::numeric_limits<float>::infinity());
+
+    for (const std::int32_t proxy : proxies) { tree.destroyProxy(proxy); }
+    KRONOS_CHECK(tree.proxyCount() == 0 && tree.height() == 0);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
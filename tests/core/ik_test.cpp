@@ -0,0 +1,109 @@
+#include <cmath>
+#include <vector>
+
+#include "ik.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Animation;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // straight chain along x with unit bones
+    struct Chain
+    {
+        std::vector<Vector3> positions;
+        std::vector<Quaternion> rotations;
+
+        explicit Chain(const std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                positions.emplace_back(static_cast<float>(i), 0.0f, 0.0f);
+                rotations.emplace_back(0.0f, 0.0f, 0.0f, 1.0f);
+            }
+            // a slight bend so the analytic solver has a plane to work in
+            if (count == 3)
+            {
+                positions[1] = Vector3(std::cos(0.1f), std::sin(0.1f), 0.0f);
+                positions[2] = Vector3(2.0f * std::cos(0.1f), 0.0f, 0.0f);
+            }
+        }
+
+        IkChain view() { return {positions.data(), rotations.data(), positions.size()}; }
+
+        bool bonesKept(const float length) const
+        {
+            for (std::size_t i = 1; i < positions.size(); ++i)
+            {
+                if (!Kronos::Tests::near((positions[i] - positions[i - 1]).magnitude(), length, 1e-3f)) { return false; }
+            }
+            return true;
+        }
+    };
+}
+
+int main()
+{
+    // reachable targets are met and bone lengths are kept
+    Chain twoBone(3);
+    const Vector3 target(1.0f, 1.2f, 0.3f);
+    KRONOS_CHECK(solveTwoBone(twoBone.view(), target) < 1e-3f);
+    KRONOS_CHECK((twoBone.positions[2] - target).magnitude() < 1e-3f);
+    KRONOS_CHECK(twoBone.bonesKept(1.0f));
+    KRONOS_CHECK(twoBone.positions[0].magnitude() < 1e-6f);
+
+    // the pole decides which side the middle joint bends to
+    Chain poled(3);
+    const Vector3 pole(1.0f, 0.0f, 5.0f);
+    solveTwoBone(poled.view(), Vector3(1.5f, 0.0f, 0.0f), &pole);
+    KRONOS_CHECK(poled.positions[1].z > 0.5f);
+
+    for (const IkMethod method : {IkMethod::Ccd, IkMethod::Fabrik})
+    {
+        Chain chain(5);
+        const Vector3 goal(1.0f, 2.0f, -1.0f);
+        const float error = method == IkMethod::Ccd ? solveCcd(chain.view(), goal) : solveFabrik(chain.view(), goal);
+        KRONOS_CHECK(error < 1e-2f);
+        KRONOS_CHECK_NEAR((chain.positions[4] - goal).magnitude(), error, 1e-4f);
+        KRONOS_CHECK(chain.bonesKept(1.0f));
+
+        // out of reach: the chain straightens towards the target
+        Chain far(5);
+        const Vector3 away(0.0f, 10.0f, 0.0f);
+        IkParams params;
+        params.maxIterations = 64;
+        const float gap = method == IkMethod::Ccd ? solveCcd(far.view(), away, params) : solveFabrik(far.view(), away, params);
+        KRONOS_CHECK_NEAR(gap, 6.0f, 1e-2f);
+        KRONOS_CHECK(far.bonesKept(1.0f));
+    }
+
+    // batched jobs give the same answers as solving one at a time
+    std::vector<Chain> single, batched;
+    std::vector<IkJob> jobs;
+    for (int i = 0; i < 9; ++i)
+    {
+        const std::size_t count = i % 3 == 0 ? 4 : 3;
+        single.emplace_back(count);
+        batched.emplace_back(count);
+    }
+    std::vector<float> expected, errors(batched.size());
+    for (std::size_t i = 0; i < batched.size(); ++i)
+    {
+        IkJob job;
+        job.chain = batched[i].view();
+        job.target = Vector3(0.5f + 0.1f * static_cast<float>(i), 1.0f, 0.2f);
+        job.method = i % 3 == 0 ? IkMethod::Fabrik : IkMethod::TwoBone;
+        jobs.push_back(job);
+        expected.push_back(job.method == IkMethod::Fabrik ? solveFabrik(single[i].view(), job.target) : solveTwoBone(single[i].view(), job.target));
+    }
+    solveBatch(jobs.data(), jobs.size(), {}, errors.data());
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+    {
+        KRONOS_CHECK_NEAR(errors[i], expected[i], 1e-4f);
+        KRONOS_CHECK((batched[i].positions.back() - single[i].positions.back()).magnitude() < 1e-4f);
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+#include <cmath>
+#include <vector>
+
+#include "large_world.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Math;
+
+int main()
+{
+    // positions a hundred million units out, converted in bulk as AoS and SoA; 1003 leaves a remainder
+    constexpr std::size_t COUNT = 1003;
+    const DVector3 origin(1.23456789e7, -9.87654321e7, 3.3e6);
+    std::vector<DVector3> positions;
+    std::vector<double> x, y, z;
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+        const double t = static_cast<double>(i);
+        positions.emplace_back(origin.x + std::sin(t) * 5000.0, origin.y + 0.25 * t, origin.z - std::cos(t * 0.3) * 200.0 + 0.001);
+        x.push_back(positions.back().x);
+        y.push_back(positions.back().y);
+        z.push_back(positions.back().z);
+    }
+
+    std::vector<Vector3> relative(COUNT);
+    std::vector<float> fx(COUNT), fy(COUNT), fz(COUNT);
+    toCameraRelative(positions.data(), COUNT, origin, relative.data());
+    toCameraRelative(x.data(), y.data(), z.data(), COUNT, origin, fx.data(), fy.data(), fz.data());
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+        // the subtraction happens in double, so the float result keeps sub-millimetre detail
+        const Vector3 single = toCameraRelative(positions[i], origin);
+        KRONOS_CHECK(single.x == relative[i].x && single.y == relative[i].y && single.z == relative[i].z);
+        KRONOS_CHECK(single.x == fx[i] && single.y == fy[i] && single.z == fz[i]);
+        KRONOS_CHECK(std::fabs(static_cast<double>(single.y) - (positions[i].y - origin.y)) < 1e-4);
+    }
+
+    // rebasing adds the offset exactly for power of two shifts
+    const Vector3 shift(1024.0f, -2048.0f, 4096.0f);
+    std::vector<Vector3> moved = relative;
+    rebase(moved.data(), COUNT, shift);
+    rebase(fx.data(), fy.data(), fz.data(), COUNT, shift);
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+        KRONOS_CHECK(moved[i].x == relative[i].x + shift.x && moved[i].y == relative[i].y + shift.y && moved[i].z == relative[i].z + shift.z);
+        KRONOS_CHECK(fx[i] == moved[i].x && fy[i] == moved[i].y && fz[i] == moved[i].z);
+    }
+
+    // transforms keep their small rotation part and have the origin taken out of the translation
+    DMatrix4x4 transform = DMatrix4x4::IDENTITY;
+    transform.m01 = 0.5;
+    transform.m03 = 1e9 + 1.5;
+    transform.m13 = -3e8 - 0.25;
+    const Matrix4x4 local = toCameraRelative(transform, DVector3(1e9, -3e8, 0.0));
+    KRONOS_CHECK(local.m03 == 1.5f && local.m13 == -0.25f && local.m01 == 0.5f);
+    Matrix4x4 locals[3];
+    const DMatrix4x4 transforms[3] = {transform, transform * DMatrix4x4::IDENTITY, transform};
+    toCameraRelative(transforms, 3, DVector3(1e9, -3e8, 0.0), locals);
+    KRONOS_CHECK(locals[1].m03 == 1.5f && locals[2].m13 == -0.25f);
+    rebase(locals, 3, Vector3(-1.0f, 1.0f, 2.0f));
+    KRONOS_CHECK(locals[0].m03 == 0.5f && locals[0].m13 == 0.75f && locals[0].m23 == 2.0f);
+
+    // the floating origin snaps to the grid once the camera strays past the threshold
+    FloatingOrigin floating(4096.0, 1024.0);
+    Vector3 offset;
+    KRONOS_CHECK(!floating.update(DVector3(4000.0, 0.0, 0.0), offset));
+    const DVector3 camera(1e9 + 5000.3, 7.0, -12345.6);
+    KRONOS_CHECK(floating.update(camera, offset));
+    KRONOS_CHECK(floating.origin().x == std::round((1e9 + 5000.3) / 1024.0) * 1024.0 && floating.origin().z == -12288.0);
+    // positions stored against the old origin and rebased agree with converting against the new one
+    const DVector3 point(1e9 + 5010.0, 8.0, -12340.0);
+    Vector3 rebased = toCameraRelative(point, DVector3::ZERO);
+    rebased += offset;
+    const Vector3 direct = toCameraRelative(point, floating.origin());
+    KRONOS_CHECK_NEAR(direct.x, static_cast<float>(point.x - floating.origin().x), 1e-3f);
+    KRONOS_CHECK(std::fabs(rebased.y - direct.y) < 1e-3f);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include <vector>
+
+#include "lod_selection.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // 90 degree vertical field of view
+    const Matrix4x4 PERSPECTIVE(1.0f, 0.0f, 0.0f, 0.0f,
+                                0.0f, 1.0f, 0.0f, 0.0f,
+                                0.0f, 0.0f, -1.0f, -0.2f,
+                                0.0f, 0.0f, -1.0f, 0.0f);
+
+    // unit spheres along -z, so an object's projected size is 1 / distance
+    struct Objects
+    {
+        std::vector<float> x, y, z, radius;
+
+        explicit Objects(const std::vector<float>& distances) : x(distances.size()), y(distances.size()), radius(distances.size(), 1.0f)
+        {
+            for (const float d : distances) { z.push_back(-d); }
+        }
+
+        void select(LodSelector& selector, const LodThresholds& thresholds) const
+        {
+            selector.select(x.data(), y.data(), z.data(), radius.data(), x.size(), Vector3::ZERO, PERSPECTIVE, thresholds);
+        }
+    };
+}
+
+int main()
+{
+    LodThresholds thresholds;
+    thresholds.lodCount = 3;
+    thresholds.screenSize[0] = 0.5f;
+    thresholds.screenSize[1] = 0.2f;
+    thresholds.screenSize[2] = 0.05f;
+
+    // nine objects cover whole SIMD groups and a remainder
+    const Objects objects({1.0f, 3.0f, 10.0f, 100.0f, 1.5f, 4.0f, 19.0f, 25.0f, 2.5f});
+    const std::vector<std::int32_t> expected = {0, 1, 2, 3, 0, 1, 2, 3, 1};
+    LodSelector selector;
+    objects.select(selector, thresholds);
+    KRONOS_CHECK(selector.lods() == expected);
+
+    // buckets hold each LOD's objects in ascending order, with the culled ones last
+    std::size_t bucketed = 0;
+    for (std::uint32_t lod = 0; lod <= thresholds.lodCount; ++lod)
+    {
+        const std::uint32_t* bucket = selector.bucket(lod);
+        for (std::size_t k = 0; k < selector.bucketSize(lod); ++k)
+        {
+            KRONOS_CHECK(expected[bucket[k]] == static_cast<std::int32_t>(lod));
+            KRONOS_CHECK(k == 0 || bucket[k - 1] < bucket[k]);
+        }
+        bucketed += selector.bucketSize(lod);
+    }
+    KRONOS_CHECK(bucketed == expected.size());
+
+    // hysteresis: sizes just past a threshold keep the last LOD, sizes beyond the band switch
+    const auto lodAt = [&](const float size)
+    {
+        Objects one({1.0f / size});
+        one.select(selector, thresholds);
+        return selector.lods()[0];
+    };
+    selector.resetHistory();
+    KRONOS_CHECK(lodAt(0.25f) == 1);
+    KRONOS_CHECK(lodAt(0.19f) == 1);
+    KRONOS_CHECK(lodAt(0.17f) == 2);
+    KRONOS_CHECK(lodAt(0.21f) == 2);
+    KRONOS_CHECK(lodAt(0.23f) == 1);
+    selector.resetHistory();
+    KRONOS_CHECK(lodAt(0.19f) == 2);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
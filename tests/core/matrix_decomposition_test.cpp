@@ -0,0 +1,72 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "matrix_decomposition.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Math;
+
+namespace
+{
+    Matrix3x3 transposed(const Matrix3x3& a) { return {a.m00, a.m10, a.m20, a.m01, a.m11, a.m21, a.m02, a.m12, a.m22}; }
+    Matrix3x3 diagonal(const Vector3& d) { return {d.x, 0.0f, 0.0f, 0.0f, d.y, 0.0f, 0.0f, 0.0f, d.z}; }
+
+    float maxDifference(const Matrix3x3& a, const Matrix3x3& b)
+    {
+        const float* pa = &a.m00;
+        const float* pb = &b.m00;
+        float d = 0.0f;
+        for (int i = 0; i < 9; ++i) { d = std::fmax(d, std::fabs(pa[i] - pb[i])); }
+        return d;
+    }
+
+    bool isRotation(const Matrix3x3& r)
+    {
+        return maxDifference(r * transposed(r), Matrix3x3(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f)) < 1e-4f && std::fabs(r.determinant() - 1.0f) < 1e-4f;
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> entry(-2.0f, 2.0f);
+    std::vector<Matrix3x3> symmetric, general;
+    for (int i = 0; i < 1001; ++i)
+    {
+        Matrix3x3 a(entry(rng), entry(rng), entry(rng), entry(rng), entry(rng), entry(rng), entry(rng), entry(rng), entry(rng));
+        general.push_back(a);
+        symmetric.push_back(a * transposed(a) + Matrix3x3(0.0f, 0.5f, 0.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f));
+    }
+    // degenerate inputs: repeated eigenvalues, a reflection and a rank one matrix
+    symmetric.push_back(Matrix3x3(2.0f, 0.0f, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 2.0f));
+    general.push_back(Matrix3x3(-1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f));
+    general.push_back(Matrix3x3(1.0f, 2.0f, 3.0f, 2.0f, 4.0f, 6.0f, 3.0f, 6.0f, 9.0f));
+
+    // A = V diag(lambda) V^T with descending eigenvalues
+    std::vector<SymmetricEigen> eigen(symmetric.size());
+    eigenSymmetric(symmetric.data(), symmetric.size(), eigen.data());
+    for (std::size_t i = 0; i < symmetric.size(); ++i)
+    {
+        const SymmetricEigen& e = eigen[i];
+        KRONOS_CHECK(isRotation(e.vectors));
+        KRONOS_CHECK(e.values.x >= e.values.y && e.values.y >= e.values.z);
+        KRONOS_CHECK(maxDifference(e.vectors * diagonal(e.values) * transposed(e.vectors), symmetric[i]) < 1e-3f);
+        const SymmetricEigen single = eigenSymmetric(symmetric[i]);
+        KRONOS_CHECK((single.values - e.values).magnitude() < 1e-4f);
+    }
+
+    // A = U diag(sigma) V^T with rotations on both sides; only the smallest value carries a sign
+    std::vector<SingularValueDecomposition> decompositions(general.size());
+    svd(general.data(), general.size(), decompositions.data());
+    for (std::size_t i = 0; i < general.size(); ++i)
+    {
+        const SingularValueDecomposition& d = decompositions[i];
+        KRONOS_CHECK(isRotation(d.u) && isRotation(d.v));
+        KRONOS_CHECK(d.sigma.x >= d.sigma.y && d.sigma.y >= std::fabs(d.sigma.z));
+        KRONOS_CHECK(maxDifference(d.u * diagonal(d.sigma) * transposed(d.v), general[i]) < 1e-3f);
+        KRONOS_CHECK((d.sigma.z < 0.0f) == (general[i].determinant() < -1e-6f) || std::fabs(d.sigma.z) < 1e-4f);
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <vector>
+
+#include "morph_target.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Animation;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    constexpr std::size_t VERTICES = 100;
+
+    VertexStreams baseStreams(const std::size_t padded)
+    {
+        VertexStreams base;
+        base.resize(padded);
+        for (std::size_t i = 0; i < VERTICES; ++i)
+        {
+            base.positionX[i] = static_cast<float>(i);
+            base.positionY[i] = 1.0f;
+            base.positionZ[i] = -static_cast<float>(i);
+            base.normalZ[i] = 1.0f;
+        }
+        return base;
+    }
+}
+
+int main()
+{
+    MorphTargetDesc smile, blink;
+    for (const std::uint32_t index : {3u, 4u, 40u, 99u})
+    {
+        smile.indices.push_back(index);
+        smile.positionDeltas.emplace_back(0.5f, -0.25f * static_cast<float>(index % 4), 2.0f);
+        smile.normalDeltas.emplace_back(0.1f, 0.0f, -0.1f);
+    }
+    blink.indices = {4, 70};
+    blink.positionDeltas = {Vector3(0.0f, 1.0f, 0.0f), Vector3(-3.0f, 0.0f, 1.0f)};
+
+    for (const MorphDeltaFormat format : {MorphDeltaFormat::Float32, MorphDeltaFormat::Snorm16})
+    {
+        const MorphTargetSet set(VERTICES, {smile, blink}, format);
+        KRONOS_CHECK(set.vertexCount() == VERTICES && set.targetCount() == 2);
+        KRONOS_CHECK(set.paddedVertexCount() >= VERTICES);
+        // the 3 and 4 of the first target share a run, the rest are too far apart to merge
+        KRONOS_CHECK(set.runCount() >= 5);
+
+        const VertexStreams base = baseStreams(set.paddedVertexCount());
+        const float tolerance = format == MorphDeltaFormat::Float32 ? 1e-6f : 2e-4f;
+        const float weights[] = {0.5f, 2.0f};
+        VertexStreams out;
+        out.resize(set.paddedVertexCount());
+        set.apply(base, weights, out);
+
+        for (std::size_t i = 0; i < VERTICES; ++i)
+        {
+            Vector3 expected(base.positionX[i], base.positionY[i], base.positionZ[i]);
+            float normalX = 0.0f;
+            for (std::size_t k = 0; k < smile.indices.size(); ++k)
+            {
+                if (smile.indices[k] == i) { expected += smile.positionDeltas[k] * weights[0]; normalX += 0.05f; }
+            }
+            for (std::size_t k = 0; k < blink.indices.size(); ++k)
+            {
+                if (blink.indices[k] == i) { expected += blink.positionDeltas[k] * weights[1]; }
+            }
+            KRONOS_CHECK_NEAR(out.positionX[i], expected.x, tolerance * 8.0f);
+            KRONOS_CHECK_NEAR(out.positionY[i], expected.y, tolerance * 8.0f);
+            KRONOS_CHECK_NEAR(out.positionZ[i], expected.z, tolerance * 8.0f);
+            KRONOS_CHECK_NEAR(out.normalX[i], normalX, tolerance);
+        }
+
+        // weights under the threshold leave the base untouched, also when out aliases it
+        VertexStreams inPlace = base;
+        const float quiet[] = {1e-6f, 0.0f};
+        set.apply(inPlace, quiet, inPlace);
+        KRONOS_CHECK(inPlace.positionX == base.positionX && inPlace.positionY == base.positionY);
+        KRONOS_CHECK(inPlace.normalZ == base.normalZ);
+    }
+
+    // 16 bit deltas take less space than floats
+    const MorphTargetSet full(VERTICES, {smile, blink}, MorphDeltaFormat::Float32);
+    const MorphTargetSet packed(VERTICES, {smile, blink}, MorphDeltaFormat::Snorm16);
+    KRONOS_CHECK(packed.deltaBytes() < full.deltaBytes());
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <random>
+#include <vector>
+
+#include "morton.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Spatial;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    std::uint64_t referenceMorton(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z, const int bits)
+    {
+        std::uint64_t code = 0;
+        for (int b = 0; b < bits; ++b)
+        {
+            code |= static_cast<std::uint64_t>(x >> b & 1) << (3 * b);
+            code |= static_cast<std::uint64_t>(y >> b & 1) << (3 * b + 1);
+            code |= static_cast<std::uint64_t>(z >> b & 1) << (3 * b + 2);
+        }
+        return code;
+    }
+}
+
+int main()
+{
+    // interleaving matches a bit by bit reference and round trips
+    std::mt19937 rng(5);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const std::uint32_t x = rng() & 0x3FF, y = rng() & 0x3FF, z = rng() & 0x3FF;
+        const std::uint32_t code = morton30(x, y, z);
+        KRONOS_CHECK(code == referenceMorton(x, y, z, 10));
+        KRONOS_CHECK(compactBits3(code) == x && compactBits3(code >> 1) == y && compactBits3(code >> 2) == z);
+        const std::uint32_t wx = rng() & 0x1FFFFF, wy = rng() & 0x1FFFFF, wz = rng() & 0x1FFFFF;
+        KRONOS_CHECK(morton63(wx, wy, wz) == referenceMorton(wx, wy, wz, 21));
+    }
+
+    // the SIMD batch agrees with the scalar codes, including the tail
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    std::vector<Vector3> points(10007);
+    for (Vector3& p : points) { p = Vector3(coordinate(rng), coordinate(rng), coordinate(rng)); }
+    const AABB bounds = computeBounds(points.data(), points.size());
+    for (const Vector3& p : points) { KRONOS_CHECK(bounds.contains(p)); }
+
+    std::vector<std::uint32_t> codes30(points.size());
+    std::vector<std::uint64_t> codes63(points.size());
+    encodeMorton30(points.data(), points.size(), bounds, codes30.data());
+    encodeMorton63(points.data(), points.size(), bounds, codes63.data());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        KRONOS_CHECK(codes30[i] == morton30(points[i], bounds));
+        KRONOS_CHECK(codes63[i] == morton63(points[i], bounds));
+    }
+
+    // the corners of the bounds map to the ends of the curve, points outside are clamped
+    KRONOS_CHECK(morton30(bounds.min, bounds) == 0);
+    KRONOS_CHECK(morton30(bounds.max, bounds) == 0x3FFFFFFFu);
+    KRONOS_CHECK(morton30(bounds.max + Vector3(5.0f, 5.0f, 5.0f), bounds) == 0x3FFFFFFFu);
+
+    // sorting by code yields the permutation of ascending codes
+    std::vector<std::uint32_t> sortedCodes(points.size()), permutation(points.size());
+    sortByMorton(points.data(), points.size(), bounds, sortedCodes.data(), permutation.data());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        KRONOS_CHECK(sortedCodes[i] == codes30[permutation[i]]);
+        if (i > 0) { KRONOS_CHECK(sortedCodes[i - 1] <= sortedCodes[i]); }
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
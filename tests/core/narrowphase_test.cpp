@@ -0,0 +1,71 @@
+#include "narrowphase.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Collision;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+int main()
+{
+    const Quaternion identity(0.0f, 0.0f, 0.0f, 1.0f);
+
+    // separated spheres report the gap between their surfaces
+    const ConvexShape a = ConvexShape::sphere(Vector3::ZERO, 1.0f);
+    const ConvexShape b = ConvexShape::sphere(Vector3(3.0f, 0.0f, 0.0f), 0.5f);
+    const DistanceResult apart = distance(a, b);
+    KRONOS_CHECK(!apart.intersecting);
+    KRONOS_CHECK_NEAR(apart.distance, 1.5f, 1e-4f);
+    KRONOS_CHECK_NEAR(apart.pointA.x, 1.0f, 1e-4f);
+    KRONOS_CHECK_NEAR(apart.pointB.x, 2.5f, 1e-4f);
+    KRONOS_CHECK(!intersect(a, b));
+
+    // overlapping spheres resolve along the centre line
+    const ContactResult spheres = penetration(a, ConvexShape::sphere(Vector3(1.5f, 0.0f, 0.0f), 1.0f));
+    KRONOS_CHECK(spheres.colliding);
+    KRONOS_CHECK_NEAR(spheres.depth, 0.5f, 1e-4f);
+    KRONOS_CHECK_NEAR(spheres.normal.x, 1.0f, 1e-4f);
+
+    // boxes with overlapping cores go through EPA
+    const ConvexShape box = ConvexShape::box(Vector3::ZERO, identity, Vector3(1.0f, 1.0f, 1.0f));
+    const ContactResult boxes = penetration(box, ConvexShape::box(Vector3(1.8f, 0.3f, 0.0f), identity, Vector3(1.0f, 1.0f, 1.0f)));
+    KRONOS_CHECK(boxes.colliding);
+    KRONOS_CHECK_NEAR(boxes.depth, 0.2f, 1e-3f);
+    KRONOS_CHECK_NEAR(boxes.normal.x, 1.0f, 1e-3f);
+
+    // boxes closer than the contact tolerance touch with the GJK normal and a tiny negative depth
+    const ContactResult touching = penetration(box, ConvexShape::box(Vector3(2.000005f, 0.3f, 0.0f), identity, Vector3(1.0f, 1.0f, 1.0f)));
+    KRONOS_CHECK(touching.colliding);
+    KRONOS_CHECK(touching.depth <= 0.0f && touching.depth > -1e-5f);
+    KRONOS_CHECK_NEAR(touching.normal.x, 1.0f, 1e-3f);
+    KRONOS_CHECK(!penetration(box, ConvexShape::box(Vector3(2.1f, 0.0f, 0.0f), identity, Vector3(1.0f, 1.0f, 1.0f))).colliding);
+
+    // hulls: a unit cube given as vertices behaves like the box
+    const Vector3 corners[8] = {{-1, -1, -1}, {1, -1, -1}, {-1, 1, -1}, {1, 1, -1}, {-1, -1, 1}, {1, -1, 1}, {-1, 1, 1}, {1, 1, 1}};
+    const ConvexShape hull = ConvexShape::convexHull(Vector3(0.0f, 2.5f, 0.0f), identity, corners, 8);
+    KRONOS_CHECK_NEAR(distance(box, hull).distance, 0.5f, 1e-4f);
+
+    // capsule lying on a box
+    const ConvexShape capsule = ConvexShape::capsule(Vector3(0.0f, 1.4f, 0.0f), identity, 1.0f, 0.5f);
+    KRONOS_CHECK_NEAR(distance(box, capsule).distance, 0.0f, 1e-4f);
+    const ContactResult resting = penetration(box, ConvexShape::capsule(Vector3(0.0f, 1.4f, 0.0f), Quaternion(0.0f, 0.0f, 0.70710678f, 0.70710678f), 1.0f, 0.5f));
+    KRONOS_CHECK(resting.colliding);
+    KRONOS_CHECK_NEAR(resting.depth, 0.1f, 1e-3f);
+    KRONOS_CHECK_NEAR(resting.normal.y, 1.0f, 1e-3f);
+
+    // batches with warm-started caches agree with the single queries
+    ConvexShape as[16], bs[16];
+    SimplexCache caches[16];
+    DistanceResult distances[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        as[i] = box;
+        bs[i] = ConvexShape::sphere(Vector3(2.0f + 0.1f * static_cast<float>(i), 0.0f, 0.0f), 0.5f);
+    }
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        distanceBatch(as, bs, caches, distances, 16);
+        for (int i = 0; i < 16; ++i) { KRONOS_CHECK_NEAR(distances[i].distance, 0.5f + 0.1f * static_cast<float>(i), 1e-4f); }
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
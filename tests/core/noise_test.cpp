@@ -0,0 +1,119 @@
+#include <cmath>
+#include <vector>
+
+#include "noise.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Noise;
+using Kronos::CoreSystems::Math::Vector2;
+using Kronos::CoreSystems::Math::Vector3;
+using Kronos::CoreSystems::Math::Vector4;
+
+namespace
+{
+    constexpr int POINTS = 500;
+
+    // scattered points over a few hundred cells, away from the lattice
+    template <typename Vector>
+    Vector point(const int i)
+    {
+        Vector p;
+        for (std::size_t k = 0; k < sizeof(Vector) / sizeof(float); ++k)
+        {
+            (&p.x)[k] = 100.0f * std::sin(static_cast<float>(i) * 0.731f + static_cast<float>(k) * 1.93f) + 0.123f;
+        }
+        return p;
+    }
+
+    // value range, gradients against central differences, and batches against single points
+    template <typename Vector>
+    void checkType(const NoiseType type)
+    {
+        constexpr std::size_t DIMENSIONS = sizeof(Vector) / sizeof(float);
+        NoiseDesc desc;
+        desc.type = type;
+        desc.fractal = FractalType::None;
+
+        std::vector<Vector> points;
+        int rough = 0;
+        for (int i = 0; i < POINTS; ++i)
+        {
+            const Vector p = point<Vector>(i);
+            points.push_back(p);
+            Vector gradient;
+            const float value = sample(desc, p, gradient);
+            KRONOS_CHECK(value == sample(desc, p));
+            if (type == NoiseType::Worley) { KRONOS_CHECK(value >= 0.0f && value <= 1.5f); }
+            else { KRONOS_CHECK(value >= -1.05f && value <= 1.05f); }
+
+            for (std::size_t k = 0; k < DIMENSIONS; ++k)
+            {
+                constexpr float STEP = 1e-3f;
+                Vector ahead = p, behind = p;
+                (&ahead.x)[k] += STEP;
+                (&behind.x)[k] -= STEP;
+                const float difference = (sample(desc, ahead) - sample(desc, behind)) / (2.0f * STEP);
+                rough += std::fabs(difference - (&gradient.x)[k]) > 0.02f;
+            }
+        }
+        // Worley's gradient jumps where the nearest feature point changes
+        KRONOS_CHECK(rough <= (type == NoiseType::Worley ? POINTS / 50 : 0));
+
+        for (const FractalType fractal : {FractalType::None, FractalType::Fbm, FractalType::Ridged})
+        {
+            desc.fractal = fractal;
+            std::vector<float> values(POINTS);
+            std::vector<Vector> gradients(POINTS);
+            sample(desc, points.data(), points.size(), values.data(), gradients.data());
+            for (int i = 0; i < POINTS; ++i)
+            {
+                Vector gradient;
+                KRONOS_CHECK_NEAR(values[i], sample(desc, points[i], gradient), 1e-6f);
+                for (std::size_t k = 0; k < DIMENSIONS; ++k) { KRONOS_CHECK_NEAR((&gradients[i].x)[k], (&gradient.x)[k], 1e-4f); }
+                if (fractal == FractalType::Ridged) { KRONOS_CHECK(values[i] >= 0.0f && values[i] <= 1.0f); }
+            }
+        }
+    }
+}
+
+int main()
+{
+    for (const NoiseType type : {NoiseType::Perlin, NoiseType::Simplex, NoiseType::Worley})
+    {
+        checkType<Vector2>(type);
+        checkType<Vector3>(type);
+        checkType<Vector4>(type);
+    }
+
+    // Perlin noise vanishes on the lattice, and seeds give different fields
+    KRONOS_CHECK(perlin(Vector3(3.0f, -7.0f, 12.0f)) == 0.0f);
+    int same = 0;
+    for (int i = 0; i < POINTS; ++i) { same += simplex(point<Vector2>(i), 1) == simplex(point<Vector2>(i), 2); }
+    KRONOS_CHECK(same < POINTS / 10);
+
+    // grids match sampling their points one at a time
+    NoiseDesc desc;
+    desc.frequency = 0.01f;
+    constexpr std::uint32_t WIDTH = 37, HEIGHT = 11, DEPTH = 5;
+    std::vector<float> heights(WIDTH * HEIGHT), volume(WIDTH * HEIGHT * DEPTH);
+    std::vector<Vector2> slopes(WIDTH * HEIGHT);
+    fill(desc, Vector2(-1000.5f, 300.25f), Vector2(0.5f, 0.75f), WIDTH, HEIGHT, heights.data(), slopes.data());
+    fill(desc, Vector3(4.0f, 5.0f, 6.0f), Vector3(0.25f, 0.5f, 2.0f), WIDTH, HEIGHT, DEPTH, volume.data());
+    for (std::uint32_t y = 0; y < HEIGHT; ++y)
+    {
+        for (std::uint32_t x = 0; x < WIDTH; ++x)
+        {
+            Vector2 slope;
+            const float value = sample(desc, Vector2(-1000.5f + static_cast<float>(x) * 0.5f, 300.25f + static_cast<float>(y) * 0.75f), slope);
+            KRONOS_CHECK_NEAR(heights[y * WIDTH + x], value, 1e-6f);
+            KRONOS_CHECK_NEAR(slopes[y * WIDTH + x].y, slope.y, 1e-4f);
+            for (std::uint32_t z = 0; z < DEPTH; ++z)
+            {
+                const Vector3 p(4.0f + static_cast<float>(x) * 0.25f, 5.0f + static_cast<float>(y) * 0.5f, 6.0f + static_cast<float>(z) * 2.0f);
+                KRONOS_CHECK_NEAR(volume[(z * HEIGHT + y) * WIDTH + x], sample(desc, p), 1e-6f);
+            }
+        }
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
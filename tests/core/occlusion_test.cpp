@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <vector>
+
+#include "occlusion.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Rendering;
+using Kronos::CoreSystems::Geometry::AABB;
+using Kronos::CoreSystems::Math::Matrix4x4;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // camera at the origin looking down -z with a 90 degree field of view
+    Matrix4x4 perspective(const float near, const float far)
+    {
+        return {1.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, 1.0f, 0.0f, 0.0f,
+                0.0f, 0.0f, -(far + near) / (far - near), -2.0f * far * near / (far - near),
+                0.0f, 0.0f, -1.0f, 0.0f};
+    }
+
+    AABB box(const Vector3& min, const Vector3& max)
+    {
+        AABB b;
+        b.min = min;
+        b.max = max;
+        return b;
+    }
+}
+
+int main()
+{
+    const Matrix4x4 projection = perspective(0.1f, 100.0f);
+    // a wall at z = -10 covering [-5, 5] in x and y, counter-clockwise towards the camera
+    const Vector3 wall[4] = {{-5.0f, -5.0f, -10.0f}, {5.0f, -5.0f, -10.0f}, {5.0f, 5.0f, -10.0f}, {-5.0f, 5.0f, -10.0f}};
+    const std::uint32_t front[6] = {0, 1, 2, 0, 2, 3};
+    const std::uint32_t back[6] = {0, 2, 1, 0, 3, 2};
+
+    const AABB hidden = box({-1.0f, -1.0f, -30.0f}, {1.0f, 1.0f, -20.0f});
+    const AABB nearer = box({-1.0f, -1.0f, -8.0f}, {1.0f, 1.0f, -6.0f});
+    const AABB aside = box({20.0f, -1.0f, -30.0f}, {22.0f, 1.0f, -20.0f});
+    const AABB offScreen = box({-1.0f, -1.0f, 5.0f}, {1.0f, 1.0f, 8.0f});
+
+    MaskedOcclusionBuffer buffer(256, 128);
+    const OccluderMesh mesh {wall, front, 2};
+    buffer.renderOccluders(&mesh, 1, projection);
+    KRONOS_CHECK(!buffer.isVisible(hidden, projection));
+    KRONOS_CHECK(buffer.isVisible(nearer, projection));
+    KRONOS_CHECK(buffer.isVisible(aside, projection));
+    KRONOS_CHECK(!buffer.isVisible(offScreen, projection));
+    // wider than the wall on screen, or crossing the near plane
+    KRONOS_CHECK(buffer.isVisible(box({-1e5f, -1.0f, -30.0f}, {1e5f, 1.0f, -20.0f}), projection));
+    KRONOS_CHECK(buffer.isVisible(box({-1e5f, -1.0f, -5.0f}, {1e5f, 1.0f, -0.001f}), projection));
+    KRONOS_CHECK(buffer.isVisible(box({-1.0f, -1.0f, -20.0f}, {1.0f, 1.0f, 1.0f}), projection));
+
+    const AABB boxes[] = {hidden, nearer, aside, offScreen};
+    std::uint8_t visible[4];
+    buffer.testBoxes(boxes, 4, projection, visible);
+    for (int i = 0; i < 4; ++i) { KRONOS_CHECK(static_cast<bool>(visible[i]) == buffer.isVisible(boxes[i], projection)); }
+
+    // depth is 1/w, so the wall reads 0.1 and the rest of the screen stays clear
+    std::vector<float> depth(256 * 128);
+    buffer.resolveDepth(depth.data());
+    KRONOS_CHECK_NEAR(depth[64 * 256 + 128], 0.1f, 1e-3f);
+    KRONOS_CHECK(depth[0] == 0.0f);
+
+    // back faces are culled unless culling is off
+    MaskedOcclusionBuffer culled(256, 128);
+    const OccluderMesh reversed {wall, back, 2};
+    culled.renderOccluders(&reversed, 1, projection);
+    KRONOS_CHECK(culled.isVisible(hidden, projection));
+    culled.renderOccluders(&reversed, 1, projection, CullMode::None);
+    KRONOS_CHECK(!culled.isVisible(hidden, projection));
+    culled.clear();
+    KRONOS_CHECK(culled.isVisible(hidden, projection));
+
+    // a tessellated wall with more triangles than one batch occludes like the single quad
+    std::vector<Vector3> vertices;
+    std::vector<std::uint32_t> indices;
+    for (int k = 0; k < 3000; ++k)
+    {
+        const float x = -5.0f + static_cast<float>(k % 50) * 0.2f, y = -5.0f + static_cast<float>(k / 50) * 0.16f;
+        const auto first = static_cast<std::uint32_t>(vertices.size());
+        vertices.insert(vertices.end(), {{x, y, -10.0f}, {x + 0.2f, y, -10.0f}, {x + 0.2f, y + 0.17f, -10.0f}, {x, y + 0.17f, -10.0f}});
+        indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+    }
+    MaskedOcclusionBuffer tessellated(256, 128);
+    const OccluderMesh pieces {vertices.data(), indices.data(), indices.size() / 3};
+    tessellated.renderOccluders(&pieces, 1, projection);
+    KRONOS_CHECK(!tessellated.isVisible(hidden, projection));
+    KRONOS_CHECK(tessellated.isVisible(nearer, projection));
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "packed_formats.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Compression;
+using Kronos::CoreSystems::Math::Vector3;
+using Kronos::CoreSystems::Math::Vector4;
+
+int main()
+{
+    // exact halves, rounding, overflow to infinity, denormals and NaN
+    KRONOS_CHECK(floatToHalf(0.0f) == 0x0000 && floatToHalf(-0.0f) == 0x8000);
+    KRONOS_CHECK(floatToHalf(1.0f) == 0x3C00 && floatToHalf(-2.0f) == 0xC000);
+    KRONOS_CHECK(floatToHalf(65504.0f) == 0x7BFF);
+    KRONOS_CHECK(floatToHalf(1e6f) == 0x7C00 && floatToHalf(-std::numeric_limits<float>::infinity()) == 0xFC00);
+    KRONOS_CHECK(floatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00);
+    KRONOS_CHECK(halfToFloat(0x0001) == std::ldexp(1.0f, -24));
+    KRONOS_CHECK(std::isnan(halfToFloat(floatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+    // every finite half survives the round trip, and the batch matches the scalar path
+    std::vector<std::uint16_t> halves, batch;
+    std::vector<float> floats;
+    for (std::uint32_t h = 0; h < 0x10000; ++h)
+    {
+        if ((h & 0x7C00) == 0x7C00) { continue; }
+        halves.push_back(static_cast<std::uint16_t>(h));
+        floats.push_back(halfToFloat(static_cast<std::uint16_t>(h)));
+    }
+    std::vector<float> decoded(floats.size());
+    decodeHalves(halves.data(), halves.size(), decoded.data());
+    batch.resize(floats.size());
+    encodeHalves(floats.data(), floats.size(), batch.data());
+    KRONOS_CHECK(batch == halves);
+    KRONOS_CHECK(std::memcmp(decoded.data(), floats.data(), floats.size() * sizeof(float)) == 0);
+
+    const Vector4 v(1.5f, -0.25f, 1000.0f, 3.0f);
+    const Vector4 v4 = toVector4(toHalf4(v));
+    KRONOS_CHECK(v4.x == v.x && v4.y == v.y && v4.z == v.z && v4.w == v.w);
+
+    // unit normals through the octahedral and 10:10:10:2 encodings
+    std::mt19937 rng(8);
+    std::normal_distribution<float> gaussian;
+    std::vector<float> nx, ny, nz;
+    for (int i = 0; i < 4099; ++i)
+    {
+        Vector3 n(gaussian(rng), gaussian(rng), gaussian(rng));
+        n.normalize();
+        nx.push_back(n.x);
+        ny.push_back(n.y);
+        nz.push_back(n.z);
+    }
+    const std::size_t count = nx.size();
+    std::vector<OctahedralNormal> octahedral(count);
+    std::vector<PackedNormal1010102> packed(count);
+    encodeOctahedral(nx.data(), ny.data(), nz.data(), count, octahedral.data());
+    encode1010102(nx.data(), ny.data(), nz.data(), nullptr, count, packed.data());
+    std::vector<float> ox(count), oy(count), oz(count), px(count), py(count), pz(count), pw(count);
+    decodeOctahedral(octahedral.data(), count, ox.data(), oy.data(), oz.data());
+    decode1010102(packed.data(), count, px.data(), py.data(), pz.data(), pw.data());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Vector3 n(nx[i], ny[i], nz[i]);
+        const Vector3 single = decodeOctahedral(encodeOctahedral(n));
+        KRONOS_CHECK(single.dot(n) > 0.99999f);
+        KRONOS_CHECK_NEAR(ox[i], single.x, 1e-6f);
+        Vector3 coarse(px[i], py[i], pz[i]);
+        KRONOS_CHECK_NEAR(coarse.magnitude(), 1.0f, 3e-3f);
+        coarse.normalize();
+        KRONOS_CHECK(coarse.dot(n) > 0.9999f);
+        KRONOS_CHECK(pw[i] == 1.0f);
+    }
+    KRONOS_CHECK(decode1010102(encode1010102(Vector3(0.0f, 0.0f, 1.0f), -1.0f)).w == -1.0f);
+    const Vector3 down = decodeOctahedral(encodeOctahedral(Vector3(0.0f, 0.0f, -1.0f)));
+    KRONOS_CHECK_NEAR(down.z, -1.0f, 1e-6f);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+#include "particles.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Particles;
+using Kronos::CoreSystems::Math::Vector3;
+
+int main()
+{
+    // emission stops at capacity
+    ParticleEmitter emitter(10);
+    EmissionParams params;
+    params.origin = Vector3(1.0f, 2.0f, 3.0f);
+    params.velocity = Vector3(1.0f, 0.0f, 0.0f);
+    params.lifetime = 0.25f;
+    KRONOS_CHECK(emitter.emit(6, params) == 6);
+    KRONOS_CHECK(emitter.emit(6, params) == 4);
+    KRONOS_CHECK(emitter.size() == 10);
+
+    // one semi-implicit Euler step under gravity
+    ForceField forces;
+    forces.gravity = Vector3(0.0f, -10.0f, 0.0f);
+    emitter.simulate(0.1f, forces);
+    const ParticleStreams& s = emitter.streams();
+    for (std::size_t i = 0; i < emitter.size(); ++i)
+    {
+        KRONOS_CHECK_NEAR(s.velocityY[i], -1.0f, 1e-5f);
+        KRONOS_CHECK_NEAR(s.positionX[i], 1.1f, 1e-5f);
+        KRONOS_CHECK_NEAR(s.positionY[i], 1.9f, 1e-5f);
+        KRONOS_CHECK_NEAR(s.positionZ[i], 3.0f, 1e-5f);
+    }
+
+    // an attractor pulls particles towards it
+    ParticleEmitter pulled(4);
+    EmissionParams still;
+    pulled.emit(4, still);
+    ForceField attraction;
+    attraction.gravity = Vector3::ZERO;
+    attraction.attractors.push_back({Vector3(5.0f, 0.0f, 0.0f), 10.0f});
+    pulled.simulate(0.1f, attraction);
+    KRONOS_CHECK(pulled.streams().velocityX[0] > 0.0f);
+
+    // particles past their lifetime are compacted away, the rest keep their order
+    params.lifetime = 1.0f;
+    emitter.clear();
+    emitter.emit(3, params);
+    params.lifetime = 0.05f;
+    emitter.emit(2, params);
+    KRONOS_CHECK(emitter.compact() == 0);
+    emitter.update(0.1f, forces);
+    KRONOS_CHECK(emitter.size() == 3);
+    for (std::size_t i = 0; i < emitter.size(); ++i) { KRONOS_CHECK(emitter.streams().lifetime[i] == 1.0f); }
+
+    // the system updates every emitter
+    ParticleSystem system;
+    for (int e = 0; e < 8; ++e) { system.addEmitter(100, static_cast<std::uint32_t>(e + 1)).emit(50, params); }
+    KRONOS_CHECK(system.particleCount() == 400);
+    system.update(0.1f, forces);
+    KRONOS_CHECK(system.particleCount() == 0);
+    system.removeEmitter(system.emitter(0));
+    KRONOS_CHECK(system.emitterCount() == 7);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "radix_sort.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Sorting;
+
+int main()
+{
+    std::mt19937_64 rng(9);
+    RadixSorter sorter;
+
+    for (const std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(37), std::size_t(300000)})
+    {
+        // 32-bit keys with few distinct values so stability is observable
+        std::vector<std::uint32_t> keys(n), values(n);
+        for (std::size_t i = 0; i < n; ++i) { keys[i] = static_cast<std::uint32_t>(rng() % 1000) << 20; values[i] = static_cast<std::uint32_t>(i); }
+        std::vector<std::uint32_t> expected(n);
+        std::iota(expected.begin(), expected.end(), 0u);
+        std::stable_sort(expected.begin(), expected.end(), [&](const std::uint32_t a, const std::uint32_t b) { return keys[a] < keys[b]; });
+        const std::vector<std::uint32_t> original = keys;
+        sorter.sort(keys.data(), values.data(), n);
+        KRONOS_CHECK(values == expected);
+        for (std::size_t i = 0; i < n; ++i) { KRONOS_CHECK(keys[i] == original[expected[i]]); }
+
+        // 64-bit keys through a permutation
+        std::vector<std::uint64_t> wide(n);
+        for (std::uint64_t& k : wide) { k = rng(); }
+        const std::vector<std::uint64_t> unsorted = wide;
+        std::vector<std::uint32_t> permutation(n);
+        sorter.sortPermutation(wide.data(), permutation.data(), n);
+        KRONOS_CHECK(std::is_sorted(wide.begin(), wide.end()));
+        std::vector<std::uint64_t> gathered(n);
+        applyPermutation(permutation.data(), unsorted.data(), gathered.data(), n);
+        KRONOS_CHECK(gathered == wide);
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "random.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Random;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    // several blocks and a remainder that is not a whole SIMD group
+    constexpr std::size_t COUNT = 100003;
+
+    double mean(const std::vector<double>& values)
+    {
+        double sum = 0.0;
+        for (const double v : values) { sum += v; }
+        return sum / static_cast<double>(values.size());
+    }
+}
+
+int main()
+{
+    RandomGenerator generator(42);
+
+    std::vector<float> uniform(COUNT);
+    generator.uniform(uniform.data(), COUNT, -2.0f, 3.0f);
+    KRONOS_CHECK(*std::min_element(uniform.begin(), uniform.end()) >= -2.0f && *std::max_element(uniform.begin(), uniform.end()) < 3.0f);
+    // a coarse histogram stays within a few standard deviations of flat
+    std::vector<int> histogram(10, 0);
+    for (const float v : uniform) { ++histogram[std::min(static_cast<int>((v + 2.0f) * 2.0f), 9)]; }
+    for (const int count : histogram) { KRONOS_CHECK(std::abs(count - static_cast<int>(COUNT / 10)) < 500); }
+
+    std::vector<Vector3> points(COUNT);
+    generator.inBox(points.data(), COUNT, Vector3(-1.0f, 0.0f, 10.0f), Vector3(1.0f, 5.0f, 11.0f));
+    std::vector<double> x, y, z;
+    for (const Vector3& p : points)
+    {
+        KRONOS_CHECK(p.x >= -1.0f && p.x < 1.0f && p.y >= 0.0f && p.y < 5.0f && p.z >= 10.0f && p.z < 11.0f);
+        x.push_back(p.x);
+        y.push_back(p.y);
+    }
+    KRONOS_CHECK(std::fabs(mean(x)) < 0.01 && std::fabs(mean(y) - 2.5) < 0.03);
+
+    // directions are unit length with each squared component averaging a third
+    generator.onUnitSphere(points.data(), COUNT);
+    x.clear();
+    for (const Vector3& p : points)
+    {
+        KRONOS_CHECK_NEAR(p.magnitude(), 1.0f, 1e-5f);
+        x.push_back(p.x * p.x);
+    }
+    KRONOS_CHECK(std::fabs(mean(x) - 1.0 / 3.0) < 0.01);
+
+    // uniform in the ball puts half the points inside radius 2^(-1/3)
+    generator.inUnitBall(points.data(), COUNT);
+    x.clear();
+    for (const Vector3& p : points)
+    {
+        const double r = p.magnitude();
+        KRONOS_CHECK(r <= 1.0 + 1e-6);
+        x.push_back(r * r * r);
+    }
+    KRONOS_CHECK(std::fabs(mean(x) - 0.5) < 0.01);
+
+    std::vector<Quaternion> rotations(COUNT);
+    generator.unitQuaternions(rotations.data(), COUNT);
+    x.clear();
+    for (const Quaternion& q : rotations)
+    {
+        KRONOS_CHECK_NEAR(q.magnitude(), 1.0f, 1e-5f);
+        x.push_back(q.w * q.w);
+    }
+    KRONOS_CHECK(std::fabs(mean(x) - 0.25) < 0.01);
+
+    std::vector<float> gaussian(COUNT);
+    generator.gaussian(gaussian.data(), COUNT, 1.0f, 2.0f);
+    x.assign(gaussian.begin(), gaussian.end());
+    const double centre = mean(x);
+    for (double& v : x) { v = (v - centre) * (v - centre); }
+    KRONOS_CHECK(std::fabs(centre - 1.0) < 0.03 && std::fabs(std::sqrt(mean(x)) - 2.0) < 0.03);
+
+    // the same seed and stream repeat, while later calls, other streams and splits differ
+    RandomGenerator a(7, 3), b(7, 3), other(7, 4);
+    std::vector<float> first(COUNT), second(COUNT), third(COUNT);
+    a.uniform(first.data(), COUNT);
+    b.uniform(second.data(), COUNT);
+    other.uniform(third.data(), COUNT);
+    KRONOS_CHECK(first == second);
+    KRONOS_CHECK(first != third);
+    a.uniform(first.data(), COUNT);
+    KRONOS_CHECK(first != second);
+    RandomGenerator left = b.split(), right = b.split();
+    left.uniform(first.data(), 5);
+    right.uniform(second.data(), 5);
+    KRONOS_CHECK(first[0] != second[0]);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include <cmath>
+#include <vector>
+
+#include "rigid_body.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Physics;
+using Kronos::CoreSystems::Math::Quaternion;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    RigidBodyDesc sphereBody(const Vector3& position, const float mass, const float radius)
+    {
+        RigidBodyDesc desc;
+        desc.position = position;
+        desc.inverseMass = mass > 0.0f ? 1.0f / mass : 0.0f;
+        desc.inverseInertia = sphereInverseInertia(mass, radius);
+        return desc;
+    }
+}
+
+int main()
+{
+    // free fall and spin integrate as documented, static bodies stay put
+    RigidBodySet falling;
+    falling.add(sphereBody(Vector3(0.0f, 10.0f, 0.0f), 1.0f, 0.5f));
+    falling.add(sphereBody(Vector3::ZERO, 0.0f, 0.5f));
+    falling.setVelocity(0, Vector3::ZERO, Vector3(0.0f, 3.14159265f, 0.0f));
+    for (int i = 0; i < 60; ++i)
+    {
+        falling.integrateVelocities(1.0f / 60.0f, Vector3(0.0f, -10.0f, 0.0f));
+        falling.integratePositions(1.0f / 60.0f);
+    }
+    KRONOS_CHECK_NEAR(falling.linearVelocity(0).y, -10.0f, 1e-4f);
+    KRONOS_CHECK_NEAR(falling.position(0).y, 10.0f - 5.0f - 5.0f / 60.0f, 1e-3f);
+    // half a turn about y in one second
+    KRONOS_CHECK_NEAR(std::fabs(falling.orientation(0).y), 1.0f, 1e-2f);
+    KRONOS_CHECK_NEAR(falling.orientation(0).magnitude(), 1.0f, 1e-5f);
+    KRONOS_CHECK(falling.position(1).y == 0.0f && falling.linearVelocity(1).y == 0.0f);
+
+    // a column of spheres comes to rest on a static ground body
+    constexpr float RADIUS = 0.5f;
+    RigidBodySet stack;
+    const std::uint32_t ground = stack.add(sphereBody(Vector3(0.0f, -100.0f, 0.0f), 0.0f, 1.0f));
+    std::vector<std::uint32_t> balls;
+    for (int i = 0; i < 5; ++i) { balls.push_back(stack.add(sphereBody(Vector3(0.0f, RADIUS + 1.05f * static_cast<float>(i), 0.0f), 1.0f, RADIUS))); }
+
+    ContactSolver solver;
+    std::vector<ContactPoint> contacts, previous;
+    for (int frame = 0; frame < 180; ++frame)
+    {
+        contacts.clear();
+        for (std::size_t i = 0; i < balls.size(); ++i)
+        {
+            ContactPoint c;
+            c.bodyA = i == 0 ? ground : balls[i - 1];
+            c.bodyB = balls[i];
+            const float below = i == 0 ? 0.0f : stack.position(balls[i - 1]).y + RADIUS;
+            const float bottom = stack.position(balls[i]).y - RADIUS;
+            c.normal = Vector3(0.0f, 1.0f, 0.0f);
+            c.separation = bottom - below;
+            c.point = Vector3(0.0f, 0.5f * (bottom + below), 0.0f);
+            // carry the accumulated impulses of the same pair for warm starting
+            if (i < previous.size()) { c.normalImpulse = previous[i].normalImpulse; }
+            contacts.push_back(c);
+        }
+        solver.step(stack, contacts.data(), contacts.size(), 1.0f / 60.0f, ContactSolverParams());
+        previous = contacts;
+    }
+    KRONOS_CHECK(solver.colorCount() >= 2);
+    for (std::size_t i = 0; i < balls.size(); ++i)
+    {
+        KRONOS_CHECK_NEAR(stack.position(balls[i]).y, RADIUS * static_cast<float>(2 * i + 1), 0.05f);
+        KRONOS_CHECK(stack.linearVelocity(balls[i]).magnitude() < 0.05f);
+    }
+    // the bottom contact carries the weight of the whole column, the impulse being that of one substep
+    const ContactSolverParams defaults;
+    KRONOS_CHECK_NEAR(contacts[0].normalImpulse, 5.0f * -defaults.gravity.y / (60.0f * static_cast<float>(defaults.substeps)), 0.02f);
+
+    // an elastic head-on collision of equal masses swaps their velocities
+    RigidBodySet pair;
+    pair.add(sphereBody(Vector3(-0.5f, 0.0f, 0.0f), 1.0f, RADIUS));
+    pair.add(sphereBody(Vector3(0.5f, 0.0f, 0.0f), 1.0f, RADIUS));
+    pair.setVelocity(0, Vector3(2.0f, 0.0f, 0.0f), Vector3::ZERO);
+    pair.setVelocity(1, Vector3(-2.0f, 0.0f, 0.0f), Vector3::ZERO);
+    ContactPoint hit;
+    hit.bodyA = 0;
+    hit.bodyB = 1;
+    hit.normal = Vector3(1.0f, 0.0f, 0.0f);
+    hit.restitution = 1.0f;
+    hit.friction = 0.0f;
+    ContactSolverParams elastic;
+    elastic.gravity = Vector3::ZERO;
+    ContactSolver().step(pair, &hit, 1, 1.0f / 60.0f, elastic);
+    KRONOS_CHECK_NEAR(pair.linearVelocity(0).x, -2.0f, 0.05f);
+    KRONOS_CHECK_NEAR(pair.linearVelocity(1).x, 2.0f, 0.05f);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "parallel.hpp"
+#include "sparse_solver.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::LinearAlgebra;
+using Kronos::CoreSystems::Math::Matrix3x3;
+namespace Parallel = Kronos::CoreSystems::Parallel;
+
+namespace
+{
+    // block tridiagonal chain, strictly diagonally dominant and symmetric
+    BlockSparseMatrix chain(const int n, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> jitter(-0.1f, 0.1f);
+        std::vector<BlockTriplet> triplets;
+        for (int i = 0; i < n; ++i)
+        {
+            triplets.push_back({i, i, Matrix3x3(6.0f, 0.5f, 0.0f, 0.5f, 6.0f, 0.0f, 0.0f, 0.0f, 6.0f)});
+            if (i + 1 == n) { continue; }
+            const Matrix3x3 off(-1.0f + jitter(rng), 0.0f, 0.0f, 0.0f, -1.0f + jitter(rng), 0.0f, 0.0f, 0.0f, -1.0f + jitter(rng));
+            triplets.push_back({i, i + 1, off});
+            triplets.push_back({i + 1, i, off});
+        }
+        return {n, n, triplets};
+    }
+
+    float residual(const BlockSparseMatrix& a, const Vector3Streams& x, const Vector3Streams& b)
+    {
+        Vector3Streams ax;
+        a.multiply(x, ax);
+        double rr = 0.0, bb = 0.0;
+        for (std::size_t i = 0; i < b.size(); ++i)
+        {
+            const double dx = ax.x[i] - b.x[i], dy = ax.y[i] - b.y[i], dz = ax.z[i] - b.z[i];
+            rr += dx * dx + dy * dy + dz * dz;
+            bb += static_cast<double>(b.x[i]) * b.x[i] + static_cast<double>(b.y[i]) * b.y[i] + static_cast<double>(b.z[i]) * b.z[i];
+        }
+        return static_cast<float>(std::sqrt(rr / bb));
+    }
+}
+
+int main()
+{
+    // CSR sums duplicates, sorts columns and multiplies
+    SparseMatrix csr(3, 3, {{0, 2, 1.0f}, {0, 0, 2.0f}, {1, 1, 3.0f}, {0, 2, 4.0f}, {2, 0, -1.0f}});
+    KRONOS_CHECK(csr.nonZeroCount() == 4);
+    KRONOS_CHECK(csr.columnIndices()[0] == 0 && csr.columnIndices()[1] == 2);
+    KRONOS_CHECK(*csr.find(0, 2) == 5.0f && csr.find(1, 2) == nullptr);
+    const float v[3] = {1.0f, 2.0f, 3.0f};
+    float product[3];
+    csr.multiply(v, product);
+    KRONOS_CHECK(product[0] == 17.0f && product[1] == 6.0f && product[2] == -1.0f);
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> entry(-1.0f, 1.0f);
+    constexpr int N = 20000;
+    const BlockSparseMatrix a = chain(N, rng);
+    KRONOS_CHECK(a.blockCount() == 3 * N - 2 && a.diagonalIndex(5) >= 0);
+    Vector3Streams b;
+    b.resize(N);
+    for (int i = 0; i < N; ++i)
+    {
+        b.x[i] = entry(rng);
+        b.y[i] = entry(rng);
+        b.z[i] = entry(rng);
+    }
+
+    // every preconditioner converges to the requested tolerance
+    ConjugateGradientSolver solver;
+    for (const Preconditioner kind : {Preconditioner::None, Preconditioner::Jacobi, Preconditioner::IncompleteCholesky})
+    {
+        ConjugateGradientParams params;
+        params.preconditioner = kind;
+        params.tolerance = 1e-5f;
+        Vector3Streams x;
+        const ConjugateGradientResult result = solver.solve(a, b, x, params);
+        KRONOS_CHECK(result.converged && result.iterations > 0);
+        KRONOS_CHECK(residual(a, x, b) < 2e-5f);
+    }
+
+    // results do not depend on whether the solve runs on the pool or inline inside another job
+    ConjugateGradientParams params;
+    params.tolerance = 1e-7f;
+    ConjugateGradientSolver pooled, nested;
+    Vector3Streams x1, x2;
+    pooled.solve(a, b, x1, params);
+    Parallel::parallelFor(2, 1, [&](const std::size_t begin, const std::size_t end) { if (begin == 0 && end >= 1) { nested.solve(a, b, x2, params); } });
+    KRONOS_CHECK(std::memcmp(x1.x.data(), x2.x.data(), N * sizeof(float)) == 0);
+    KRONOS_CHECK(std::memcmp(x1.z.data(), x2.z.data(), N * sizeof(float)) == 0);
+
+    // a zero right-hand side zeroes the guess
+    Vector3Streams zero;
+    zero.resize(N);
+    const ConjugateGradientResult trivial = solver.solve(a, zero, x1, params);
+    KRONOS_CHECK(trivial.converged && trivial.iterations == 0);
+    KRONOS_CHECK(x1.x[17] == 0.0f && x1.y[N - 1] == 0.0f);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "spatial_hash.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Spatial;
+using Kronos::CoreSystems::Math::Vector3;
+
+namespace
+{
+    std::vector<std::uint32_t> bruteRadius(const std::vector<Vector3>& points, const Vector3& center, const float radius)
+    {
+        std::vector<std::uint32_t> found;
+        for (std::uint32_t i = 0; i < points.size(); ++i) { if ((points[i] - center).squaredMagnitude() <= radius * radius) { found.push_back(i); } }
+        return found;
+    }
+
+    std::vector<std::uint32_t> sorted(std::vector<std::uint32_t> v)
+    {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordinate(-20.0f, 20.0f), step(-0.05f, 0.05f);
+    std::vector<Vector3> points(5000);
+    for (Vector3& p : points) { p = Vector3(coordinate(rng), coordinate(rng), coordinate(rng)); }
+
+    SpatialHashGrid grid(2.0f);
+    grid.build(points.data(), points.size());
+    KRONOS_CHECK(grid.pointCount() == points.size());
+
+    // radius queries return exactly the points inside the sphere
+    std::vector<Vector3> centers(64);
+    for (Vector3& c : centers) { c = Vector3(coordinate(rng), coordinate(rng), coordinate(rng)); }
+    std::vector<std::uint32_t> found;
+    for (const Vector3& c : centers)
+    {
+        grid.queryRadius(c, 3.0f, found);
+        KRONOS_CHECK(sorted(found) == bruteRadius(points, c, 3.0f));
+    }
+
+    // the batch matches the single queries
+    std::vector<std::uint32_t> offsets, indices;
+    grid.queryRadiusBatch(centers.data(), centers.size(), 3.0f, offsets, indices);
+    for (std::size_t q = 0; q < centers.size(); ++q)
+    {
+        const std::vector<std::uint32_t> batch(indices.begin() + offsets[q], indices.begin() + offsets[q + 1]);
+        KRONOS_CHECK(sorted(batch) == bruteRadius(points, centers[q], 3.0f));
+    }
+
+    // nearest neighbours come back closest first and match a full scan
+    constexpr std::size_t K = 8;
+    std::vector<std::uint32_t> nearest(centers.size() * K);
+    std::vector<float> distances(centers.size() * K);
+    grid.queryNearestBatch(centers.data(), centers.size(), K, 100.0f, nearest.data(), distances.data());
+    for (std::size_t q = 0; q < centers.size(); ++q)
+    {
+        std::vector<float> all;
+        for (const Vector3& p : points) { all.push_back((p - centers[q]).squaredMagnitude()); }
+        std::sort(all.begin(), all.end());
+        for (std::size_t i = 0; i < K; ++i)
+        {
+            KRONOS_CHECK_NEAR(distances[q * K + i], all[i], 1e-4f);
+            KRONOS_CHECK_NEAR((points[nearest[q * K + i]] - centers[q]).squaredMagnitude(), all[i], 1e-4f);
+        }
+    }
+
+    // small moves are patched in place and queries stay exact
+    for (Vector3& p : points) { p += Vector3(step(rng), step(rng), step(rng)); }
+    grid.setRebuildThreshold(1.0f);
+    KRONOS_CHECK(!grid.update(points.data(), points.size()));
+    KRONOS_CHECK(grid.movedCount() > 0);
+    for (const Vector3& c : centers)
+    {
+        grid.queryRadius(c, 3.0f, found);
+        KRONOS_CHECK(sorted(found) == bruteRadius(points, c, 3.0f));
+    }
+
+    // far away and non-finite positions are hashed without overflowing the cell coordinates
+    std::vector<Vector3> extreme = {{1e20f, 0.0f, 0.0f}, {1e20f, 1.0f, 0.0f}, {-1e30f, 5.0f, 1e30f}, {0.0f, 0.0f, 0.0f}, {0.5f, 0.0f, 0.0f}};
+    SpatialHashGrid far(1.0f);
+    far.build(extreme.data(), extreme.size());
+    far.queryRadius(Vector3::ZERO, 1.0f, found);
+    KRONOS_CHECK(sorted(found) == (std::vector<std::uint32_t>{3, 4}));
+    far.queryRadius(Vector3(1e20f, 0.0f, 0.0f), 2.0f, found);
+    KRONOS_CHECK(sorted(found) == (std::vector<std::uint32_t>{0, 1}));
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include <cmath>
+#include <vector>
+
+#include "spline.hpp"
+#include "test.hpp"
+
+using namespace Kronos::CoreSystems::Curves;
+using Kronos::CoreSystems::Math::Vector2;
+using Kronos::CoreSystems::Math::Vector3;
+
+int main()
+{
+    // Catmull-Rom passes through every point, whatever the parameterization
+    const std::vector<Vector3> points = {{0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 0.0f}, {3.0f, 2.5f, 1.0f}, {4.0f, 0.0f, 2.0f}, {6.0f, -1.0f, 2.0f}};
+    for (const float alpha : {0.0f, 0.5f, 1.0f})
+    {
+        const Spline3 curve = Spline3::catmullRom(points, alpha);
+        KRONOS_CHECK(curve.segmentCount() == points.size() - 1);
+        for (std::size_t k = 0; k < points.size(); ++k)
+        {
+            const Vector3 p = curve.evaluate(static_cast<float>(k));
+            KRONOS_CHECK((p - points[k]).magnitude() < 1e-4f);
+        }
+    }
+
+    // Hermite matches the given end points and tangents
+    const Spline3 hermite = Spline3::hermite({{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}}, {{0.0f, 3.0f, 0.0f}, {0.0f, -3.0f, 0.0f}});
+    KRONOS_CHECK((hermite.tangent(0.0f) - Vector3(0.0f, 3.0f, 0.0f)).magnitude() < 1e-4f);
+    KRONOS_CHECK((hermite.tangent(1.0f) - Vector3(0.0f, -3.0f, 0.0f)).magnitude() < 1e-4f);
+    KRONOS_CHECK(hermite.evaluate(0.5f).y > 0.0f);
+
+    // the batch agrees with single evaluation
+    const Spline3 curve = Spline3::catmullRom(points);
+    std::vector<float> u;
+    for (int i = 0; i <= 401; ++i) { u.push_back(static_cast<float>(i) * 0.01f); }
+    std::vector<Vector3> positions(u.size()), tangents(u.size());
+    curve.evaluate(u.data(), u.size(), positions.data(), tangents.data());
+    for (std::size_t i = 0; i < u.size(); ++i)
+    {
+        KRONOS_CHECK((positions[i] - curve.evaluate(u[i])).magnitude() < 1e-4f);
+        KRONOS_CHECK((tangents[i] - curve.tangent(u[i])).magnitude() < 1e-3f);
+    }
+
+    // a Bezier with evenly spaced collinear controls is a straight line at constant speed
+    Spline2 line = Spline2::bezier({{0.0f, 0.0f}, {1.0f, 1.0f}, {2.0f, 2.0f}, {3.0f, 3.0f}, {4.0f, 4.0f}, {5.0f, 5.0f}, {6.0f, 6.0f}});
+    line.buildArcLengthTable();
+    KRONOS_CHECK_NEAR(line.length(), 6.0f * std::sqrt(2.0f), 1e-3f);
+    KRONOS_CHECK_NEAR(line.parameterAtDistance(0.25f * line.length()), 0.5f, 1e-3f);
+    const float distances[3] = {0.0f, 0.5f * line.length(), line.length()};
+    Vector2 along[3];
+    line.evaluateAtDistances(distances, 3, along, nullptr);
+    KRONOS_CHECK_NEAR(along[1].x, 3.0f, 1e-3f);
+    KRONOS_CHECK_NEAR(along[2].y, 6.0f, 1e-3f);
+
+    // the arc length of a quarter circle approximated by one cubic, and its flattening
+    const float k = 0.5522847f;
+    Spline2 arc = Spline2::bezier({{1.0f, 0.0f}, {1.0f, k}, {k, 1.0f}, {0.0f, 1.0f}});
+    arc.buildArcLengthTable(64);
+    KRONOS_CHECK_NEAR(arc.length(), 1.5707963f, 1e-3f);
+    std::vector<Vector2> polyline;
+    arc.flatten(1e-3f, polyline);
+    KRONOS_CHECK(polyline.size() > 4);
+    for (std::size_t i = 1; i < polyline.size(); ++i)
+    {
+        // chord midpoints of a unit circle lie just inside it
+        const Vector2 mid = (polyline[i - 1] + polyline[i]) * 0.5f;
+        KRONOS_CHECK(std::sqrt(mid.x * mid.x + mid.y * mid.y) > 1.0f - 2e-3f);
+    }
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
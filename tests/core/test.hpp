@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// minimal checks for the core system tests: failures are reported and counted, and main returns the count
+namespace Kronos::Tests
+{
+    inline int failures = 0;
+
+    inline bool near(const float a, const float b, const float tolerance) { return std::fabs(a - b) <= tolerance; }
+}
+
+#define KRONOS_CHECK(condition)                                                                         \
+    do                                                                                                  \
+    {                                                                                                   \
+        if (!(condition))                                                                               \
+        {                                                                                               \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);          \
+            ++Kronos::Tests::failures;                                                                  \
+        }                                                                                               \
+    } while (false)
+
+#define KRONOS_CHECK_NEAR(a, b, tolerance) KRONOS_CHECK(Kronos::Tests::near((a), (b), (tolerance)))
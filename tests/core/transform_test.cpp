@@ -0,0 +1,68 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "test.hpp"
+#include "transform.hpp"
+
+using namespace Kronos::CoreSystems::Math;
+
+namespace
+{
+    bool sameRotation(const Quaternion& a, const Quaternion& b) { return std::fabs(a.dot(b)) > 1.0f - 1e-5f; }
+}
+
+int main()
+{
+    // compose follows T * R * S on column vectors
+    TransformTRS t;
+    t.translation = Vector3(1.0f, 2.0f, 3.0f);
+    t.rotation = Quaternion(0.0f, 0.0f, 0.70710678f, 0.70710678f);
+    t.scale = Vector3(2.0f, 3.0f, 4.0f);
+    const Matrix4x4 m = compose(t);
+    const Vector4 p = m * Vector4(1.0f, 0.0f, 0.0f, 1.0f);
+    KRONOS_CHECK_NEAR(p.x, 1.0f, 1e-5f);
+    KRONOS_CHECK_NEAR(p.y, 4.0f, 1e-5f);
+    KRONOS_CHECK_NEAR(p.z, 3.0f, 1e-5f);
+
+    // batched round trips through both modes
+    std::mt19937 rng(6);
+    std::normal_distribution<float> gaussian;
+    std::uniform_real_distribution<float> scale(0.2f, 5.0f);
+    std::vector<TransformTRS> transforms(1001);
+    for (TransformTRS& x : transforms)
+    {
+        x.translation = Vector3(gaussian(rng), gaussian(rng), gaussian(rng)) * 10.0f;
+        x.rotation = Quaternion(gaussian(rng), gaussian(rng), gaussian(rng), gaussian(rng));
+        x.rotation.normalize();
+        x.scale = Vector3(scale(rng), scale(rng), scale(rng));
+    }
+    std::vector<Matrix4x4> matrices(transforms.size());
+    std::vector<TransformTRS> fast(transforms.size()), polar(transforms.size());
+    compose(transforms.data(), transforms.size(), matrices.data());
+    decompose(matrices.data(), matrices.size(), fast.data(), DecomposeMode::Fast);
+    decompose(matrices.data(), matrices.size(), polar.data(), DecomposeMode::Polar);
+    for (std::size_t i = 0; i < transforms.size(); ++i)
+    {
+        const Matrix4x4 single = compose(transforms[i]);
+        KRONOS_CHECK_NEAR(single.m01, matrices[i].m01, 1e-5f);
+        KRONOS_CHECK_NEAR(single.m23, matrices[i].m23, 1e-5f);
+        for (const TransformTRS* d : {&fast[i], &polar[i]})
+        {
+            KRONOS_CHECK((d->translation - transforms[i].translation).magnitude() < 1e-4f);
+            KRONOS_CHECK((d->scale - transforms[i].scale).magnitude() < 1e-3f);
+            KRONOS_CHECK(sameRotation(d->rotation, transforms[i].rotation));
+        }
+    }
+
+    // a mirrored matrix keeps a proper rotation and moves the reflection into the scale
+    TransformTRS mirrored;
+    mirrored.scale = Vector3(-1.0f, 1.0f, 1.0f);
+    const TransformTRS back = decompose(compose(mirrored), DecomposeMode::Polar);
+    const Matrix4x4 rebuilt = compose(back);
+    KRONOS_CHECK_NEAR(rebuilt.m00, -1.0f, 1e-5f);
+    KRONOS_CHECK_NEAR(rebuilt.m11, 1.0f, 1e-5f);
+    KRONOS_CHECK_NEAR(back.rotation.magnitude(), 1.0f, 1e-5f);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "test.hpp"
+#include "xpbd.hpp"
+
+using namespace Kronos::CoreSystems::Physics;
+using Kronos::CoreSystems::Math::Vector3;
+
+int main()
+{
+    // a rope pinned at one end hangs straight down at its rest length
+    std::vector<Vector3> ropePoints;
+    for (int i = 0; i < 20; ++i) { ropePoints.push_back(Vector3(0.1f * static_cast<float>(i), 2.0f, 0.0f)); }
+    std::vector<float> ropeMasses(ropePoints.size(), 1.0f);
+    ropeMasses[0] = 0.0f;
+    const ClothConstraints rope = makeRope(ropePoints, 0.0f, 1e-3f);
+    KRONOS_CHECK(rope.distances.size() == 19 && rope.bends.size() == 18);
+
+    XpbdSolver hanging(ropePoints, ropeMasses, rope);
+    XpbdParams params;
+    params.substeps = 16;
+    params.damping = 1.0f;
+    for (int frame = 0; frame < 600; ++frame) { hanging.step(1.0f / 60.0f, params); }
+    KRONOS_CHECK((hanging.position(0) - ropePoints[0]).magnitude() == 0.0f);
+    for (const DistanceConstraint& c : rope.distances)
+    {
+        KRONOS_CHECK_NEAR((hanging.position(c.a) - hanging.position(c.b)).magnitude(), c.restLength, 2e-3f);
+    }
+    KRONOS_CHECK_NEAR(hanging.position(19).x, 0.0f, 0.05f);
+    KRONOS_CHECK(hanging.position(19).y < 0.2f);
+
+    // a cloth dropped on a sphere above a floor rests on both without passing through
+    constexpr int COLUMNS = 16, ROWS = 16;
+    std::vector<Vector3> clothPoints;
+    for (int r = 0; r < ROWS; ++r)
+        for (int c = 0; c < COLUMNS; ++c)
+            clothPoints.push_back(Vector3(-0.75f + 0.1f * static_cast<float>(c), 1.5f, -0.75f + 0.1f * static_cast<float>(r)));
+    const ClothConstraints grid = makeClothGrid(clothPoints, COLUMNS, ROWS, 0.0f, 1e-4f, 1e-2f);
+    KRONOS_CHECK(grid.distances.size() > static_cast<std::size_t>(2 * COLUMNS * (ROWS - 1)));
+
+    ColliderSet colliders;
+    colliders.spheres.push_back({Vector3(0.0f, 0.5f, 0.0f), 0.4f});
+    colliders.planes.push_back({Vector3(0.0f, 1.0f, 0.0f), 0.0f});
+    const std::vector<float> clothMasses(clothPoints.size(), 1.0f);
+    XpbdSolver cloth(clothPoints, clothMasses, grid), twin(clothPoints, clothMasses, grid);
+    KRONOS_CHECK(cloth.distanceColorCount() > 0 && cloth.distanceColorCount() <= static_cast<std::size_t>(XpbdSolver::MAX_COLORS));
+    for (int frame = 0; frame < 240; ++frame) { cloth.step(1.0f / 60.0f, params, &colliders); }
+    for (std::size_t i = 0; i < cloth.particleCount(); ++i)
+    {
+        const Vector3 p = cloth.position(i);
+        KRONOS_CHECK((p - colliders.spheres[0].center).magnitude() > 0.4f);
+        KRONOS_CHECK(p.y > -1e-4f);
+    }
+
+    // the batch steps each solver exactly as stepping it alone
+    const SimulationJob job {&twin, 1.0f / 60.0f, &colliders};
+    for (int frame = 0; frame < 240; ++frame) { simulateBatch(&job, 1, params); }
+    KRONOS_CHECK(std::memcmp(twin.state().positionY.data(), cloth.state().positionY.data(), clothPoints.size() * sizeof(float)) == 0);
+
+    return Kronos::Tests::failures == 0 ? 0 : 1;
+}